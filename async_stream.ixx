@@ -0,0 +1,519 @@
+module;
+
+#include <errno.h>
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+#else
+  #include <sys/socket.h>
+#endif
+
+#ifndef _MSC_VER
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#endif
+
+// This module provides AsyncStream, a completion-handler interface for stream
+// sockets driven by an EventLoop. Operation state lives inside the stream and
+// handlers are stored in place, so an operation does not allocate.
+
+export module net_io.async_stream;
+
+#ifdef _MSC_VER
+import <chrono>;
+import <concepts>;
+import <cstddef>;
+import <initializer_list>;
+import <memory>;
+import <new>;
+import <span>;
+import <stdexcept>;
+import <system_error>;
+import <type_traits>;
+import <utility>;
+#endif
+
+// Module imports (sorted)
+import net_io_base;
+import net_io.event_loop;
+import net_io.timer_wheel;
+export import net_io_base; // Export sock_t and invalid_socket
+
+export namespace net_io
+{
+  namespace detail
+  {
+    template<typename Signature, std::size_t Capacity = 64>
+    class InplaceHandler;
+
+    /**
+     * @brief Move-only callable holder with in-place storage.
+     *
+     * Callables up to Capacity bytes (with nothrow move) are stored inside the object;
+     * larger ones fall back to the heap. The function table is a static per type.
+     */
+    template<std::size_t Capacity, typename... Args>
+    class InplaceHandler<void(Args...), Capacity>
+    {
+    public:
+      InplaceHandler() noexcept = default;
+
+      template<typename F>
+        requires (!std::same_as<std::decay_t<F>, InplaceHandler>) && std::invocable<std::decay_t<F>&, Args...>
+      explicit InplaceHandler(F&& f)
+      {
+        using D = std::decay_t<F>;
+        if constexpr (stored_inline<D>)
+          ::new (static_cast<void*>(buf_)) D(std::forward<F>(f));
+        else
+          ::new (static_cast<void*>(buf_)) D*(new D(std::forward<F>(f)));
+        vt_ = &Ops<D>::table;
+      }
+
+      InplaceHandler(InplaceHandler&& other) noexcept
+      {
+        if (other.vt_)
+        {
+          other.vt_->move(other.buf_, buf_);
+          vt_ = std::exchange(other.vt_, nullptr);
+        }
+      }
+
+      InplaceHandler& operator=(InplaceHandler&& other) noexcept
+      {
+        if (this != &other)
+        {
+          reset();
+          if (other.vt_)
+          {
+            other.vt_->move(other.buf_, buf_);
+            vt_ = std::exchange(other.vt_, nullptr);
+          }
+        }
+        return *this;
+      }
+
+      InplaceHandler(const InplaceHandler&) = delete;
+      InplaceHandler& operator=(const InplaceHandler&) = delete;
+
+      ~InplaceHandler() { reset(); }
+
+      explicit operator bool() const noexcept { return vt_ != nullptr; }
+
+      void operator()(Args... args)
+      {
+        vt_->invoke(buf_, std::forward<Args>(args)...);
+      }
+
+      void reset() noexcept
+      {
+        if (vt_)
+        {
+          vt_->destroy(buf_);
+          vt_ = nullptr;
+        }
+      }
+
+    private:
+      struct VTable
+      {
+        void (*invoke)(void*, Args...);
+        void (*move)(void* from, void* to) noexcept;
+        void (*destroy)(void*) noexcept;
+      };
+
+      template<typename D>
+      static constexpr bool stored_inline = sizeof(D) <= Capacity
+        && alignof(D) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible_v<D>;
+
+      template<typename D>
+      struct Ops
+      {
+        static D& get(void* p) noexcept
+        {
+          if constexpr (stored_inline<D>)
+            return *std::launder(static_cast<D*>(p));
+          else
+            return **std::launder(static_cast<D**>(p));
+        }
+        static void invoke(void* p, Args... args) { get(p)(std::forward<Args>(args)...); }
+        static void move(void* from, void* to) noexcept
+        {
+          if constexpr (stored_inline<D>)
+          {
+            ::new (to) D(std::move(get(from)));
+            get(from).~D();
+          }
+          else
+          {
+            ::new (to) D*(*std::launder(static_cast<D**>(from)));
+          }
+        }
+        static void destroy(void* p) noexcept
+        {
+          if constexpr (stored_inline<D>)
+            get(p).~D();
+          else
+            delete *std::launder(static_cast<D**>(p));
+        }
+        static constexpr VTable table{ &invoke, &move, &destroy };
+      };
+
+      alignas(std::max_align_t) unsigned char buf_[Capacity];
+      const VTable* vt_ = nullptr;
+    };
+  }
+
+  /**
+   * @brief Completion-handler interface for a stream socket on an EventLoop.
+   *
+   * read_async() and write_async() take a handler called as (std::error_code, bytes)
+   * on the loop thread; flush_async() calls (std::error_code) once all earlier writes
+   * completed. Each direction allows one outstanding operation; its state (buffer,
+   * progress, handler) is kept inside the AsyncStream, and handlers up to 64 bytes are
+   * stored without allocation. Compared to std::future there is no shared state, mutex
+   * or condition variable per operation.
+   *
+   * An operation first tries the socket directly. If it completes, the handler runs on
+   * the next loop iteration (never inside the initiating call); otherwise the socket is
+   * watched and the operation continues when it becomes ready.
+   *
+   * All member functions must be called on the loop thread, and handlers must not throw.
+   * Destroying the stream (also from inside a handler) drops pending handlers without
+   * calling them. Satisfies modern_io::CompletionInputStream and
+   * modern_io::CompletionOutputStream.
+   *
+   * Example usage:
+   * @code
+   * net_io::AsyncStream<net_io::TcpClient> s(loop, std::move(client));
+   * s.read_async(buf, sizeof(buf), [&](std::error_code ec, std::size_t n) {
+   *     if (!ec && n > 0)
+   *         s.write_async(buf, n, [](std::error_code, std::size_t) {});
+   * });
+   * loop.run();
+   * @endcode
+   */
+  template<typename Stream>
+    requires requires(Stream& s) { { s.native_handle() } -> std::convertible_to<sock_t>; }
+  class AsyncStream
+  {
+  public:
+    using Handler = detail::InplaceHandler<void(std::error_code, std::size_t)>;
+    using FlushHandler = detail::InplaceHandler<void(std::error_code)>;
+
+    /**
+     * @brief Take ownership of a connected stream.
+     * @param loop The loop driving the operations.
+     * @param stream The connected socket stream (e.g. TcpClient or UnixClient).
+     */
+    AsyncStream(EventLoop& loop, Stream stream)
+      : loop_(loop), stream_(std::move(stream))
+    {
+#if defined(_WIN32)
+      // No MSG_DONTWAIT: the socket itself has to be nonblocking.
+      set_socket_option(stream_.native_handle(), SocketOption::NonBlocking, 1);
+#endif
+    }
+
+    AsyncStream(const AsyncStream&) = delete;
+    AsyncStream& operator=(const AsyncStream&) = delete;
+
+    ~AsyncStream()
+    {
+      sock_t fd = stream_.native_handle();
+      for (Op* op : { &read_, &write_ })
+      {
+        if (!op->busy)
+          continue;
+        if (op->done)
+          loop_.cancel_deferred(op);
+        else
+          loop_.unwatch(fd, op->is_read ? IoEvent::Read : IoEvent::Write);
+      }
+      if (flush_.handler)
+        loop_.cancel_deferred(&flush_);
+    }
+
+    /**
+     * @brief Read up to size bytes; calls handler(error, bytes) when done.
+     * @throws std::logic_error if a read is already in progress.
+     */
+    template<typename H>
+      requires std::invocable<std::decay_t<H>&, std::error_code, std::size_t>
+    void read_async(char* data, std::size_t size, H&& handler)
+    {
+      if (read_.busy)
+        throw std::logic_error("AsyncStream: read already in progress");
+      read_.handler = Handler(std::forward<H>(handler));
+      read_.data = data;
+      read_.size = size;
+      start(read_, IoEvent::Read);
+    }
+    template<typename H>
+    void read_async(std::span<char> buf, H&& handler)
+    {
+      read_async(buf.data(), buf.size(), std::forward<H>(handler));
+    }
+    template<typename H>
+    void read_async(std::span<std::byte> buf, H&& handler)
+    {
+      read_async(reinterpret_cast<char*>(buf.data()), buf.size(), std::forward<H>(handler));
+    }
+
+    /**
+     * @brief Write all size bytes; calls handler(error, bytes written) when done.
+     * @throws std::logic_error if a write is already in progress.
+     */
+    template<typename H>
+      requires std::invocable<std::decay_t<H>&, std::error_code, std::size_t>
+    void write_async(const char* data, std::size_t size, H&& handler)
+    {
+      if (write_.busy)
+        throw std::logic_error("AsyncStream: write already in progress");
+      write_.handler = Handler(std::forward<H>(handler));
+      write_.data = const_cast<char*>(data);
+      write_.size = size;
+      start(write_, IoEvent::Write);
+    }
+    template<typename H>
+    void write_async(std::span<const char> buf, H&& handler)
+    {
+      write_async(buf.data(), buf.size(), std::forward<H>(handler));
+    }
+    template<typename H>
+    void write_async(std::span<const std::byte> buf, H&& handler)
+    {
+      write_async(reinterpret_cast<const char*>(buf.data()), buf.size(), std::forward<H>(handler));
+    }
+
+    /**
+     * @brief Calls handler(error) once the outstanding write (if any) has completed.
+     * @throws std::logic_error if a flush is already in progress.
+     *
+     * Writes go straight to the socket, so there is nothing else to flush; the error is
+     * that of the outstanding write.
+     */
+    template<typename H>
+      requires std::invocable<std::decay_t<H>&, std::error_code>
+    void flush_async(H&& handler)
+    {
+      if (flush_.handler)
+        throw std::logic_error("AsyncStream: flush already in progress");
+      flush_.handler = FlushHandler(std::forward<H>(handler));
+      if (!write_.busy)
+        loop_.defer(&flush_);
+    }
+
+    /**
+     * @brief Fail outstanding operations when no operation completed for timeout.
+     * @param timeout Idle time after which pending reads and writes complete with
+     *                std::errc::timed_out; zero disables the idle timeout.
+     *
+     * The timer lives on the loop's timer wheel; it runs while an operation is pending
+     * and is re-armed in O(1) whenever an operation completes, so idle connections can be reaped cheaply by keeping a read
+     * outstanding and closing the stream when it times out.
+     */
+    template<typename Rep, typename Period>
+    void set_idle_timeout(std::chrono::duration<Rep, Period> timeout)
+    {
+      idle_timeout_ = std::chrono::duration_cast<TimerWheel::clock::duration>(timeout);
+      if (idle_timeout_.count() <= 0)
+      {
+        idle_timer_.cancel();
+        return;
+      }
+      idle_timer_.set_callback([this] { on_idle(); });
+      if (read_.busy || write_.busy)
+        loop_.timers().schedule(idle_timer_, idle_timeout_);
+    }
+
+    /// Returns true after a read reported the end of the stream.
+    bool eof() const noexcept { return eof_; }
+
+    /// Returns the loop driving this stream.
+    EventLoop& loop() noexcept { return loop_; }
+
+    /// Returns the underlying stream.
+    Stream& next_layer() noexcept { return stream_; }
+
+  private:
+    struct Op final : IoWaiter
+    {
+      Op(AsyncStream* s, bool r) : self(s), is_read(r) {}
+
+      void io_ready() noexcept override { self->on_ready(*this); }
+
+      AsyncStream* self;
+      bool is_read;
+      bool busy = false;
+      bool done = false;
+      char* data = nullptr;
+      std::size_t size = 0;
+      std::size_t transferred = 0;
+      std::error_code ec;
+      Handler handler;
+    };
+
+    struct FlushOp final : IoWaiter
+    {
+      explicit FlushOp(AsyncStream* s) : self(s) {}
+
+      void io_ready() noexcept override { self->complete_flush(std::error_code{}); }
+
+      AsyncStream* self;
+      FlushHandler handler;
+    };
+
+    void start(Op& op, IoEvent ev)
+    {
+      if (idle_timeout_.count() > 0 && !idle_timer_.armed())
+        loop_.timers().schedule(idle_timer_, idle_timeout_);
+      op.busy = true;
+      op.transferred = 0;
+      op.ec.clear();
+      op.done = attempt(op);
+      if (!op.done)
+      {
+        try
+        {
+          loop_.watch(stream_.native_handle(), ev, &op);
+          return;
+        }
+        catch (const SocketException& ex)
+        {
+          op.ec = std::error_code(ex.error_code(), std::system_category());
+          op.done = true;
+        }
+      }
+      loop_.defer(&op);
+    }
+
+    // Performs as much of the operation as possible; returns true when it is finished.
+    bool attempt(Op& op)
+    {
+      sock_t fd = stream_.native_handle();
+      while (true)
+      {
+#if defined(_WIN32)
+        int ret = op.is_read
+          ? ::recv(fd, op.data, static_cast<int>(op.size), 0)
+          : ::send(fd, op.data + op.transferred, static_cast<int>(op.size - op.transferred), 0);
+        int err = ret < 0 ? WSAGetLastError() : 0;
+        const bool would_block = err == WSAEWOULDBLOCK;
+        const bool interrupted = false;
+#else
+#  if defined(MSG_NOSIGNAL)
+        const int send_flags = async_io_flags | MSG_NOSIGNAL;
+#  else
+        const int send_flags = async_io_flags;
+#  endif
+        ssize_t ret = op.is_read
+          ? ::recv(fd, op.data, op.size, async_io_flags)
+          : ::send(fd, op.data + op.transferred, op.size - op.transferred, send_flags);
+        int err = ret < 0 ? errno : 0;
+        const bool would_block = err == EAGAIN || err == EWOULDBLOCK;
+        const bool interrupted = err == EINTR;
+#endif
+        if (ret < 0)
+        {
+          if (interrupted)
+            continue;
+          if (would_block)
+            return false;
+          op.ec = std::error_code(err, std::system_category());
+          return true;
+        }
+        op.transferred += static_cast<std::size_t>(ret);
+        if (op.is_read)
+        {
+          if (ret == 0 && op.size > 0)
+            eof_ = true;
+          return true;
+        }
+        if (op.transferred == op.size)
+          return true;
+      }
+    }
+
+    void on_ready(Op& op) noexcept
+    {
+      if (!op.done && !attempt(op))
+      {
+        try
+        {
+          loop_.watch(stream_.native_handle(), op.is_read ? IoEvent::Read : IoEvent::Write, &op);
+          return;
+        }
+        catch (const SocketException& ex)
+        {
+          op.ec = std::error_code(ex.error_code(), std::system_category());
+        }
+      }
+
+      // Reset before invoking: the handler may start the next operation or destroy *this.
+      Handler handler = std::move(op.handler);
+      std::error_code ec = op.ec;
+      std::size_t n = op.transferred;
+      op.busy = false;
+      op.done = false;
+
+      // Restart the idle period while the other direction is pending; otherwise the
+      // next start() arms it, so an idle stream does not keep the loop running.
+      if (read_.busy || write_.busy)
+      {
+        if (idle_timeout_.count() > 0)
+          loop_.timers().schedule(idle_timer_, idle_timeout_);
+      }
+      else
+        idle_timer_.cancel();
+      if (!op.is_read && flush_.handler)
+      {
+        FlushHandler flush = std::move(flush_.handler);
+        handler(ec, n);
+        flush(ec);
+        return;
+      }
+      handler(ec, n);
+    }
+
+    void on_idle() noexcept
+    {
+      for (Op* op : { &read_, &write_ })
+      {
+        if (!op->busy || op->done)
+          continue;
+        loop_.unwatch(stream_.native_handle(), op->is_read ? IoEvent::Read : IoEvent::Write);
+        op->ec = std::make_error_code(std::errc::timed_out);
+        op->done = true;
+        loop_.defer(op);
+      }
+    }
+
+    void complete_flush(std::error_code ec) noexcept
+    {
+      FlushHandler flush = std::move(flush_.handler);
+      if (flush)
+        flush(ec);
+    }
+
+    EventLoop& loop_;
+    Stream stream_;
+    Op read_{ this, true };
+    Op write_{ this, false };
+    FlushOp flush_{ this };
+    bool eof_ = false;
+    TimerWheel::clock::duration idle_timeout_{ 0 };
+    TimerWheel::Timer idle_timer_;
+  };
+}
@@ -0,0 +1,187 @@
+import net_io;
+import net_io_adapters;
+
+// This can be removed when msvc better supports umbrella imports
+import net_io.tcp_endpoint;
+import net_io.tcp_client;
+import net_io.tcp_server;
+import net_io.event_loop;
+import net_io.async_stream;
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <system_error>
+#include <thread>
+
+using namespace net_io;
+using namespace net_io_adapters;
+
+// Per-operation cost of the completion-handler interface (AsyncStream) against the
+// std::future shim (FutureStream), with heap allocations counted.
+// Usage: bench_completion_stream [operations]
+
+constexpr std::uint16_t port = 9504;
+
+static std::atomic<std::size_t> allocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+// noinline: GCC 12 otherwise warns about free() on memory from operator new.
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Echoes whatever arrives until the connection closes.
+struct Echo
+{
+    AsyncStream<TcpClient> stream;
+    char buf[256];
+
+    Echo(EventLoop& loop, TcpClient client) : stream(loop, std::move(client)) {}
+
+    void next()
+    {
+        stream.read_async(buf, sizeof(buf), [this](std::error_code ec, std::size_t n) {
+            if (ec || n == 0)
+                return;
+            stream.write_async(buf, n, [this](std::error_code ec, std::size_t) {
+                if (!ec)
+                    next();
+            });
+        });
+    }
+};
+
+// Sends 64 bytes and waits for them to come back, round_trips times.
+struct Pinger
+{
+    AsyncStream<TcpClient> stream;
+    char out[64];
+    char in[64];
+    std::size_t received = 0;
+    int left = 0;
+
+    Pinger(EventLoop& loop, TcpClient client) : stream(loop, std::move(client)) { std::memset(out, 'p', sizeof(out)); }
+
+    void next()
+    {
+        if (left-- == 0)
+        {
+            stream.loop().stop();
+            return;
+        }
+        stream.write_async(out, sizeof(out), [this](std::error_code ec, std::size_t) {
+            if (ec)
+                std::abort();
+            received = 0;
+            receive();
+        });
+    }
+
+    void receive()
+    {
+        stream.read_async(in + received, sizeof(in) - received, [this](std::error_code ec, std::size_t n) {
+            if (ec || n == 0)
+                std::abort();
+            received += n;
+            if (received < sizeof(in))
+                receive();
+            else
+                next();
+        });
+    }
+};
+
+static task<void> keep_alive()
+{
+    co_await sleep_for(std::chrono::hours(1));
+}
+
+int main(int argc, char** argv)
+{
+    const int operations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+    const TcpEndpoint ep{ "127.0.0.1", port };
+    TcpServer server(ep);
+    server.start();
+
+    {
+        EventLoop loop;
+        TcpClient client(ep);
+        client.open();
+        Echo echo(loop, server.accept());
+        echo.next();
+        Pinger pinger(loop, std::move(client));
+        pinger.left = 1000; // warm-up
+        pinger.next();
+        loop.run();
+
+        pinger.left = operations;
+        const std::size_t before = allocations;
+        const auto start = std::chrono::steady_clock::now();
+        pinger.next();
+        loop.run();
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "completion echo round trip:   " << us / operations << " us, "
+                  << static_cast<double>(allocations - before) / operations << " allocations" << std::endl;
+    }
+
+    {
+        EventLoop loop;
+        TcpClient client(ep);
+        client.open();
+        TcpClient peer = server.accept();
+        std::thread drain([&] {
+            char buf[65536];
+            while (peer.read(buf, sizeof(buf)) > 0) {}
+        });
+        AsyncStream<TcpClient> stream(loop, std::move(client));
+        const char byte = 'x';
+
+        int done = 0;
+        auto write_one = [&](auto& self) -> void {
+            stream.write_async(&byte, 1, [&](std::error_code ec, std::size_t) {
+                if (ec)
+                    std::abort();
+                if (++done < operations)
+                    self(self);
+            });
+        };
+        std::size_t before = allocations;
+        auto start = std::chrono::steady_clock::now();
+        write_one(write_one);
+        loop.run();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "completion 1-byte write:      " << ns / operations << " ns, "
+                  << static_cast<double>(allocations - before) / operations << " allocations" << std::endl;
+
+        // FutureStream posts every operation to the loop thread and waits on a future.
+        FutureStream futures(stream);
+        std::thread runner([&] {
+            loop.spawn(keep_alive());
+            loop.run();
+        });
+        futures.flush_async().get(); // the loop thread is up
+        before = allocations;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < operations; ++i)
+            futures.write_async(&byte, 1).get();
+        ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "FutureStream 1-byte write:    " << ns / operations << " ns, "
+                  << static_cast<double>(allocations - before) / operations << " allocations" << std::endl;
+
+        loop.stop();
+        runner.join();
+        stream.next_layer().close();
+        drain.join();
+    }
+    return 0;
+}
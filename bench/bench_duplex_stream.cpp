@@ -0,0 +1,133 @@
+import modern_io;
+import net_io;
+import net_io_adapters;
+
+// This can be removed when msvc better supports umbrella imports
+import net_io.tcp_endpoint;
+import net_io.tcp_client;
+import net_io.tcp_server;
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace modern_io;
+using namespace net_io;
+using namespace net_io_adapters;
+
+// make_stream() (SharedStream) against make_duplex_stream() (DuplexStream) with the
+// Data streams on top: per message through a null transport, stream setup, and
+// one-way int32 messages over loopback TCP.
+// Usage: bench_duplex_stream [messages]
+
+constexpr std::uint16_t port = 9505;
+
+// Accepts every write and reads an endless stream of zero bytes.
+struct NullTransport
+{
+    std::size_t read(char* data, std::size_t size)
+    {
+        std::memset(data, 0, size);
+        return size;
+    }
+    void write(const char*, std::size_t) {}
+    void open() {}
+    void close() {}
+};
+
+template<typename F>
+static double ns_per(int count, F&& body)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+        body(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+// Sums int32 messages until -1 and answers with the sum, once per connection.
+static void sum_server(TcpServer& server, int connections)
+{
+    for (int c = 0; c < connections; ++c)
+    {
+        auto stream = DuplexStream<TcpClient>(server.accept());
+        DataInputStream in(stream.reader());
+        DataOutputStream out(stream.writer());
+        std::int32_t sum = 0;
+        for (std::int32_t v; (v = in.read_int32()) >= 0;)
+            sum = static_cast<std::int32_t>((sum + v) & 0x7fffffff);
+        out.write_int32(sum);
+        out.flush();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int messages = argc > 1 ? std::max(1, std::atoi(argv[1])) : 2000000;
+    long sink = 0;
+
+    {
+        auto shared = make_stream(std::make_shared<NullTransport>());
+        DataOutputStream out(shared);
+        DataInputStream in(shared);
+        double ns = ns_per(messages, [&](int i) { out.write_int32(i); sink += in.read_int32(); });
+        std::cout << "null transport, int32 write+read:  shared " << ns << " ns";
+    }
+    {
+        DuplexStream<NullTransport> duplex(NullTransport{});
+        DataOutputStream out(duplex.writer());
+        DataInputStream in(duplex.reader());
+        double ns = ns_per(messages, [&](int i) { out.write_int32(i); sink += in.read_int32(); });
+        std::cout << ", duplex " << ns << " ns" << std::endl;
+    }
+
+    const int setups = messages / 10 + 1;
+    double shared_setup = ns_per(setups, [&](int i) {
+        auto shared = make_stream(NullTransport{});
+        DataOutputStream out(shared);
+        DataInputStream in(shared);
+        out.write_int32(i);
+        out.flush();
+        sink += in.read_int32();
+    });
+    double duplex_setup = ns_per(setups, [&](int i) {
+        DuplexStream<NullTransport> duplex(NullTransport{});
+        DataOutputStream out(duplex.writer());
+        DataInputStream in(duplex.reader());
+        out.write_int32(i);
+        out.flush();
+        sink += in.read_int32();
+    });
+    std::cout << "stream setup + one message:        shared " << shared_setup << " ns, duplex " << duplex_setup << " ns" << std::endl;
+
+    const TcpEndpoint ep{ "127.0.0.1", port };
+    TcpServer server(ep);
+    server.start();
+    std::thread receiver([&] { sum_server(server, 2); });
+    {
+        auto shared = make_stream(ep);
+        DataOutputStream out(shared);
+        DataInputStream in(shared);
+        double ns = ns_per(messages, [&](int i) { out.write_int32(i & 1023); });
+        out.write_int32(-1);
+        out.flush();
+        sink += in.read_int32();
+        std::cout << "TCP one-way int32:                 shared " << ns << " ns";
+    }
+    {
+        auto duplex = make_duplex_stream(ep);
+        DataOutputStream out(duplex.writer());
+        DataInputStream in(duplex.reader());
+        double ns = ns_per(messages, [&](int i) { out.write_int32(i & 1023); });
+        out.write_int32(-1);
+        out.flush();
+        sink += in.read_int32();
+        std::cout << ", duplex " << ns << " ns" << std::endl;
+    }
+    receiver.join();
+    std::cout << "checksum " << sink << std::endl; // keeps the reads observable
+    return 0;
+}
@@ -0,0 +1,73 @@
+import net_io;
+import net_io_adapters;
+
+// This can be removed when msvc better supports umbrella imports
+import net_io.tcp_endpoint;
+import net_io.tcp_client;
+import net_io.tcp_server;
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace net_io;
+using namespace net_io_adapters;
+
+// Short-lived connections per second through run_tcp_server(): each client connects,
+// sends one byte, reads the echo and closes.
+// Usage: bench_server_dispatch [connections] [max_concurrent_handlers] [client_threads]
+
+constexpr std::uint16_t port = 9503;
+
+// Read by the detached accept loop until the process exits.
+static std::atomic<bool> running{ true };
+
+int main(int argc, char** argv)
+{
+    const int connections = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const std::size_t handlers = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+    const int client_threads = argc > 3 ? std::max(1, std::atoi(argv[3])) : 1;
+
+    ThreadExecutor executor;
+    auto metrics = std::make_shared<ServerMetrics>();
+    ServerOptions options{ .max_concurrent_handlers = handlers, .max_pending = 1024, .metrics = metrics };
+    run_tcp_server(executor, options, [](auto stream) {
+        char c;
+        if (stream.read(&c, 1) == 1)
+        {
+            stream.write(&c, 1);
+            stream.flush();
+        }
+    }, running, TcpEndpoint{ "127.0.0.1", port });
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (int t = 0; t < client_threads; ++t)
+    {
+        clients.emplace_back([&, t] {
+            for (int i = t; i < connections; i += client_threads)
+            {
+                TcpClient client(TcpEndpoint{ "127.0.0.1", port });
+                client.open();
+                client.write("x", 1);
+                char reply;
+                client.read(&reply, 1);
+            }
+        });
+    }
+    for (auto& c : clients)
+        c.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    running = false;
+
+    std::cout << connections << " connections, handler limit " << handlers << ", " << client_threads
+              << " client thread(s): " << connections / seconds << " connections/s" << std::endl;
+    std::cout << "accepted " << metrics->accepted << ", handled " << metrics->handled
+              << ", peak active " << metrics->peak_active << ", handler errors " << metrics->handler_errors << std::endl;
+    return 0;
+}
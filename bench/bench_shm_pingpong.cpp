@@ -0,0 +1,103 @@
+import net_io;
+
+// This can be removed when msvc better supports umbrella imports
+import net_io.unix_endpoint;
+import net_io.unix_client;
+import net_io.unix_server;
+import net_io.shm_transport;
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace net_io;
+
+// 64-byte ping-pong between two processes over ShmTransport and over an AF_UNIX
+// stream socket. Prints the mean round trip.
+// Usage: bench_shm_pingpong [round_trips] [busy_poll_spins]
+
+constexpr std::size_t message_size = 64;
+
+template<typename T>
+static void read_exactly(T& t, char* data, std::size_t size)
+{
+    std::size_t have = 0;
+    while (have < size)
+    {
+        std::size_t n = t.read(data + have, size - have);
+        if (n == 0)
+            std::_Exit(2); // peer went away mid-run
+        have += n;
+    }
+}
+
+template<typename T>
+static double ping(T& t, int round_trips)
+{
+    char buf[message_size] = {};
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < round_trips; ++i)
+    {
+        t.write(buf, sizeof(buf));
+        read_exactly(t, buf, sizeof(buf));
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / round_trips;
+}
+
+template<typename T>
+static void pong(T& t, int round_trips)
+{
+    char buf[message_size];
+    for (int i = 0; i < round_trips; ++i)
+    {
+        read_exactly(t, buf, sizeof(buf));
+        t.write(buf, sizeof(buf));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int round_trips = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const unsigned spins = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+    const std::string suffix = std::to_string(::getpid());
+
+    {
+        const std::string name = "/net_io-bench-" + suffix;
+        ShmTransport creator(name, ShmRole::Create, 1 << 16);
+        creator.open();
+        creator.set_busy_poll(spins);
+        pid_t child = ::fork();
+        if (child == 0)
+        {
+            ShmTransport peer(name, ShmRole::Attach);
+            peer.open();
+            peer.set_busy_poll(spins);
+            pong(peer, round_trips);
+            std::_Exit(0);
+        }
+        std::cout << "shm     rtt " << ping(creator, round_trips) << " us (busy poll " << spins << ")" << std::endl;
+        ::waitpid(child, nullptr, 0);
+    }
+
+    {
+        const std::string path = "/tmp/net_io-bench-" + suffix + ".sock";
+        UnixServer server(UnixEndpoint{ path });
+        server.start();
+        pid_t child = ::fork();
+        if (child == 0)
+        {
+            UnixClient client(UnixEndpoint{ path });
+            client.open();
+            pong(client, round_trips);
+            std::_Exit(0);
+        }
+        UnixClient conn = server.accept();
+        std::cout << "AF_UNIX rtt " << ping(conn, round_trips) << " us" << std::endl;
+        ::waitpid(child, nullptr, 0);
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+import net_io_adapters;
+
+// This can be removed when msvc better supports umbrella imports
+import net_io_adapters.executors;
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+
+using namespace net_io_adapters;
+
+// std::function<void()> against UniqueTask for a capture of a shared_ptr and three
+// ints: construct, move and invoke on one thread, then ThreadPoolExecutor dispatch
+// to one worker. Heap allocations are counted.
+// Usage: bench_unique_task [tasks]
+
+static std::atomic<std::size_t> allocations{ 0 };
+static std::atomic<long> sink{ 0 };
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+// noinline: GCC 12 otherwise warns about free() on memory from operator new.
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static auto make_job(int i)
+{
+    return [a = std::make_shared<int>(i), x = i, y = i * 2, z = i * 3] {
+        sink.fetch_add(*a + x + y + z, std::memory_order_relaxed);
+    };
+}
+
+template<typename F>
+static void report(const char* what, int tasks, F&& body)
+{
+    const std::size_t before = allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    // make_job()'s shared_ptr accounts for one allocation per task on every path.
+    std::cout << what << ns / tasks << " ns, "
+              << static_cast<double>(allocations.load() - before) / tasks - 1.0 << " extra allocations per task" << std::endl;
+}
+
+template<typename Fn>
+static void construct_move_invoke(int tasks)
+{
+    for (int i = 0; i < tasks; ++i)
+    {
+        Fn f(make_job(i));
+        Fn g(std::move(f));
+        g();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int tasks = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5000000;
+    const ThreadPoolOptions one_worker{ .min_threads = 1, .max_threads = 1, .queue_capacity = std::size_t(1) << 22 };
+
+    report("std::function construct+move+invoke: ", tasks, [&] { construct_move_invoke<std::function<void()>>(tasks); });
+    report("UniqueTask    construct+move+invoke: ", tasks, [&] { construct_move_invoke<UniqueTask>(tasks); });
+
+    report("ThreadPoolExecutor, std::function:   ", tasks, [&] {
+        ThreadPoolExecutor pool(one_worker);
+        for (int i = 0; i < tasks; ++i)
+            pool.execute(std::function<void()>(make_job(i)));
+        pool.shutdown();
+    });
+    report("ThreadPoolExecutor, lambda:          ", tasks, [&] {
+        ThreadPoolExecutor pool(one_worker);
+        for (int i = 0; i < tasks; ++i)
+            pool.execute(make_job(i));
+        pool.shutdown();
+    });
+
+    std::cout << "checksum " << sink.load() << std::endl;
+    return 0;
+}
@@ -0,0 +1,521 @@
+module;
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+#else
+  #include <poll.h>
+  #include <sys/socket.h>
+#endif
+
+#include <mutex>
+
+#ifndef _MSC_VER
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides a client-side connection pool on top of the adapters, so
+// request/response clients reuse established TCP connections per endpoint.
+
+export module net_io_adapters.connection_pool;
+
+#ifdef _MSC_VER
+import <algorithm>;
+import <chrono>;
+import <condition_variable>;
+import <cstddef>;
+import <cstdint>;
+import <deque>;
+import <map>;
+import <memory>;
+import <span>;
+import <string>;
+import <thread>;
+import <utility>;
+import <vector>;
+#endif
+
+import modern_io;
+import net_io;
+import net_io_adapters;
+
+// The following imports are required for MSVC due to incomplete umbrella import support.
+import net_io.tcp_endpoint;
+import net_io.tcp_client;
+
+export namespace net_io_adapters
+{
+    /**
+     * @brief Configuration of a ConnectionPool (limits apply per endpoint).
+     *
+     * - min_idle: Connections kept open and ready once an endpoint has been used.
+     * - max_idle: Released connections beyond this count are closed instead of pooled.
+     * - max_total: Upper bound of open connections (leased + idle); acquire() waits at the limit.
+     * - idle_timeout: Idle connections older than this are evicted (down to min_idle).
+     * - acquire_timeout: Maximum time acquire() waits for a free slot.
+     * - connect_timeout: Upper bound for opening a connection, in acquire() and in the
+     *   background top-up (whose thread the destructor joins).
+     * - maintenance_interval: Period of the background health check/eviction pass (0 = off).
+     */
+    struct PoolOptions
+    {
+        std::size_t               min_idle = 0;
+        std::size_t               max_idle = 8;
+        std::size_t               max_total = 64;
+        std::chrono::milliseconds idle_timeout{ 30000 };
+        std::chrono::milliseconds acquire_timeout{ 5000 };
+        std::chrono::milliseconds connect_timeout{ 3000 };
+        std::chrono::milliseconds maintenance_interval{ 1000 };
+    };
+
+    /**
+     * @brief Counters of a ConnectionPool (per endpoint or aggregated).
+     *
+     * Wait times cover acquire() calls that had to block for a free slot.
+     */
+    struct PoolStats
+    {
+        std::uint64_t acquired = 0;      ///< Leases handed out.
+        std::uint64_t created = 0;       ///< Connections opened.
+        std::uint64_t reused = 0;        ///< Leases served from the idle list.
+        std::uint64_t evicted = 0;       ///< Idle connections closed by timeout or max_idle.
+        std::uint64_t health_failures = 0; ///< Idle connections found closed or dirty.
+        std::uint64_t waits = 0;         ///< acquire() calls that blocked.
+        std::uint64_t timeouts = 0;      ///< acquire() calls that gave up.
+        std::chrono::microseconds total_wait{ 0 };
+        std::chrono::microseconds max_wait{ 0 };
+        std::size_t idle = 0;            ///< Currently idle connections.
+        std::size_t leased = 0;          ///< Currently leased connections.
+    };
+
+    /**
+     * @brief A pooled TCP connection that satisfies InputStream and OutputStream.
+     *
+     * Handed out wrapped in a SharedStream by ConnectionPool::acquire(). A connection
+     * whose read or write fails is marked broken and closed instead of being returned
+     * to the pool; discard() does the same explicitly (e.g. after a protocol error).
+     */
+    class PooledConnection
+    {
+    public:
+        explicit PooledConnection(net_io::TcpClient client)
+            : client_(std::move(client))
+        {
+        }
+
+        // OutputStream methods
+        void write(const char* data, std::size_t size)
+        {
+            try
+            {
+                client_.write(data, size);
+            }
+            catch (...)
+            {
+                broken_ = true;
+                throw;
+            }
+        }
+        void write(std::span<const std::byte> data)
+        {
+            write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+        void write(std::span<const char> data)
+        {
+            write(data.data(), data.size());
+        }
+        void flush() noexcept
+        {
+            // No userland buffering for sockets.
+        }
+
+        // InputStream methods
+        std::size_t read(char* data, std::size_t size)
+        {
+            std::size_t n = client_.read(data, size);
+            if (n == 0 && size > 0)
+                broken_ = true; // EOF or error: the connection cannot be reused
+            return n;
+        }
+        std::size_t read(std::span<std::byte> data)
+        {
+            return read(reinterpret_cast<char*>(data.data()), data.size());
+        }
+        std::size_t read(std::span<char> data)
+        {
+            return read(data.data(), data.size());
+        }
+        bool eof() const noexcept
+        {
+            return false;
+        }
+
+        /// Do not return this connection to the pool when the lease ends.
+        void discard() noexcept { broken_ = true; }
+
+        bool broken() const noexcept { return broken_; }
+        net_io::sock_t native_handle() const noexcept { return client_.native_handle(); }
+        net_io::TcpClient& client() noexcept { return client_; }
+
+    private:
+        net_io::TcpClient client_;
+        bool broken_ = false;
+    };
+
+    /// Lease type handed out by ConnectionPool; copies share the lease.
+    using PooledStream = SharedStream<PooledConnection>;
+
+    /**
+     * @brief Client-side TCP connection pool keyed by endpoint.
+     *
+     * acquire() returns a PooledStream that can be used like the result of make_stream():
+     * copy it into DataInputStream/DataOutputStream as usual. When the last copy is
+     * destroyed, the connection goes back to the idle list of its endpoint (or is closed
+     * if it broke, the pool is full, or the pool is gone).
+     *
+     * Idle connections are reused LIFO so the most recently used (warmest) socket is
+     * handed out first. A background thread evicts connections idle longer than
+     * idle_timeout, drops connections the peer closed, and tops endpoints up to min_idle.
+     * Every checkout also runs a cheap health check.
+     *
+     * Example:
+     * @code
+     * ConnectionPool pool(PoolOptions{ .min_idle = 2, .max_idle = 16 });
+     * {
+     *     auto stream = pool.acquire(TcpEndpoint{"127.0.0.1", 9050});
+     *     DataOutputStream out(stream);
+     *     DataInputStream in(stream);
+     *     out.write_string("PING");
+     *     out.flush();
+     *     auto reply = in.read_string();
+     * } // connection returns to the pool here
+     * @endcode
+     */
+    class ConnectionPool
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit ConnectionPool(PoolOptions options = {})
+            : state_(std::make_shared<State>())
+        {
+            state_->options = options;
+            if (options.maintenance_interval.count() > 0)
+            {
+                maintenance_ = std::thread([state = state_]() { maintain(state); });
+            }
+        }
+
+        ConnectionPool(const ConnectionPool&) = delete;
+        ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+        /**
+         * @brief Closes all idle connections; outstanding leases are closed when released.
+         */
+        ~ConnectionPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(state_->mtx);
+                state_->closed = true;
+                for (auto& [key, bucket] : state_->buckets)
+                    bucket.idle.clear();
+            }
+            state_->cv.notify_all();
+            if (maintenance_.joinable())
+                maintenance_.join();
+        }
+
+        /**
+         * @brief Lease a connection to the given endpoint.
+         * @throws net_io::SocketException if the pool is exhausted for acquire_timeout,
+         *         or if opening a new connection fails.
+         */
+        PooledStream acquire(const net_io::TcpEndpoint& ep)
+        {
+            const auto start = clock::now();
+            std::string key = key_of(ep);
+            std::unique_lock<std::mutex> lock(state_->mtx);
+            Bucket& bucket = bucket_for(key, ep);
+            bool waited = false;
+
+            while (true)
+            {
+                // LIFO: the most recently released connection has the warmest state.
+                while (!bucket.idle.empty())
+                {
+                    Idle idle = std::move(bucket.idle.back());
+                    bucket.idle.pop_back();
+                    if (!healthy(idle.conn->native_handle()))
+                    {
+                        ++bucket.stats.health_failures;
+                        --bucket.open;
+                        continue;
+                    }
+                    ++bucket.stats.reused;
+                    record_wait(bucket, start, waited);
+                    return lease(key, std::move(idle.conn));
+                }
+
+                if (bucket.open < state_->options.max_total)
+                {
+                    ++bucket.open;
+                    lock.unlock();
+                    std::unique_ptr<PooledConnection> conn;
+                    try
+                    {
+                        conn = connect(ep, state_->options.connect_timeout);
+                    }
+                    catch (...)
+                    {
+                        lock.lock();
+                        --bucket.open;
+                        state_->cv.notify_all();
+                        throw;
+                    }
+                    lock.lock();
+                    ++bucket.stats.created;
+                    record_wait(bucket, start, waited);
+                    return lease(key, std::move(conn));
+                }
+
+                waited = true;
+                if (state_->cv.wait_until(lock, start + state_->options.acquire_timeout) == std::cv_status::timeout)
+                {
+                    ++bucket.stats.timeouts;
+                    throw net_io::SocketException("ConnectionPool: acquire timeout", 0, key);
+                }
+            }
+        }
+
+        /**
+         * @brief Returns the counters of one endpoint.
+         */
+        PoolStats stats(const net_io::TcpEndpoint& ep) const
+        {
+            std::lock_guard<std::mutex> lock(state_->mtx);
+            auto it = state_->buckets.find(key_of(ep));
+            return it == state_->buckets.end() ? PoolStats{} : snapshot(it->second);
+        }
+
+        /**
+         * @brief Returns the counters aggregated over all endpoints.
+         */
+        PoolStats stats() const
+        {
+            std::lock_guard<std::mutex> lock(state_->mtx);
+            PoolStats total;
+            for (const auto& [key, bucket] : state_->buckets)
+            {
+                PoolStats s = snapshot(bucket);
+                total.acquired        += s.acquired;
+                total.created         += s.created;
+                total.reused          += s.reused;
+                total.evicted         += s.evicted;
+                total.health_failures += s.health_failures;
+                total.waits           += s.waits;
+                total.timeouts        += s.timeouts;
+                total.total_wait      += s.total_wait;
+                total.max_wait         = std::max(total.max_wait, s.max_wait);
+                total.idle            += s.idle;
+                total.leased          += s.leased;
+            }
+            return total;
+        }
+
+    private:
+        struct Idle
+        {
+            std::unique_ptr<PooledConnection> conn;
+            clock::time_point since;
+        };
+
+        struct Bucket
+        {
+            explicit Bucket(const net_io::TcpEndpoint& e) : ep(e) {}
+            net_io::TcpEndpoint ep;
+            std::deque<Idle> idle;    ///< back() = most recently released
+            std::size_t open = 0;     ///< idle + leased + connecting
+            PoolStats stats;
+        };
+
+        // Shared with the maintenance thread and with outstanding leases.
+        struct State
+        {
+            std::mutex mtx;
+            std::condition_variable cv;
+            std::map<std::string, Bucket> buckets;
+            PoolOptions options;
+            bool closed = false;
+        };
+
+        static std::string key_of(const net_io::TcpEndpoint& ep)
+        {
+            return ep.address + ":" + std::to_string(ep.port);
+        }
+
+        Bucket& bucket_for(const std::string& key, const net_io::TcpEndpoint& ep)
+        {
+            auto it = state_->buckets.find(key);
+            if (it == state_->buckets.end())
+                it = state_->buckets.emplace(key, Bucket(ep)).first;
+            return it->second;
+        }
+
+        static std::unique_ptr<PooledConnection> connect(const net_io::TcpEndpoint& ep, std::chrono::milliseconds timeout)
+        {
+            net_io::TcpClient client(ep);
+            client.open(static_cast<int>(timeout.count()));
+            return std::make_unique<PooledConnection>(std::move(client));
+        }
+
+        static PoolStats snapshot(const Bucket& bucket)
+        {
+            PoolStats s = bucket.stats;
+            s.idle = bucket.idle.size();
+            s.leased = bucket.open - bucket.idle.size();
+            return s;
+        }
+
+        static void record_wait(Bucket& bucket, clock::time_point start, bool waited)
+        {
+            ++bucket.stats.acquired;
+            if (!waited)
+                return;
+            auto wait = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+            ++bucket.stats.waits;
+            bucket.stats.total_wait += wait;
+            bucket.stats.max_wait = std::max(bucket.stats.max_wait, wait);
+        }
+
+        // Wraps a connection into a lease whose deleter gives it back to the pool (lock held).
+        PooledStream lease(const std::string& key, std::unique_ptr<PooledConnection> conn)
+        {
+            std::weak_ptr<State> weak = state_;
+            std::shared_ptr<PooledConnection> shared(conn.release(), [weak, key](PooledConnection* raw) {
+                std::unique_ptr<PooledConnection> owned(raw);
+                auto state = weak.lock();
+                if (!state)
+                    return; // pool already destroyed: just close
+                std::lock_guard<std::mutex> lock(state->mtx);
+                auto it = state->buckets.find(key);
+                if (it == state->buckets.end())
+                    return;
+                Bucket& bucket = it->second;
+                if (state->closed || owned->broken() || bucket.idle.size() >= state->options.max_idle)
+                {
+                    if (!owned->broken() && !state->closed)
+                        ++bucket.stats.evicted;
+                    --bucket.open;
+                }
+                else
+                {
+                    bucket.idle.push_back(Idle{ std::move(owned), clock::now() });
+                }
+                state->cv.notify_all();
+            });
+            return PooledStream(std::move(shared));
+        }
+
+        /**
+         * @brief Returns false if an idle socket was closed by the peer or has unread data.
+         *
+         * A healthy idle connection is not readable; readability means EOF, an error,
+         * or a stray response that would corrupt the next request.
+         */
+        static bool healthy(net_io::sock_t fd)
+        {
+            if (fd == net_io::invalid_socket)
+                return false;
+            pollfd pfd{ fd, POLLIN, 0 };
+            return net_io::poll_sockets(std::span<pollfd>(&pfd, 1), 0) == 0;
+        }
+
+        // Background pass: health checks, idle eviction and min_idle top-up.
+        static void maintain(std::shared_ptr<State> state)
+        {
+            std::unique_lock<std::mutex> lock(state->mtx);
+            while (!state->closed)
+            {
+                state->cv.wait_for(lock, state->options.maintenance_interval);
+                if (state->closed)
+                    break;
+
+                const auto now = clock::now();
+                std::vector<std::pair<std::string, net_io::TcpEndpoint>> refill;
+                for (auto& [key, bucket] : state->buckets)
+                {
+                    // Oldest connections sit at the front of the LIFO list.
+                    for (auto it = bucket.idle.begin(); it != bucket.idle.end();)
+                    {
+                        bool expired = now - it->since >= state->options.idle_timeout &&
+                                       bucket.idle.size() > state->options.min_idle;
+                        bool dead = !healthy(it->conn->native_handle());
+                        if (expired || dead)
+                        {
+                            ++(dead ? bucket.stats.health_failures : bucket.stats.evicted);
+                            --bucket.open;
+                            it = bucket.idle.erase(it);
+                        }
+                        else
+                        {
+                            ++it;
+                        }
+                    }
+                    if (bucket.idle.size() < state->options.min_idle && bucket.open < state->options.max_total)
+                    {
+                        ++bucket.open;
+                        refill.emplace_back(key, bucket.ep);
+                    }
+                }
+
+                // Connect without holding the lock; one new connection per endpoint and pass.
+                // Each connect is bounded by connect_timeout, and a closed pool skips the
+                // rest, so the destructor is not held up by unreachable endpoints.
+                for (auto& [key, ep] : refill)
+                {
+                    std::unique_ptr<PooledConnection> conn;
+                    if (!state->closed)
+                    {
+                        const auto timeout = state->options.connect_timeout;
+                        lock.unlock();
+                        try
+                        {
+                            conn = connect(ep, timeout);
+                        }
+                        catch (...)
+                        {
+                        }
+                        lock.lock();
+                    }
+                    Bucket& bucket = state->buckets.at(key);
+                    if (conn && !state->closed)
+                    {
+                        ++bucket.stats.created;
+                        bucket.idle.push_front(Idle{ std::move(conn), clock::now() });
+                    }
+                    else
+                    {
+                        --bucket.open;
+                    }
+                    state->cv.notify_all();
+                }
+            }
+        }
+
+        std::shared_ptr<State> state_;
+        std::thread maintenance_;
+    };
+}
@@ -0,0 +1,941 @@
+module;
+
+#include <errno.h>
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+#else
+  #include <fcntl.h>
+  #include <poll.h>
+  #include <sys/socket.h>
+  #include <unistd.h>
+#endif
+
+#if defined(__linux__)
+  #include <sys/epoll.h>
+  #include <sys/eventfd.h>
+#endif
+
+#ifndef _MSC_VER
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides the single-threaded event loop that drives the coroutine
+// API: socket readiness (epoll on Linux, poll() elsewhere), timers (a heap for
+// precise sleeps, a timer wheel for coarse timeouts), and spawning of task<void>
+// coroutines. Awaitables for the socket classes are built on IoAwaitable.
+
+export module net_io.event_loop;
+
+#ifdef _MSC_VER
+import <algorithm>;
+import <atomic>;
+import <chrono>;
+import <coroutine>;
+import <cstddef>;
+import <cstdint>;
+import <deque>;
+import <exception>;
+import <functional>;
+import <memory>;
+import <mutex>;
+import <optional>;
+import <queue>;
+import <stdexcept>;
+import <thread>;
+import <type_traits>;
+import <unordered_map>;
+import <utility>;
+import <vector>;
+#endif
+
+// Module imports (sorted)
+import net_io_base;
+import net_io.log;
+import net_io.task;
+import net_io.timer_wheel;
+export import net_io_base; // Export sock_t and invalid_socket
+export import net_io.task;
+export import net_io.timer_wheel;
+
+export namespace net_io
+{
+  /// Readiness an operation waits for.
+  enum class IoEvent : std::uint8_t
+  {
+    Read,
+    Write
+  };
+
+  /**
+   * @brief Flags for send()/recv() in asynchronous operations.
+   *
+   * MSG_DONTWAIT makes a single call nonblocking, so a socket can be used with the
+   * async_ functions and the blocking API alike. Where it does not exist (Windows),
+   * the socket has to be switched to nonblocking mode with set_nonblocking(true).
+   */
+#if defined(MSG_DONTWAIT)
+  inline constexpr int async_io_flags = MSG_DONTWAIT;
+#else
+  inline constexpr int async_io_flags = 0;
+#endif
+
+  /**
+   * @brief Receiver of a readiness notification from EventLoop::watch() or EventLoop::defer().
+   *
+   * The waiter is usually an awaitable living in the suspended coroutine's frame,
+   * so waiting needs no allocation.
+   */
+  class IoWaiter
+  {
+  public:
+    /// Called on the loop thread once the watched socket is ready (or has an error).
+    virtual void io_ready() noexcept = 0;
+
+  protected:
+    ~IoWaiter() = default;
+  };
+
+  namespace detail
+  {
+    // Coroutine that owns a spawned task; the frame destroys itself on completion.
+    struct Detached
+    {
+      struct promise_type
+      {
+        Detached get_return_object() noexcept
+        {
+          return Detached{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        static void* operator new(std::size_t size) { return FramePool::allocate(size); }
+        static void operator delete(void* p, std::size_t size) noexcept { FramePool::deallocate(p, size); }
+
+        ~promise_type()
+        {
+          if (prev) prev->next = next;
+          else if (head) *head = next;
+          if (next) next->prev = prev;
+        }
+
+        // Intrusive list of live spawned tasks, so the loop can destroy them.
+        promise_type** head = nullptr;
+        promise_type* prev = nullptr;
+        promise_type* next = nullptr;
+      };
+
+      std::coroutine_handle<promise_type> h;
+    };
+
+    // Result slot of EventLoop::run_until_complete(). Shared with the running task, so a
+    // task that outlives the call (the loop stopped first) still writes to valid memory.
+    template<typename T>
+    struct Completion
+    {
+      std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> result;
+      std::exception_ptr error;
+      bool waiting = true; ///< run_until_complete() still waits; stop the loop when done.
+    };
+
+    inline Detached run_detached(task<void> t)
+    {
+      try
+      {
+        co_await std::move(t);
+      }
+      catch (const std::exception& ex)
+      {
+        static LogRateLimit limit;
+        log_message<LogLevel::Error>(limit, "EventLoop", [&] {
+          return std::string("Uncaught exception in spawned task: ") + ex.what();
+        });
+      }
+      catch (...)
+      {
+        static LogRateLimit limit;
+        log_message<LogLevel::Error>(limit, "EventLoop", [] { return "Uncaught exception in spawned task"; });
+      }
+    }
+  }
+
+  /**
+   * @brief Single-threaded event loop for coroutines and readiness callbacks.
+   *
+   * A loop belongs to the thread calling run(); EventLoop::current() returns it for the
+   * awaitables, so `co_await client.async_read(buf)` needs no loop argument. Only
+   * post() and stop() may be called from other threads. For more cores, run one loop per
+   * thread.
+   *
+   * Readiness is one-shot: watch() registers a waiter for the next readable or writable
+   * notification of a socket, and the waiter registers again if the operation would still
+   * block. On Linux this uses epoll with EPOLLONESHOT, so an idle connection costs no
+   * work per loop iteration; elsewhere the loop falls back to poll().
+   *
+   * Example usage:
+   * @code
+   * net_io::task<void> echo(net_io::TcpClient c)
+   * {
+   *     char buf[4096];
+   *     while (std::size_t n = co_await c.async_read(buf, sizeof(buf)))
+   *         co_await c.async_write(buf, n);
+   * }
+   *
+   * net_io::task<void> serve(net_io::TcpServer& server, net_io::EventLoop& loop)
+   * {
+   *     while (true)
+   *         loop.spawn(echo(co_await server.async_accept()));
+   * }
+   *
+   * net_io::EventLoop loop;
+   * loop.spawn(serve(server, loop));
+   * loop.run();
+   * @endcode
+   */
+  class EventLoop
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Create the loop.
+     * @param timer_tick Resolution of the timer wheel returned by timers().
+     * @throws SocketException if the readiness backend cannot be created.
+     */
+    explicit EventLoop(std::chrono::milliseconds timer_tick = std::chrono::milliseconds(10))
+      : wheel_(timer_tick)
+    {
+#if defined(__linux__)
+      epfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+      if (epfd_ < 0)
+        throw SocketException("epoll_create1 failed", errno);
+      wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (wake_fd_ < 0)
+      {
+        int err = errno;
+        ::close(epfd_);
+        throw SocketException("eventfd failed", err);
+      }
+      epoll_event ev{};
+      ev.events = EPOLLIN;
+      ev.data.fd = wake_fd_;
+      ::epoll_ctl(epfd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+#elif !defined(_WIN32)
+      int fds[2];
+      if (::pipe(fds) != 0)
+        throw SocketException("pipe failed", errno);
+      for (int fd : fds)
+      {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+      }
+      wake_fd_ = fds[0];
+      wake_write_fd_ = fds[1];
+#endif
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Destroys all spawned tasks that have not finished, then the backend.
+     */
+    ~EventLoop()
+    {
+      EventLoop* prev = std::exchange(current_, this);
+      while (detached_)
+        std::coroutine_handle<detail::Detached::promise_type>::from_promise(*detached_).destroy();
+      current_ = prev;
+#if defined(__linux__)
+      ::close(epfd_);
+      ::close(wake_fd_);
+#elif !defined(_WIN32)
+      ::close(wake_fd_);
+      ::close(wake_write_fd_);
+#endif
+    }
+
+    /// Returns the loop running on the calling thread, or nullptr.
+    static EventLoop* current() noexcept
+    {
+      return current_;
+    }
+
+    /**
+     * @brief Returns the loop running on the calling thread.
+     * @throws std::logic_error if the thread is not running an EventLoop.
+     */
+    static EventLoop& this_thread()
+    {
+      if (!current_)
+        throw std::logic_error("EventLoop: asynchronous operation outside of a running event loop");
+      return *current_;
+    }
+
+    /**
+     * @brief Start a task on this loop. The loop owns it until it finishes.
+     *
+     * The task starts on the next loop iteration. An exception escaping the task is
+     * logged at LogLevel::Error. Call from the loop thread, or before run().
+     */
+    void spawn(task<void> t)
+    {
+      auto h = detail::run_detached(std::move(t)).h;
+      auto& p = h.promise();
+      p.head = &detached_;
+      p.next = detached_;
+      if (detached_)
+        detached_->prev = &p;
+      detached_ = &p;
+      schedule(h);
+    }
+
+    /**
+     * @brief Run a task to completion and return its result.
+     *
+     * Drives the loop (including other spawned tasks) until the task finishes.
+     * @throws Whatever the task throws.
+     * @throws std::runtime_error if the loop stops or runs out of work first. The task
+     *         then stays spawned on the loop: a later run() continues it, ~EventLoop()
+     *         destroys it.
+     */
+    template<typename T>
+    T run_until_complete(task<T> t)
+    {
+      auto state = std::make_shared<detail::Completion<T>>();
+      spawn(complete_into(std::move(t), state));
+      run();
+      state->waiting = false;
+      if (state->error)
+        std::rethrow_exception(state->error);
+      if (!state->result)
+        throw std::runtime_error("EventLoop: run_until_complete() returned before the task finished");
+      if constexpr (!std::is_void_v<T>)
+        return std::move(*state->result);
+    }
+
+    /**
+     * @brief Run the loop on the calling thread.
+     *
+     * Returns when stop() is called or when there is nothing left to wait for
+     * (no runnable coroutines, watched sockets, timers or posted functions). Each
+     * stop() ends one run(); one issued before run() makes it return right away.
+     */
+    void run()
+    {
+      EventLoop* prev = std::exchange(current_, this);
+      try
+      {
+        while (!stop_.exchange(false, std::memory_order_relaxed))
+        {
+          run_ready();
+          run_posted();
+          run_timers();
+          if (wheel_.size() > 0)
+            wheel_.advance(clock::now());
+          if (stop_.exchange(false, std::memory_order_relaxed))
+            break;
+          if (ready_.empty() && deferred_.empty() && waiting_ == 0 && timers_.empty() && wheel_.size() == 0 && !has_posted())
+            break;
+
+          int timeout_ms = -1;
+          if (!ready_.empty() || !deferred_.empty())
+            timeout_ms = 0;
+          else
+          {
+            auto wake = clock::time_point::max();
+            if (!timers_.empty())
+              wake = timers_.top().deadline;
+            if (auto next = wheel_.next_expiry())
+              wake = std::min(wake, *next);
+            if (wake != clock::time_point::max())
+            {
+              auto left = std::chrono::ceil<std::chrono::milliseconds>(wake - clock::now());
+              timeout_ms = static_cast<int>(std::clamp<std::int64_t>(left.count(), 0, 60 * 60 * 1000));
+            }
+          }
+          poll_io(timeout_ms);
+        }
+      }
+      catch (...)
+      {
+        current_ = prev;
+        throw;
+      }
+      current_ = prev;
+    }
+
+    /// Make run() return after the current iteration, or the next run() at once. Thread-safe.
+    void stop() noexcept
+    {
+      stop_.store(true, std::memory_order_relaxed);
+      wake();
+    }
+
+    /**
+     * @brief Run a function on the loop thread. Thread-safe.
+     */
+    void post(std::function<void()> fn)
+    {
+      {
+        std::lock_guard<std::mutex> lock(post_mtx_);
+        posted_.push_back(std::move(fn));
+        has_posted_.store(true, std::memory_order_release);
+      }
+      wake();
+    }
+
+    /**
+     * @brief Resume a coroutine on the next loop iteration. Loop thread only.
+     */
+    void schedule(std::coroutine_handle<> h)
+    {
+      ready_.push_back(h);
+    }
+
+    /**
+     * @brief Notify a waiter on the next loop iteration. Loop thread only.
+     *
+     * Used by operations that completed without waiting, so their completion handler
+     * does not run inside the call that started them.
+     */
+    void defer(IoWaiter* waiter)
+    {
+      deferred_.push_back(waiter);
+    }
+
+    /**
+     * @brief Withdraw a waiter passed to defer() before it is notified (e.g. on destruction).
+     */
+    void cancel_deferred(IoWaiter* waiter) noexcept
+    {
+      for (IoWaiter*& w : deferred_)
+        if (w == waiter) w = nullptr;
+      for (IoWaiter*& w : deferred_run_)
+        if (w == waiter) w = nullptr;
+    }
+
+    /**
+     * @brief Resume a coroutine at (or shortly after) the given time. Loop thread only.
+     *
+     * Precise but O(log n); for many coarse timeouts that are usually cancelled, use timers().
+     */
+    void resume_at(clock::time_point deadline, std::coroutine_handle<> h)
+    {
+      timers_.push(Timer{ deadline, timer_seq_++, h });
+    }
+
+    /**
+     * @brief Register a waiter for the next readiness notification of a socket.
+     * @param fd The socket.
+     * @param ev Whether to wait for readability or writability.
+     * @param waiter Notified once, then forgotten; must stay valid until then.
+     * @throws SocketException if the socket cannot be watched.
+     *
+     * At most one waiter per socket and direction; a second watch() replaces the first.
+     * Loop thread only.
+     */
+    void watch(sock_t fd, IoEvent ev, IoWaiter* waiter)
+    {
+      FdState& st = fds_[fd];
+      IoWaiter*& slot = ev == IoEvent::Read ? st.reader : st.writer;
+      if (!slot)
+        ++waiting_;
+      slot = waiter;
+      try
+      {
+        arm(fd, st);
+      }
+      catch (...)
+      {
+        slot = nullptr;
+        --waiting_;
+        throw;
+      }
+    }
+
+    /**
+     * @brief Remove a waiter registered with watch() without notifying it.
+     * @param waiter If not null, only this waiter is removed (not one that replaced it).
+     * @return true if a waiter was removed.
+     */
+    bool unwatch(sock_t fd, IoEvent ev, IoWaiter* waiter = nullptr) noexcept
+    {
+      auto it = fds_.find(fd);
+      if (it == fds_.end())
+        return false;
+      IoWaiter*& slot = ev == IoEvent::Read ? it->second.reader : it->second.writer;
+      if (!slot || (waiter && slot != waiter))
+        return false;
+      slot = nullptr;
+      --waiting_;
+      return true;
+    }
+
+    /**
+     * @brief Returns the loop's timer wheel for coarse timeouts. Loop thread only.
+     *
+     * Timers fire from run() with the wheel's tick resolution. Used for operation
+     * deadlines (with_timeout()), idle timeouts and connect timeouts.
+     */
+    TimerWheel& timers() noexcept
+    {
+      return wheel_;
+    }
+
+    /// Returns the number of socket directions currently watched.
+    std::size_t watched() const noexcept
+    {
+      return waiting_;
+    }
+
+  private:
+    struct FdState
+    {
+      IoWaiter* reader = nullptr;
+      IoWaiter* writer = nullptr;
+      std::uint32_t armed = 0; ///< Interest currently registered with the backend.
+      bool registered = false;
+    };
+
+    struct Timer
+    {
+      clock::time_point deadline;
+      std::uint64_t seq; ///< Keeps timers with equal deadlines in FIFO order.
+      std::coroutine_handle<> h;
+
+      bool operator>(const Timer& other) const noexcept
+      {
+        return deadline != other.deadline ? deadline > other.deadline : seq > other.seq;
+      }
+    };
+
+    void run_ready()
+    {
+      // Coroutines scheduled while running wait for the next iteration, after I/O.
+      std::size_t n = ready_.size();
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        auto h = ready_.front();
+        ready_.pop_front();
+        h.resume();
+      }
+
+      // Swapping keeps the capacity of both vectors, so deferring does not allocate.
+      deferred_run_.swap(deferred_);
+      for (std::size_t i = 0; i < deferred_run_.size(); ++i)
+      {
+        if (IoWaiter* w = deferred_run_[i])
+          w->io_ready();
+      }
+      deferred_run_.clear();
+    }
+
+    bool has_posted() const noexcept
+    {
+      return has_posted_.load(std::memory_order_acquire);
+    }
+
+    void run_posted()
+    {
+      if (!has_posted())
+        return;
+      std::vector<std::function<void()>> batch;
+      {
+        std::lock_guard<std::mutex> lock(post_mtx_);
+        batch.swap(posted_);
+        has_posted_.store(false, std::memory_order_release);
+      }
+      for (auto& fn : batch)
+        fn();
+    }
+
+    void run_timers()
+    {
+      if (timers_.empty())
+        return;
+      auto now = clock::now();
+      while (!timers_.empty() && timers_.top().deadline <= now)
+      {
+        auto h = timers_.top().h;
+        timers_.pop();
+        h.resume();
+      }
+    }
+
+    void wake() noexcept
+    {
+#if defined(__linux__)
+      std::uint64_t one = 1;
+      [[maybe_unused]] auto r = ::write(wake_fd_, &one, sizeof(one));
+#elif !defined(_WIN32)
+      char c = 1;
+      [[maybe_unused]] auto r = ::write(wake_write_fd_, &c, 1);
+#endif
+    }
+
+    void drain_wake() noexcept
+    {
+#if defined(__linux__)
+      std::uint64_t value;
+      [[maybe_unused]] auto r = ::read(wake_fd_, &value, sizeof(value));
+#elif !defined(_WIN32)
+      char buf[64];
+      while (::read(wake_fd_, buf, sizeof(buf)) > 0) {}
+#endif
+    }
+
+    // Takes the waiters that the reported events satisfy and notifies them.
+    void dispatch(sock_t fd, bool readable, bool writable)
+    {
+      auto it = fds_.find(fd);
+      if (it == fds_.end())
+        return;
+      FdState& st = it->second;
+      st.armed = 0; // one-shot
+      IoWaiter* reader = readable ? std::exchange(st.reader, nullptr) : nullptr;
+      IoWaiter* writer = writable ? std::exchange(st.writer, nullptr) : nullptr;
+      waiting_ -= (reader != nullptr) + (writer != nullptr);
+      if (reader)
+        reader->io_ready();
+      if (writer)
+        writer->io_ready();
+
+      // A remaining waiter for the other direction lost its registration with the event.
+      FdState& after = fds_[fd];
+      if ((after.reader || after.writer) && after.armed == 0)
+      {
+        try
+        {
+          arm(fd, after);
+        }
+        catch (...)
+        {
+          // The socket is gone; wake the waiters so their operation reports the error.
+          IoWaiter* r = std::exchange(after.reader, nullptr);
+          IoWaiter* w = std::exchange(after.writer, nullptr);
+          waiting_ -= (r != nullptr) + (w != nullptr);
+          if (r) r->io_ready();
+          if (w) w->io_ready();
+        }
+      }
+    }
+
+#if defined(__linux__)
+    void arm(sock_t fd, FdState& st)
+    {
+      std::uint32_t events = (st.reader ? (EPOLLIN | EPOLLRDHUP) : 0u) | (st.writer ? EPOLLOUT : 0u);
+      if (events == 0 || events == st.armed)
+        return;
+      epoll_event ev{};
+      ev.events = events | EPOLLONESHOT;
+      ev.data.fd = fd;
+      int op = st.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+      int rc = ::epoll_ctl(epfd_, op, fd, &ev);
+      if (rc < 0 && op == EPOLL_CTL_MOD && errno == ENOENT)
+        rc = ::epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev); // the fd number was closed and reused
+      else if (rc < 0 && op == EPOLL_CTL_ADD && errno == EEXIST)
+        rc = ::epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev);
+      if (rc < 0)
+        throw SocketException("epoll_ctl failed", errno);
+      st.registered = true;
+      st.armed = events;
+    }
+
+    void poll_io(int timeout_ms)
+    {
+      epoll_event events[256];
+      int n = ::epoll_wait(epfd_, events, 256, timeout_ms);
+      if (n < 0)
+      {
+        if (errno == EINTR)
+          return;
+        throw SocketException("epoll_wait failed", errno);
+      }
+      for (int i = 0; i < n; ++i)
+      {
+        int fd = events[i].data.fd;
+        if (fd == wake_fd_)
+        {
+          drain_wake();
+          continue;
+        }
+        std::uint32_t e = events[i].events;
+        bool failed = (e & (EPOLLERR | EPOLLHUP)) != 0;
+        dispatch(fd, failed || (e & (EPOLLIN | EPOLLRDHUP)), failed || (e & EPOLLOUT));
+      }
+    }
+#else
+    void arm(sock_t, FdState& st)
+    {
+      st.armed = (st.reader ? POLLIN : 0) | (st.writer ? POLLOUT : 0);
+    }
+
+    void poll_io(int timeout_ms)
+    {
+      std::vector<pollfd> pfds;
+      pfds.reserve(waiting_ + 1);
+#  if !defined(_WIN32)
+      pfds.push_back(pollfd{ wake_fd_, POLLIN, 0 });
+#  else
+      // No wake-up handle: bound the wait so post() and stop() are noticed.
+      if (timeout_ms < 0 || timeout_ms > 10)
+        timeout_ms = 10;
+#  endif
+      for (auto& [fd, st] : fds_)
+      {
+        short events = static_cast<short>((st.reader ? POLLIN : 0) | (st.writer ? POLLOUT : 0));
+        if (events)
+          pfds.push_back(pollfd{ fd, events, 0 });
+      }
+#  if defined(_WIN32)
+      if (pfds.empty())
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+        return;
+      }
+      int n = ::WSAPoll(pfds.data(), static_cast<ULONG>(pfds.size()), timeout_ms);
+      if (n < 0)
+        throw SocketException("WSAPoll failed", WSAGetLastError());
+#  else
+      int n = ::poll(pfds.data(), static_cast<nfds_t>(pfds.size()), timeout_ms);
+      if (n < 0)
+      {
+        if (errno == EINTR)
+          return;
+        throw SocketException("poll failed", errno);
+      }
+#  endif
+      for (const pollfd& p : pfds)
+      {
+        if (p.revents == 0)
+          continue;
+#  if !defined(_WIN32)
+        if (p.fd == wake_fd_)
+        {
+          drain_wake();
+          continue;
+        }
+#  endif
+        bool failed = (p.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+        dispatch(p.fd, failed || (p.revents & POLLIN), failed || (p.revents & POLLOUT));
+      }
+    }
+#endif
+
+    // Body of run_until_complete(). The task and its result slot are parameters, so they
+    // live in this coroutine's frame and not on the caller's stack.
+    template<typename T>
+    static task<void> complete_into(task<T> t, std::shared_ptr<detail::Completion<T>> state)
+    {
+      try
+      {
+        if constexpr (std::is_void_v<T>)
+        {
+          co_await std::move(t);
+          state->result.emplace(true);
+        }
+        else
+        {
+          state->result.emplace(co_await std::move(t));
+        }
+      }
+      catch (...)
+      {
+        state->error = std::current_exception();
+      }
+      if (state->waiting)
+        this_thread().stop();
+    }
+
+    static inline thread_local EventLoop* current_ = nullptr;
+
+    std::unordered_map<sock_t, FdState> fds_;
+    std::size_t waiting_ = 0;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::vector<IoWaiter*> deferred_;
+    std::vector<IoWaiter*> deferred_run_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    std::uint64_t timer_seq_ = 0;
+    TimerWheel wheel_;
+    detail::Detached::promise_type* detached_ = nullptr;
+
+    std::mutex post_mtx_;
+    std::vector<std::function<void()>> posted_;
+    std::atomic<bool> has_posted_{ false };
+    std::atomic<bool> stop_{ false };
+
+#if defined(__linux__)
+    int epfd_ = -1;
+    int wake_fd_ = -1;
+#elif !defined(_WIN32)
+    int wake_fd_ = -1;
+    int wake_write_fd_ = -1;
+#endif
+  };
+
+  /**
+   * @brief Awaitable that retries a nonblocking operation until it completes.
+   *
+   * The operation returns std::optional: a value when it completed, std::nullopt when it
+   * would block. await_ready() tries it right away, so data that is already available
+   * costs no suspension and no system call besides the operation itself. Otherwise the
+   * coroutine is suspended until the loop reports readiness and the operation is retried.
+   * The awaitable lives in the coroutine frame and registers itself as the waiter, so
+   * waiting allocates nothing. Exceptions thrown by the operation are rethrown at the
+   * co_await.
+   *
+   * with_timeout() sets a deadline for the whole operation, kept on the loop's timer
+   * wheel; when it passes, the co_await throws SocketException with ETIMEDOUT. The timer
+   * is only armed if the operation has to wait.
+   *
+   * Example:
+   * @code
+   * std::size_t n = co_await client.async_read(buf, sizeof(buf)).with_timeout(std::chrono::seconds(30));
+   * @endcode
+   */
+  template<typename Op>
+  class IoAwaitable final : private IoWaiter
+  {
+  public:
+    using result_type = typename std::invoke_result_t<Op&>::value_type;
+
+    IoAwaitable(sock_t fd, IoEvent ev, Op op)
+      : fd_(fd), ev_(ev), op_(std::move(op))
+    {}
+
+    // Movable only before it is awaited (the loop and the timer refer to it afterwards).
+    IoAwaitable(IoAwaitable&& other) noexcept(std::is_nothrow_move_constructible_v<Op>)
+      : fd_(other.fd_), ev_(other.ev_), op_(std::move(other.op_)), timeout_(other.timeout_)
+    {}
+    IoAwaitable& operator=(IoAwaitable&&) = delete;
+
+    // A suspended coroutine can be destroyed without being resumed; do not leave the
+    // loop holding a pointer to this awaitable.
+    ~IoAwaitable()
+    {
+      if (watching_)
+        loop_->unwatch(fd_, ev_, this);
+    }
+
+    /// Fail the operation with ETIMEDOUT if it has not completed within timeout.
+    template<typename Rep, typename Period>
+    IoAwaitable with_timeout(std::chrono::duration<Rep, Period> timeout) &&
+    {
+      timeout_ = std::chrono::duration_cast<EventLoop::clock::duration>(timeout);
+      return std::move(*this);
+    }
+
+    bool await_ready()
+    {
+      result_ = op_();
+      return result_.has_value();
+    }
+
+    void await_suspend(std::coroutine_handle<> h)
+    {
+      h_ = h;
+      loop_ = &EventLoop::this_thread();
+      loop_->watch(fd_, ev_, this);
+      watching_ = true;
+      if (timeout_)
+      {
+        timer_.set_callback([this] { on_timeout(); });
+        loop_->timers().schedule(timer_, *timeout_);
+      }
+    }
+
+    result_type await_resume()
+    {
+      if (error_)
+        std::rethrow_exception(error_);
+      return std::move(*result_);
+    }
+
+  private:
+    void io_ready() noexcept override
+    {
+      watching_ = false; // the loop dropped the registration before notifying us
+      try
+      {
+        result_ = op_();
+        if (!result_)
+        {
+          loop_->watch(fd_, ev_, this);
+          watching_ = true;
+          return;
+        }
+      }
+      catch (...)
+      {
+        error_ = std::current_exception();
+      }
+      timer_.cancel();
+      h_.resume();
+    }
+
+    void on_timeout() noexcept
+    {
+      loop_->unwatch(fd_, ev_, this);
+      watching_ = false;
+      error_ = std::make_exception_ptr(SocketException("operation timed out", ETIMEDOUT));
+      h_.resume();
+    }
+
+    sock_t fd_;
+    IoEvent ev_;
+    Op op_;
+    std::optional<result_type> result_;
+    std::exception_ptr error_;
+    std::coroutine_handle<> h_;
+    EventLoop* loop_ = nullptr;
+    std::optional<EventLoop::clock::duration> timeout_;
+    TimerWheel::Timer timer_;
+    bool watching_ = false; ///< Registered with the loop as the waiter for fd_.
+  };
+
+  /**
+   * @brief Suspend the calling coroutine for at least the given duration.
+   * @throws std::logic_error if not awaited on an EventLoop thread.
+   *
+   * Example:
+   * @code
+   * co_await net_io::sleep_for(std::chrono::milliseconds(100));
+   * @endcode
+   */
+  template<typename Rep, typename Period>
+  auto sleep_for(std::chrono::duration<Rep, Period> d)
+  {
+    struct SleepAwaitable
+    {
+      EventLoop::clock::time_point deadline;
+
+      bool await_ready() const noexcept { return deadline <= EventLoop::clock::now(); }
+      void await_suspend(std::coroutine_handle<> h) { EventLoop::this_thread().resume_at(deadline, h); }
+      void await_resume() const noexcept {}
+    };
+    return SleepAwaitable{ EventLoop::clock::now() + std::chrono::duration_cast<EventLoop::clock::duration>(d) };
+  }
+}
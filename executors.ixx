@@ -0,0 +1,898 @@
+module;
+
+#include <mutex>
+#include <functional>
+
+#ifndef _MSC_VER
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides the Executor concept used by the server helpers and the
+// executors that ship with net_io_adapters (per-task threads, a bounded thread pool
+// and a work-stealing pool).
+
+export module net_io_adapters.executors;
+
+#ifdef _MSC_VER
+import <algorithm>;
+import <atomic>;
+import <concepts>;
+import <chrono>;
+import <condition_variable>;
+import <cstddef>;
+import <cstdint>;
+import <deque>;
+import <exception>;
+import <memory>;
+import <new>;
+import <stdexcept>;
+import <string>;
+import <thread>;
+import <type_traits>;
+import <utility>;
+import <vector>;
+#endif
+
+// Module imports (sorted)
+import net_io.log;
+
+export namespace net_io_adapters
+{
+    namespace detail
+    {
+        // Shared by the executors: a task that throws is counted by its executor and logged
+        // at Error level, rate-limited so that a failing task storm cannot stall the workers.
+        inline void log_task_exception(const char* what)
+        {
+            static net_io::LogRateLimit limit;
+            net_io::log_message<net_io::LogLevel::Error>(limit, "net_io_adapters", [what] {
+                return what ? std::string("Uncaught exception in executor task: ") + what
+                            : std::string("Uncaught exception in executor task");
+            });
+        }
+    }
+
+    /**
+     * @brief Move-only void() callable with inline storage, the task type of the executors.
+     *
+     * Unlike std::function it accepts move-only callables (a lambda capturing a
+     * unique_ptr or a moved stream), and callables up to inline_size bytes that are
+     * nothrow-movable are stored in place instead of on the heap. Larger ones are
+     * heap-allocated. A UniqueTask can be invoked repeatedly; calling an empty one
+     * is undefined.
+     *
+     * Example:
+     * @code
+     * auto buffer = std::make_unique<char[]>(4096);
+     * pool.execute([buffer = std::move(buffer)] { fill(buffer.get()); });
+     * @endcode
+     */
+    class UniqueTask
+    {
+    public:
+        /// Bytes available for captures without a heap allocation.
+        static constexpr std::size_t inline_size = 48;
+
+        UniqueTask() noexcept = default;
+        UniqueTask(std::nullptr_t) noexcept {}
+
+        template<typename F>
+            requires (!std::same_as<std::decay_t<F>, UniqueTask>) && std::invocable<std::decay_t<F>&>
+        UniqueTask(F&& f)
+        {
+            using T = std::decay_t<F>;
+            if constexpr (stored_inline<T>)
+                ::new (static_cast<void*>(storage_)) T(std::forward<F>(f));
+            else
+                ::new (static_cast<void*>(storage_)) T*(new T(std::forward<F>(f)));
+            vtable_ = &vtable_for<T>;
+        }
+
+        UniqueTask(UniqueTask&& other) noexcept
+            : vtable_(std::exchange(other.vtable_, nullptr))
+        {
+            if (vtable_)
+                vtable_->relocate(other.storage_, storage_);
+        }
+
+        UniqueTask& operator=(UniqueTask&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                vtable_ = std::exchange(other.vtable_, nullptr);
+                if (vtable_)
+                    vtable_->relocate(other.storage_, storage_);
+            }
+            return *this;
+        }
+
+        /// Destroys the callable (and its captures).
+        UniqueTask& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        UniqueTask(const UniqueTask&) = delete;
+        UniqueTask& operator=(const UniqueTask&) = delete;
+
+        ~UniqueTask()
+        {
+            reset();
+        }
+
+        void operator()()
+        {
+            vtable_->invoke(storage_);
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return vtable_ != nullptr;
+        }
+
+    private:
+        struct VTable
+        {
+            void (*invoke)(void*);
+            void (*relocate)(void* from, void* to) noexcept; // move-construct into to, destroy from
+            void (*destroy)(void*) noexcept;
+        };
+
+        template<typename T>
+        static constexpr bool stored_inline =
+            sizeof(T) <= inline_size && alignof(T) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible_v<T>;
+
+        template<typename T>
+        static T& object(void* storage) noexcept
+        {
+            if constexpr (stored_inline<T>)
+                return *std::launder(static_cast<T*>(storage));
+            else
+                return **static_cast<T**>(storage);
+        }
+
+        template<typename T>
+        static constexpr VTable vtable_for{
+            [](void* storage) { object<T>(storage)(); },
+            [](void* from, void* to) noexcept {
+                if constexpr (stored_inline<T>)
+                {
+                    T& obj = object<T>(from);
+                    ::new (to) T(std::move(obj));
+                    obj.~T();
+                }
+                else
+                {
+                    ::new (to) T*(*static_cast<T**>(from));
+                }
+            },
+            [](void* storage) noexcept {
+                if constexpr (stored_inline<T>)
+                    object<T>(storage).~T();
+                else
+                    delete *static_cast<T**>(storage);
+            },
+        };
+
+        void reset() noexcept
+        {
+            if (vtable_)
+            {
+                std::exchange(vtable_, nullptr)->destroy(storage_);
+            }
+        }
+
+        alignas(std::max_align_t) std::byte storage_[inline_size];
+        const VTable* vtable_ = nullptr;
+    };
+
+    // --- Executor concept und Beispiel-Executor ---
+    /**
+     * @brief Concept for Executor: Must support execute(UniqueTask) or execute(std::function<void()>).
+     *
+     * The executors in this module take UniqueTask and so accept move-only callables;
+     * executors written against std::function<void()> still qualify but only take
+     * copyable callables.
+     */
+    template<typename E>
+    concept Executor = requires(E e, UniqueTask t) {
+        { e.execute(std::move(t)) };
+    } || requires(E e, std::function<void()> f) {
+        { e.execute(std::move(f)) };
+    };
+
+    /**
+     * @brief Submit a move-only callable to any Executor.
+     *
+     * Executors with execute(UniqueTask) get the callable itself. Executors written
+     * against std::function<void()> get it behind a shared_ptr, since std::function
+     * needs a copyable target. Overload resolution cannot tell the two apart (the
+     * std::function constructor only fails in its body), hence the member pointer test.
+     */
+    template<Executor E, typename F>
+    void execute_unique(E& executor, F&& f)
+    {
+        if constexpr (requires { static_cast<void (E::*)(UniqueTask)>(&E::execute); })
+            executor.execute(std::forward<F>(f));
+        else
+            executor.execute([task = std::make_shared<std::decay_t<F>>(std::forward<F>(f))] { (*task)(); });
+    }
+
+    /**
+     * @brief Simple executor that starts a new thread for each task.
+     *
+     * Costs a thread creation per task and does not bound the number of threads;
+     * prefer ThreadPoolExecutor for servers.
+     */
+    class ThreadExecutor {
+    public:
+        void execute(UniqueTask f) {
+            std::thread(std::move(f)).detach();
+        }
+    };
+
+    /**
+     * @brief What ThreadPoolExecutor::execute() does when the queue is full.
+     *
+     * - Block: Wait until a slot becomes free.
+     * - Throw: Throw std::runtime_error.
+     * - CallerRuns: Run the task on the calling thread (natural backpressure).
+     * - Discard: Drop the task (counted in ThreadPoolMetrics::rejected).
+     */
+    enum class RejectionPolicy
+    {
+        Block,
+        Throw,
+        CallerRuns,
+        Discard
+    };
+
+    /**
+     * @brief Configuration of a ThreadPoolExecutor.
+     *
+     * - min_threads: Workers started up front and kept for the pool's lifetime.
+     * - max_threads: Upper bound of workers; if larger than min_threads, extra workers
+     *   are started while tasks queue up and retire after keep_alive without work.
+     * - queue_capacity: Maximum number of queued tasks.
+     * - rejection: Behavior of execute() when the queue is full.
+     * - keep_alive: Idle time after which an elastic worker above min_threads exits.
+     */
+    struct ThreadPoolOptions
+    {
+        std::size_t               min_threads = std::max(1u, std::thread::hardware_concurrency());
+        std::size_t               max_threads = std::max(1u, std::thread::hardware_concurrency());
+        std::size_t               queue_capacity = 1024;
+        RejectionPolicy           rejection = RejectionPolicy::Block;
+        std::chrono::milliseconds keep_alive{ 30000 };
+    };
+
+    /**
+     * @brief Snapshot of ThreadPoolExecutor counters.
+     *
+     * Wait time is measured from execute() until a worker picks the task up,
+     * run time is the duration of the task itself.
+     */
+    struct ThreadPoolMetrics
+    {
+        std::uint64_t submitted = 0;
+        std::uint64_t completed = 0;
+        std::uint64_t rejected = 0;     ///< Discarded, thrown or run by the caller.
+        std::uint64_t failed = 0;       ///< Tasks that ended with an exception.
+        std::size_t   queue_depth = 0;
+        std::size_t   peak_queue_depth = 0;
+        std::size_t   threads = 0;
+        std::size_t   busy_threads = 0;
+        std::chrono::microseconds total_wait{ 0 };
+        std::chrono::microseconds max_wait{ 0 };
+        std::chrono::microseconds total_run{ 0 };
+        std::chrono::microseconds max_run{ 0 };
+    };
+
+    /**
+     * @brief Executor with a bounded task queue and a fixed or elastic set of worker threads.
+     *
+     * Satisfies the Executor concept. Tasks are run in FIFO order. On destruction (or
+     * shutdown()) no new tasks are accepted, the queued tasks are finished and all workers
+     * are joined. Tasks must therefore terminate: a server accept loop running on the pool
+     * has to be stopped (running = false) before the pool is destroyed.
+     *
+     * Example:
+     * @code
+     * ThreadPoolExecutor pool(ThreadPoolOptions{ .min_threads = 4, .max_threads = 16,
+     *                                            .queue_capacity = 256,
+     *                                            .rejection = RejectionPolicy::CallerRuns });
+     * run_tcp_server(pool, handler, running, TcpEndpoint{"0.0.0.0", 9000});
+     * auto m = pool.metrics();
+     * @endcode
+     */
+    class ThreadPoolExecutor
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit ThreadPoolExecutor(ThreadPoolOptions options = {})
+            : options_(options)
+        {
+            if (options_.max_threads == 0 || options_.min_threads > options_.max_threads)
+                throw std::invalid_argument("ThreadPoolExecutor: invalid thread limits");
+            if (options_.queue_capacity == 0)
+                throw std::invalid_argument("ThreadPoolExecutor: queue capacity must be positive");
+            std::lock_guard<std::mutex> lock(mtx_);
+            // At least one worker must exist to drain the queue.
+            for (std::size_t i = 0; i < std::max<std::size_t>(options_.min_threads, 1); ++i)
+                spawn_worker();
+        }
+
+        ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+        ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+        ~ThreadPoolExecutor()
+        {
+            shutdown();
+        }
+
+        /**
+         * @brief Queue a task.
+         * @throws std::runtime_error if the pool is shut down, or if the queue is full
+         *         and the rejection policy is Throw.
+         */
+        void execute(UniqueTask f)
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (stopping_)
+                throw std::runtime_error("ThreadPoolExecutor: executor is shut down");
+
+            if (queue_.size() >= options_.queue_capacity)
+            {
+                switch (options_.rejection)
+                {
+                case RejectionPolicy::Block:
+                    not_full_.wait(lock, [&] { return queue_.size() < options_.queue_capacity || stopping_; });
+                    if (stopping_)
+                        throw std::runtime_error("ThreadPoolExecutor: executor is shut down");
+                    break;
+                case RejectionPolicy::Throw:
+                    ++metrics_.rejected;
+                    throw std::runtime_error("ThreadPoolExecutor: task queue full");
+                case RejectionPolicy::CallerRuns:
+                    ++metrics_.rejected;
+                    lock.unlock();
+                    f();
+                    return;
+                case RejectionPolicy::Discard:
+                    ++metrics_.rejected;
+                    return;
+                }
+            }
+
+            queue_.push_back(Task{ std::move(f), clock::now() });
+            ++metrics_.submitted;
+            metrics_.peak_queue_depth = std::max(metrics_.peak_queue_depth, queue_.size());
+
+            // Elastic growth: add a worker if the idle ones cannot take all queued tasks.
+            if (queue_.size() > idle_ && workers_.size() - retired_.size() < options_.max_threads)
+                spawn_worker();
+            not_empty_.notify_one();
+        }
+
+        /**
+         * @brief Stop accepting tasks, finish queued ones and join all workers (idempotent).
+         *
+         * Must not be called from a task running on this pool.
+         */
+        void shutdown()
+        {
+            std::vector<std::thread> workers;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                stopping_ = true;
+                workers.swap(workers_);
+                retired_.clear();
+            }
+            not_empty_.notify_all();
+            not_full_.notify_all();
+            for (auto& t : workers)
+            {
+                if (t.joinable())
+                    t.join();
+            }
+        }
+
+        /**
+         * @brief Returns a snapshot of the pool counters.
+         */
+        ThreadPoolMetrics metrics() const
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            ThreadPoolMetrics m = metrics_;
+            m.queue_depth = queue_.size();
+            m.threads = workers_.size() - retired_.size();
+            m.busy_threads = m.threads - idle_;
+            return m;
+        }
+
+    private:
+        struct Task
+        {
+            UniqueTask            fn;
+            clock::time_point     enqueued;
+        };
+
+        // Lock held. Joins workers that retired earlier, then starts a new one.
+        void spawn_worker()
+        {
+            for (auto id : retired_)
+            {
+                auto it = std::find_if(workers_.begin(), workers_.end(),
+                                       [id](const std::thread& t) { return t.get_id() == id; });
+                if (it != workers_.end())
+                {
+                    it->join(); // already past its last lock release, returns promptly
+                    workers_.erase(it);
+                }
+            }
+            retired_.clear();
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+
+        void worker_loop()
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            while (true)
+            {
+                ++idle_;
+                bool timed_out = false;
+                while (queue_.empty() && !stopping_)
+                {
+                    bool elastic = workers_.size() - retired_.size() > options_.min_threads;
+                    if (elastic)
+                    {
+                        if (not_empty_.wait_for(lock, options_.keep_alive) == std::cv_status::timeout &&
+                            queue_.empty() && workers_.size() - retired_.size() > options_.min_threads)
+                        {
+                            timed_out = true;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        not_empty_.wait(lock);
+                    }
+                }
+                --idle_;
+
+                if (queue_.empty())
+                {
+                    // Shutdown with a drained queue, or an idle elastic worker retiring.
+                    if (timed_out && !stopping_)
+                        retired_.push_back(std::this_thread::get_id());
+                    return;
+                }
+
+                Task task = std::move(queue_.front());
+                queue_.pop_front();
+                auto started = clock::now();
+                auto wait = std::chrono::duration_cast<std::chrono::microseconds>(started - task.enqueued);
+                metrics_.total_wait += wait;
+                metrics_.max_wait = std::max(metrics_.max_wait, wait);
+                not_full_.notify_one();
+                lock.unlock();
+
+                bool failed = false;
+                try
+                {
+                    task.fn();
+                }
+                catch (const std::exception& ex)
+                {
+                    failed = true;
+                    detail::log_task_exception(ex.what());
+                }
+                catch (...)
+                {
+                    failed = true;
+                    detail::log_task_exception(nullptr);
+                }
+                auto run = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - started);
+                task.fn = nullptr; // release captures outside the lock
+
+                lock.lock();
+                ++metrics_.completed;
+                if (failed)
+                    ++metrics_.failed;
+                metrics_.total_run += run;
+                metrics_.max_run = std::max(metrics_.max_run, run);
+            }
+        }
+
+        ThreadPoolOptions options_;
+        mutable std::mutex mtx_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+        std::deque<Task> queue_;
+        std::vector<std::thread> workers_;
+        std::vector<std::thread::id> retired_; ///< Elastic workers that exited but are not joined yet.
+        std::size_t idle_ = 0;
+        bool stopping_ = false;
+        ThreadPoolMetrics metrics_;
+    };
+
+    /**
+     * @brief Snapshot of WorkStealingExecutor counters, summed over all workers.
+     */
+    struct WorkStealingMetrics
+    {
+        std::uint64_t executed = 0;     ///< Tasks run.
+        std::uint64_t local_pushes = 0; ///< Tasks spawned from a worker onto its own deque.
+        std::uint64_t injected = 0;     ///< Tasks submitted from outside the pool.
+        std::uint64_t stolen = 0;       ///< Tasks taken from another worker's deque.
+        std::uint64_t parks = 0;        ///< Times a worker went to sleep for lack of work.
+        std::uint64_t failed = 0;       ///< Tasks that ended with an exception.
+        std::size_t   threads = 0;
+    };
+
+    /**
+     * @brief Executor for CPU-heavy handlers that spawn many small subtasks.
+     *
+     * Every worker owns a Chase-Lev deque. execute() called from one of the pool's own
+     * tasks pushes onto that worker's deque (no shared lock); the owner pops LIFO, which
+     * keeps recently spawned, cache-warm subtasks local. Tasks from other threads go
+     * into a shared injection queue. A worker without local work takes injected tasks,
+     * then tries to steal from the top of randomly chosen victims, and finally parks
+     * on an atomic wait (a futex on Linux) until new work arrives.
+     *
+     * Satisfies the Executor concept. The destructor runs all remaining tasks and joins
+     * the workers, so long-running tasks (e.g. accept loops) must be stopped first.
+     *
+     * Example:
+     * @code
+     * WorkStealingExecutor pool;
+     * pool.execute([&pool] {
+     *     for (auto& chunk : chunks)
+     *         pool.execute([&chunk] { decode_and_aggregate(chunk); }); // stays on this worker
+     * });
+     * @endcode
+     */
+    class WorkStealingExecutor
+    {
+    public:
+        /**
+         * @brief Start the workers.
+         * @param threads Number of workers (0 = std::thread::hardware_concurrency()).
+         */
+        explicit WorkStealingExecutor(std::size_t threads = 0)
+        {
+            if (threads == 0)
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            workers_.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i)
+                workers_.push_back(std::make_unique<Worker>(this, static_cast<std::uint32_t>(i)));
+            for (auto& w : workers_)
+                w->thread = std::thread([this, worker = w.get()] { worker_loop(*worker); });
+        }
+
+        WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+        WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+        ~WorkStealingExecutor()
+        {
+            stopping_.store(true, std::memory_order_seq_cst);
+            epoch_.fetch_add(1, std::memory_order_seq_cst);
+            epoch_.notify_all();
+            for (auto& w : workers_)
+            {
+                if (w->thread.joinable())
+                    w->thread.join();
+            }
+        }
+
+        /**
+         * @brief Submit a task; from a worker of this pool it goes onto the worker's own deque.
+         */
+        void execute(UniqueTask f)
+        {
+            auto* task = new Task{ std::move(f) };
+            Worker* self = current_worker_;
+            if (self && self->owner == this)
+            {
+                self->deque.push(task);
+                self->local_pushes.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(inject_mtx_);
+                injected_.push_back(task);
+                ++injected_count_;
+            }
+            wake_one();
+        }
+
+        /**
+         * @brief Returns a snapshot of the pool counters.
+         */
+        WorkStealingMetrics metrics() const
+        {
+            WorkStealingMetrics m;
+            for (const auto& w : workers_)
+            {
+                m.executed     += w->executed.load(std::memory_order_relaxed);
+                m.local_pushes += w->local_pushes.load(std::memory_order_relaxed);
+                m.stolen       += w->stolen.load(std::memory_order_relaxed);
+                m.parks        += w->parks.load(std::memory_order_relaxed);
+                m.failed       += w->failed.load(std::memory_order_relaxed);
+            }
+            std::lock_guard<std::mutex> lock(inject_mtx_);
+            m.injected = injected_count_;
+            m.threads = workers_.size();
+            return m;
+        }
+
+    private:
+        struct Task
+        {
+            UniqueTask fn;
+        };
+
+        /**
+         * Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013).
+         * The owner pushes and pops at the bottom; thieves take from the top. Replaced
+         * arrays are kept until destruction because a thief may still read from them.
+         */
+        class TaskDeque
+        {
+        public:
+            TaskDeque()
+            {
+                arrays_.push_back(std::make_unique<Array>(256));
+                array_.store(arrays_.back().get(), std::memory_order_relaxed);
+            }
+
+            // Owner only.
+            void push(Task* task)
+            {
+                std::int64_t b = bottom_.load(std::memory_order_relaxed);
+                std::int64_t t = top_.load(std::memory_order_acquire);
+                Array* a = array_.load(std::memory_order_relaxed);
+                if (b - t > static_cast<std::int64_t>(a->capacity) - 1)
+                    a = grow(a, t, b);
+                a->put(b, task);
+                std::atomic_thread_fence(std::memory_order_release);
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+
+            // Owner only.
+            Task* pop()
+            {
+                std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+                Array* a = array_.load(std::memory_order_relaxed);
+                bottom_.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                std::int64_t t = top_.load(std::memory_order_relaxed);
+                Task* task = nullptr;
+                if (t <= b)
+                {
+                    task = a->get(b);
+                    if (t == b)
+                    {
+                        // Last element: race against thieves for it.
+                        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                            task = nullptr;
+                        bottom_.store(b + 1, std::memory_order_relaxed);
+                    }
+                }
+                else
+                {
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                }
+                return task;
+            }
+
+            // Any thread.
+            Task* steal()
+            {
+                std::int64_t t = top_.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                std::int64_t b = bottom_.load(std::memory_order_acquire);
+                if (t >= b)
+                    return nullptr;
+                Array* a = array_.load(std::memory_order_acquire);
+                Task* task = a->get(t);
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    return nullptr; // lost the race
+                return task;
+            }
+
+        private:
+            struct Array
+            {
+                explicit Array(std::size_t cap)
+                    : capacity(cap), slots(new std::atomic<Task*>[cap])
+                {}
+                std::size_t capacity; // power of two
+                std::unique_ptr<std::atomic<Task*>[]> slots;
+
+                Task* get(std::int64_t i) const
+                {
+                    return slots[static_cast<std::size_t>(i) & (capacity - 1)].load(std::memory_order_relaxed);
+                }
+                void put(std::int64_t i, Task* task)
+                {
+                    slots[static_cast<std::size_t>(i) & (capacity - 1)].store(task, std::memory_order_relaxed);
+                }
+            };
+
+            Array* grow(Array* old, std::int64_t t, std::int64_t b)
+            {
+                arrays_.push_back(std::make_unique<Array>(old->capacity * 2));
+                Array* a = arrays_.back().get();
+                for (std::int64_t i = t; i < b; ++i)
+                    a->put(i, old->get(i));
+                array_.store(a, std::memory_order_release);
+                return a;
+            }
+
+            alignas(64) std::atomic<std::int64_t> top_{ 0 };
+            alignas(64) std::atomic<std::int64_t> bottom_{ 0 };
+            std::atomic<Array*> array_{ nullptr };
+            std::vector<std::unique_ptr<Array>> arrays_; ///< Owner only.
+        };
+
+        struct Worker
+        {
+            Worker(WorkStealingExecutor* o, std::uint32_t i)
+                : owner(o), index(i), rng(0x9E3779B9u * (i + 1))
+            {}
+
+            WorkStealingExecutor* owner;
+            std::uint32_t index;
+            std::uint32_t rng;   ///< xorshift state for victim selection
+            TaskDeque deque;
+            std::thread thread;
+            std::atomic<std::uint64_t> executed{ 0 };
+            std::atomic<std::uint64_t> local_pushes{ 0 };
+            std::atomic<std::uint64_t> stolen{ 0 };
+            std::atomic<std::uint64_t> parks{ 0 };
+            std::atomic<std::uint64_t> failed{ 0 };
+        };
+
+        // Wakes one parked worker if there is any (Dekker pairing with the park path).
+        void wake_one()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_relaxed) > 0)
+            {
+                epoch_.fetch_add(1, std::memory_order_release);
+                epoch_.notify_one();
+            }
+        }
+
+        Task* take_injected()
+        {
+            std::lock_guard<std::mutex> lock(inject_mtx_);
+            if (injected_.empty())
+                return nullptr;
+            Task* task = injected_.front();
+            injected_.pop_front();
+            return task;
+        }
+
+        // One pass over all other workers, starting at a random victim.
+        Task* steal_from_others(Worker& self)
+        {
+            std::size_t n = workers_.size();
+            if (n < 2)
+                return nullptr;
+            self.rng ^= self.rng << 13;
+            self.rng ^= self.rng >> 17;
+            self.rng ^= self.rng << 5;
+            std::size_t start = self.rng % n;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                Worker& victim = *workers_[(start + i) % n];
+                if (&victim == &self)
+                    continue;
+                if (Task* task = victim.deque.steal())
+                {
+                    self.stolen.fetch_add(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+            return nullptr;
+        }
+
+        Task* find_work(Worker& self)
+        {
+            if (Task* task = self.deque.pop())
+                return task;
+            if (Task* task = take_injected())
+                return task;
+            return steal_from_others(self);
+        }
+
+        void run(Worker& self, Task* task)
+        {
+            try
+            {
+                task->fn();
+            }
+            catch (const std::exception& ex)
+            {
+                self.failed.fetch_add(1, std::memory_order_relaxed);
+                detail::log_task_exception(ex.what());
+            }
+            catch (...)
+            {
+                self.failed.fetch_add(1, std::memory_order_relaxed);
+                detail::log_task_exception(nullptr);
+            }
+            delete task;
+            self.executed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void worker_loop(Worker& self)
+        {
+            current_worker_ = &self;
+            while (true)
+            {
+                if (Task* task = find_work(self))
+                {
+                    run(self, task);
+                    continue;
+                }
+
+                // Park: announce as sleeper, then re-check so a concurrent submit is not missed.
+                std::uint32_t epoch = epoch_.load(std::memory_order_acquire);
+                sleepers_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (Task* task = find_work(self))
+                {
+                    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                    run(self, task);
+                    continue;
+                }
+                if (stopping_.load(std::memory_order_seq_cst))
+                {
+                    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                    break; // all reachable work is done
+                }
+                self.parks.fetch_add(1, std::memory_order_relaxed);
+                epoch_.wait(epoch, std::memory_order_acquire);
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            current_worker_ = nullptr;
+        }
+
+        static inline thread_local Worker* current_worker_ = nullptr;
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        mutable std::mutex inject_mtx_;
+        std::deque<Task*> injected_;
+        std::uint64_t injected_count_ = 0;
+        std::atomic<std::uint32_t> epoch_{ 0 };    ///< Futex word parked workers wait on.
+        std::atomic<std::uint32_t> sleepers_{ 0 };
+        std::atomic<bool> stopping_{ false };
+    };
+
+    static_assert(Executor<ThreadExecutor>);
+    static_assert(Executor<ThreadPoolExecutor>);
+    static_assert(Executor<WorkStealingExecutor>);
+}
@@ -0,0 +1,648 @@
+module;
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+#else
+  #include <sys/socket.h>
+#endif
+
+#include <mutex>
+
+#ifndef _MSC_VER
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides a broadcast server: a publisher encodes each message once into
+// a shared buffer, and one event loop thread sends it to all subscribed TCP clients
+// through per-subscriber queues with a policy for slow subscribers.
+
+export module net_io_adapters.fanout;
+
+#ifdef _MSC_VER
+import <atomic>;
+import <chrono>;
+import <cstddef>;
+import <cstdint>;
+import <cstring>;
+import <deque>;
+import <memory>;
+import <span>;
+import <stdexcept>;
+import <string>;
+import <thread>;
+import <unordered_map>;
+import <utility>;
+import <vector>;
+#endif
+
+import net_io;
+import net_io_adapters.framed_stream;
+
+// The following imports are required for MSVC due to incomplete umbrella import support.
+import net_io.event_loop;
+import net_io.log;
+import net_io.task;
+import net_io.tcp_endpoint;
+import net_io.tcp_client;
+import net_io.tcp_server;
+
+export namespace net_io_adapters
+{
+    /**
+     * @brief What a FanoutServer does with a subscriber whose queue is over its limits.
+     *
+     * - DropOldest: Discard the oldest queued messages (the newest one is always kept).
+     * - Disconnect: Close the subscriber; it has to reconnect and resynchronize.
+     * - Conflate: A message replaces a queued, not yet sent message with the same key
+     *   (latest value per key, e.g. per instrument); messages with key 0 are never
+     *   conflated. If the queue is still too long, the oldest messages are dropped.
+     */
+    enum class SlowSubscriberPolicy
+    {
+        DropOldest,
+        Disconnect,
+        Conflate
+    };
+
+    /**
+     * @brief Configuration of a FanoutServer.
+     *
+     * - policy: Handling of slow subscribers (see SlowSubscriberPolicy).
+     * - max_queued_messages / max_queued_bytes: Per-subscriber queue limits. They also
+     *   bound the messages published but not yet picked up by the loop thread; beyond
+     *   them the oldest of those are dropped, whatever the policy.
+     * - prefix: Length prefix of each message; subscribers read with a FramedStream.
+     * - max_message_size: Larger payloads are refused by make_message().
+     */
+    struct FanoutOptions
+    {
+        SlowSubscriberPolicy policy = SlowSubscriberPolicy::DropOldest;
+        std::size_t          max_queued_messages = 1024;
+        std::size_t          max_queued_bytes = 4 * 1024 * 1024;
+        FramePrefix          prefix = FramePrefix::Varint;
+        std::size_t          max_message_size = 16 * 1024 * 1024;
+    };
+
+    /**
+     * @brief Counters of a FanoutServer.
+     */
+    struct FanoutStats
+    {
+        std::size_t   subscribers = 0;  ///< Currently connected subscribers.
+        std::uint64_t accepted = 0;     ///< Subscribers accepted since start().
+        std::uint64_t published = 0;    ///< Messages passed to publish().
+        std::uint64_t dropped = 0;      ///< Messages discarded for slow subscribers or a full inbox.
+        std::uint64_t conflated = 0;    ///< Queued messages replaced by a newer one with the same key.
+        std::uint64_t disconnected = 0; ///< Subscribers closed by the Disconnect policy.
+        std::uint64_t closed = 0;       ///< Subscribers that closed or failed on their own.
+    };
+
+    /**
+     * @brief An encoded message: length prefix and payload in one immutable buffer.
+     *
+     * Created once per publish and shared by all subscriber queues through
+     * FanoutMessagePtr, so a message is serialized and allocated once regardless of the
+     * number of subscribers.
+     */
+    class FanoutMessage
+    {
+    public:
+        /**
+         * @throws std::length_error if the payload does not fit a 32-bit length prefix.
+         */
+        FanoutMessage(std::span<const char> payload, std::uint64_t key, FramePrefix prefix)
+            : key_(key)
+        {
+            if (payload.size() > UINT32_MAX)
+                throw std::length_error("FanoutMessage: payload too large");
+            char header[max_frame_prefix_size];
+            prefix_size_ = encode_frame_prefix(header, static_cast<std::uint32_t>(payload.size()), prefix);
+            bytes_.resize(prefix_size_ + payload.size());
+            std::memcpy(bytes_.data(), header, prefix_size_);
+            if (!payload.empty())
+                std::memcpy(bytes_.data() + prefix_size_, payload.data(), payload.size());
+        }
+
+        /// The payload without the length prefix.
+        std::span<const char> payload() const noexcept
+        {
+            return std::span<const char>(bytes_).subspan(prefix_size_);
+        }
+
+        /// The bytes sent to each subscriber (prefix and payload).
+        std::span<const char> wire() const noexcept { return bytes_; }
+
+        /// Conflation key (0 = none).
+        std::uint64_t key() const noexcept { return key_; }
+
+    private:
+        std::vector<char> bytes_;
+        std::size_t prefix_size_ = 0;
+        std::uint64_t key_ = 0;
+    };
+
+    using FanoutMessagePtr = std::shared_ptr<const FanoutMessage>;
+
+    /**
+     * @brief Broadcasts messages to all connected TCP subscribers.
+     *
+     * start() listens on the endpoint and runs an EventLoop thread that accepts
+     * subscribers and owns their sockets (nonblocking). publish() may be called from any
+     * thread: it queues the shared message and wakes the loop once per batch. The loop
+     * appends every message of a batch to each subscriber's queue, then sends each queue
+     * with one gathered sendmsg() that stops when the socket is full; the rest goes out
+     * when the socket becomes writable. Subscribers that fall behind are handled by
+     * FanoutOptions::policy, so one slow reader never blocks the others.
+     *
+     * Subscribers receive length-prefixed frames and can read them with a FramedStream
+     * using the same prefix. Data sent by subscribers is read and discarded.
+     *
+     * Example:
+     * @code
+     * FanoutServer fanout(TcpEndpoint{"0.0.0.0", 9100}, FanoutOptions{ .policy = SlowSubscriberPolicy::Conflate });
+     * fanout.start();
+     * std::string quote = encode_quote(update);
+     * fanout.publish(std::span<const char>(quote), update.instrument_id);
+     * @endcode
+     */
+    class FanoutServer
+    {
+    public:
+        explicit FanoutServer(const net_io::TcpEndpoint& ep, FanoutOptions options = {})
+            : server_(ep), options_(options)
+        {
+        }
+
+        FanoutServer(const FanoutServer&) = delete;
+        FanoutServer& operator=(const FanoutServer&) = delete;
+
+        ~FanoutServer()
+        {
+            stop();
+        }
+
+        /**
+         * @brief Start listening and the loop thread.
+         * @throws SocketException if the endpoint cannot be bound.
+         * @throws std::logic_error if the server was stopped before.
+         */
+        void start()
+        {
+            if (thread_.joinable())
+                return;
+            if (stopped_)
+                throw std::logic_error("FanoutServer: cannot restart after stop()");
+            server_.start();
+            thread_ = std::thread([this] {
+                loop_.spawn(accept_loop());
+                loop_.run();
+            });
+            std::lock_guard<std::mutex> lock(inbox_mtx_);
+            accepting_ = true;
+        }
+
+        /**
+         * @brief Stop the loop thread, close all subscribers and stop listening.
+         *
+         * Queued messages are discarded, and later publish() calls are ignored. A stopped
+         * server cannot be restarted.
+         */
+        void stop()
+        {
+            if (!thread_.joinable())
+                return;
+            stopped_ = true;
+            {
+                std::lock_guard<std::mutex> lock(inbox_mtx_);
+                accepting_ = false;
+                inbox_.clear();
+                inbox_bytes_ = 0;
+            }
+            loop_.stop();
+            thread_.join();
+            for (auto& sub : subscribers_)
+                close_subscriber(*sub);
+            subscribers_.clear();
+            subscriber_count_.store(0, std::memory_order_relaxed);
+            server_.stop();
+        }
+
+        /**
+         * @brief Encode a message once for publish().
+         * @param payload Message bytes (copied).
+         * @param key Conflation key, 0 for none.
+         * @throws std::length_error if the payload exceeds max_message_size.
+         */
+        FanoutMessagePtr make_message(std::span<const char> payload, std::uint64_t key = 0) const
+        {
+            if (payload.size() > options_.max_message_size)
+                throw std::length_error("FanoutServer: message exceeds max_message_size");
+            return std::make_shared<const FanoutMessage>(payload, key, options_.prefix);
+        }
+
+        /**
+         * @brief Send a message to every subscriber connected when the loop picks it up.
+         *
+         * Thread-safe and non-blocking. The message must use this server's prefix (see
+         * make_message()). Messages published before start() or after stop() are dropped
+         * and not counted.
+         */
+        void publish(FanoutMessagePtr message)
+        {
+            bool wake;
+            {
+                std::lock_guard<std::mutex> lock(inbox_mtx_);
+                if (!accepting_)
+                    return;
+                // The loop thread fell behind the publishers: keep the newest messages.
+                const std::size_t size = message->wire().size();
+                while (!inbox_.empty()
+                       && (inbox_.size() >= options_.max_queued_messages || inbox_bytes_ + size > options_.max_queued_bytes))
+                {
+                    inbox_bytes_ -= inbox_.front()->wire().size();
+                    inbox_.pop_front();
+                    stats_.dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                inbox_.push_back(std::move(message));
+                inbox_bytes_ += size;
+                wake = !drain_posted_;
+                drain_posted_ = true;
+            }
+            stats_.published.fetch_add(1, std::memory_order_relaxed);
+            if (wake)
+                loop_.post([this] { drain_inbox(); });
+        }
+
+        /// Encode and publish in one step.
+        void publish(std::span<const char> payload, std::uint64_t key = 0)
+        {
+            publish(make_message(payload, key));
+        }
+
+        /// Returns the number of connected subscribers.
+        std::size_t subscribers() const noexcept
+        {
+            return subscriber_count_.load(std::memory_order_relaxed);
+        }
+
+        /// Returns a snapshot of the counters.
+        FanoutStats stats() const noexcept
+        {
+            FanoutStats s;
+            s.subscribers = subscribers();
+            s.accepted = stats_.accepted.load(std::memory_order_relaxed);
+            s.published = stats_.published.load(std::memory_order_relaxed);
+            s.dropped = stats_.dropped.load(std::memory_order_relaxed);
+            s.conflated = stats_.conflated.load(std::memory_order_relaxed);
+            s.disconnected = stats_.disconnected.load(std::memory_order_relaxed);
+            s.closed = stats_.closed.load(std::memory_order_relaxed);
+            return s;
+        }
+
+    private:
+        struct Subscriber;
+
+        // Forwards a readiness notification of one direction to the server.
+        struct SubscriberWaiter final : net_io::IoWaiter
+        {
+            SubscriberWaiter(FanoutServer* s, Subscriber* sub, bool w) noexcept
+                : server(s), subscriber(sub), write(w)
+            {
+            }
+
+            FanoutServer* server;
+            Subscriber* subscriber;
+            bool write;
+
+            void io_ready() noexcept override
+            {
+                if (write)
+                    server->on_writable(*subscriber);
+                else
+                    server->on_readable(*subscriber);
+            }
+        };
+
+        struct Entry
+        {
+            FanoutMessagePtr message;
+            std::uint64_t seq; ///< Position in the subscriber's stream of queued messages.
+        };
+
+        // Touched by the loop thread only.
+        struct Subscriber
+        {
+            Subscriber(FanoutServer* server, net_io::TcpClient c)
+                : client(std::move(c)), reader(server, this, false), writer(server, this, true)
+            {
+            }
+
+            net_io::TcpClient client;
+            FanoutMessagePtr sending;         ///< Partially sent message (not in queue).
+            std::size_t sending_offset = 0;
+            std::deque<Entry> queue;          ///< Unsent messages; seqs are consecutive.
+            std::uint64_t next_seq = 0;
+            std::size_t queued_bytes = 0;     ///< Bytes of the messages in queue.
+            std::unordered_map<std::uint64_t, std::uint64_t> latest; ///< Conflate: key -> seq in queue.
+            SubscriberWaiter reader;
+            SubscriberWaiter writer;
+            bool write_armed = false;
+            bool dead = false;
+        };
+
+        struct Counters
+        {
+            std::atomic<std::uint64_t> accepted{ 0 };
+            std::atomic<std::uint64_t> published{ 0 };
+            std::atomic<std::uint64_t> dropped{ 0 };
+            std::atomic<std::uint64_t> conflated{ 0 };
+            std::atomic<std::uint64_t> disconnected{ 0 };
+            std::atomic<std::uint64_t> closed{ 0 };
+        };
+
+        net_io::task<void> accept_loop()
+        {
+            while (true)
+            {
+                bool failed = false;
+                try
+                {
+                    add_subscriber(co_await server_.async_accept());
+                }
+                catch (const std::exception& ex)
+                {
+                    // Typically EMFILE; keep serving the connected subscribers.
+                    static net_io::LogRateLimit limit;
+                    net_io::log_message<net_io::LogLevel::Warn>(limit, "FanoutServer", [&] {
+                        return std::string("accept failed: ") + ex.what();
+                    });
+                    failed = true;
+                }
+                if (failed)
+                    co_await net_io::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+
+        void add_subscriber(net_io::TcpClient client)
+        {
+            client.set_nonblocking(true);
+            auto sub = std::make_unique<Subscriber>(this, std::move(client));
+            loop_.watch(sub->client.native_handle(), net_io::IoEvent::Read, &sub->reader);
+            subscribers_.push_back(std::move(sub));
+            subscriber_count_.store(subscribers_.size(), std::memory_order_relaxed);
+            stats_.accepted.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void drain_inbox()
+        {
+            {
+                std::lock_guard<std::mutex> lock(inbox_mtx_);
+                batch_.swap(inbox_);
+                inbox_bytes_ = 0;
+                drain_posted_ = false;
+            }
+            for (auto& sub : subscribers_)
+            {
+                if (sub->dead)
+                    continue;
+                for (const auto& message : batch_)
+                {
+                    enqueue(*sub, message);
+                    if (sub->dead)
+                        break;
+                }
+                if (!sub->dead && !sub->write_armed)
+                    send_queued(*sub);
+            }
+            batch_.clear();
+            reap();
+        }
+
+        void enqueue(Subscriber& sub, const FanoutMessagePtr& message)
+        {
+            const bool conflate = options_.policy == SlowSubscriberPolicy::Conflate && message->key() != 0;
+            bool replaced = false;
+            if (conflate)
+            {
+                auto it = sub.latest.find(message->key());
+                if (it != sub.latest.end())
+                {
+                    // A larger replacement can still push the queue over max_queued_bytes.
+                    Entry& queued = sub.queue[it->second - sub.queue.front().seq];
+                    sub.queued_bytes = sub.queued_bytes - queued.message->wire().size() + message->wire().size();
+                    queued.message = message;
+                    stats_.conflated.fetch_add(1, std::memory_order_relaxed);
+                    replaced = true;
+                }
+                else
+                {
+                    sub.latest.emplace(message->key(), sub.next_seq);
+                }
+            }
+            if (!replaced)
+            {
+                sub.queue.push_back(Entry{ message, sub.next_seq++ });
+                sub.queued_bytes += message->wire().size();
+            }
+
+            if (sub.queue.size() <= options_.max_queued_messages && sub.queued_bytes <= options_.max_queued_bytes)
+                return;
+            if (options_.policy == SlowSubscriberPolicy::Disconnect)
+            {
+                stats_.disconnected.fetch_add(1, std::memory_order_relaxed);
+                close_subscriber(sub);
+                return;
+            }
+            while (sub.queue.size() > 1
+                   && (sub.queue.size() > options_.max_queued_messages || sub.queued_bytes > options_.max_queued_bytes))
+            {
+                pop_front(sub);
+                stats_.dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void pop_front(Subscriber& sub)
+        {
+            Entry& front = sub.queue.front();
+            sub.queued_bytes -= front.message->wire().size();
+            if (!sub.latest.empty())
+            {
+                auto it = sub.latest.find(front.message->key());
+                if (it != sub.latest.end() && it->second == front.seq)
+                    sub.latest.erase(it);
+            }
+            sub.queue.pop_front();
+        }
+
+        // Sends the partially sent message and the queue until done or the socket is full.
+        void send_queued(Subscriber& sub)
+        {
+            constexpr std::size_t max_parts = 64;
+#if defined(MSG_NOSIGNAL)
+            const int flags = MSG_NOSIGNAL;
+#else
+            const int flags = 0;
+#endif
+            std::span<const char> parts[max_parts];
+            while (sub.sending || !sub.queue.empty())
+            {
+                std::size_t count = 0;
+                if (sub.sending)
+                    parts[count++] = sub.sending->wire().subspan(sub.sending_offset);
+                for (std::size_t i = 0; i < sub.queue.size() && count < max_parts; ++i)
+                    parts[count++] = sub.queue[i].message->wire();
+
+                net_io::IoResult r = net_io::send_gathered(sub.client.native_handle(),
+                                                           std::span<const std::span<const char>>(parts, count), flags,
+                                                           sub.client.is_nonblocking());
+                consume(sub, r.bytes);
+                if (r.would_block())
+                {
+                    loop_.watch(sub.client.native_handle(), net_io::IoEvent::Write, &sub.writer);
+                    sub.write_armed = true;
+                    return;
+                }
+                if (!r)
+                {
+                    stats_.closed.fetch_add(1, std::memory_order_relaxed);
+                    close_subscriber(sub);
+                    return;
+                }
+            }
+        }
+
+        // Removes sent bytes from the front; a message sent in part becomes sub.sending.
+        void consume(Subscriber& sub, std::size_t sent)
+        {
+            if (sub.sending)
+            {
+                std::size_t left = sub.sending->wire().size() - sub.sending_offset;
+                if (sent < left)
+                {
+                    sub.sending_offset += sent;
+                    return;
+                }
+                sent -= left;
+                sub.sending.reset();
+                sub.sending_offset = 0;
+            }
+            while (sent > 0 && !sub.queue.empty())
+            {
+                std::size_t size = sub.queue.front().message->wire().size();
+                if (sent < size)
+                {
+                    FanoutMessagePtr partial = sub.queue.front().message;
+                    pop_front(sub);
+                    sub.sending = std::move(partial);
+                    sub.sending_offset = sent;
+                    return;
+                }
+                sent -= size;
+                pop_front(sub);
+            }
+        }
+
+        void on_writable(Subscriber& sub)
+        {
+            sub.write_armed = false;
+            if (sub.dead)
+                return;
+            send_queued(sub);
+            schedule_reap();
+        }
+
+        void on_readable(Subscriber& sub)
+        {
+            if (sub.dead)
+                return;
+            char discard[4096];
+            while (true)
+            {
+                net_io::IoResult r = sub.client.try_read(discard, sizeof(discard));
+                if (r.would_block())
+                {
+                    loop_.watch(sub.client.native_handle(), net_io::IoEvent::Read, &sub.reader);
+                    return;
+                }
+                if (!r)
+                {
+                    stats_.closed.fetch_add(1, std::memory_order_relaxed);
+                    close_subscriber(sub);
+                    schedule_reap();
+                    return;
+                }
+            }
+        }
+
+        void close_subscriber(Subscriber& sub) noexcept
+        {
+            if (sub.dead)
+                return;
+            sub.dead = true;
+            net_io::sock_t fd = sub.client.native_handle();
+            loop_.unwatch(fd, net_io::IoEvent::Read);
+            loop_.unwatch(fd, net_io::IoEvent::Write);
+            sub.write_armed = false;
+            sub.client.close();
+            sub.queue.clear();
+            sub.latest.clear();
+            sub.sending.reset();
+        }
+
+        // Subscribers are destroyed outside their own waiter callbacks.
+        void schedule_reap()
+        {
+            if (reap_posted_)
+                return;
+            reap_posted_ = true;
+            loop_.post([this] { reap(); });
+        }
+
+        void reap()
+        {
+            reap_posted_ = false;
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < subscribers_.size(); ++i)
+            {
+                if (!subscribers_[i]->dead)
+                    subscribers_[kept++] = std::move(subscribers_[i]);
+            }
+            subscribers_.resize(kept);
+            subscriber_count_.store(kept, std::memory_order_relaxed);
+        }
+
+        net_io::TcpServer server_;
+        FanoutOptions options_;
+        net_io::EventLoop loop_;
+        std::thread thread_;
+        bool stopped_ = false; ///< Set by stop(); start() refuses to run again.
+
+        std::mutex inbox_mtx_;
+        std::deque<FanoutMessagePtr> inbox_;
+        std::size_t inbox_bytes_ = 0;
+        bool drain_posted_ = false;
+        bool accepting_ = false; ///< publish() queues only between start() and stop().
+
+        // Loop thread only.
+        std::deque<FanoutMessagePtr> batch_;
+        std::vector<std::unique_ptr<Subscriber>> subscribers_;
+        bool reap_posted_ = false;
+
+        std::atomic<std::size_t> subscriber_count_{ 0 };
+        Counters stats_;
+    };
+}
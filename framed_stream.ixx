@@ -0,0 +1,375 @@
+module;
+
+#ifndef _MSC_VER
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides length-prefixed message framing on top of any duplex stream
+// (TcpClient, UnixClient, MemoryPipeTransport, DuplexStream, SharedStream, ...).
+
+export module net_io_adapters.framed_stream;
+
+#ifdef _MSC_VER
+import <cstddef>;
+import <cstdint>;
+import <cstring>;
+import <memory>;
+import <optional>;
+import <span>;
+import <stdexcept>;
+import <utility>;
+import <vector>;
+#endif
+
+import net_io_concepts;
+
+export namespace net_io_adapters
+{
+    /**
+     * @brief Encoding of the length prefix in front of each frame.
+     *
+     * - Varint: unsigned LEB128, 1 byte for frames below 128 bytes, at most 5 bytes.
+     * - Fixed32: 4 bytes, big endian (network byte order).
+     */
+    enum class FramePrefix
+    {
+        Varint,
+        Fixed32
+    };
+
+    /**
+     * @brief Configuration of a FramedStream.
+     *
+     * - prefix: Length prefix encoding; both peers must agree.
+     * - max_frame_size: Larger frames are refused on write and treated as a protocol
+     *   error on read (guards against allocating whatever a corrupt prefix says).
+     * - read_buffer: Receive buffer size. Each read() asks for as much as fits, so many
+     *   small frames arrive with one system call. Larger frames are assembled in a
+     *   separate buffer.
+     */
+    struct FramingOptions
+    {
+        FramePrefix prefix = FramePrefix::Varint;
+        std::size_t max_frame_size = 16 * 1024 * 1024;
+        std::size_t read_buffer = 64 * 1024;
+    };
+
+    /// Largest length prefix in bytes (a 5-byte varint).
+    inline constexpr std::size_t max_frame_prefix_size = 5;
+
+    /**
+     * @brief Write the length prefix of a frame with size payload bytes.
+     * @param out Destination with room for max_frame_prefix_size bytes.
+     * @return Number of prefix bytes written.
+     *
+     * For code that builds frames itself, e.g. to encode a message once and send the
+     * same bytes to many connections.
+     */
+    inline std::size_t encode_frame_prefix(char* out, std::uint32_t size, FramePrefix prefix) noexcept
+    {
+        if (prefix == FramePrefix::Fixed32)
+        {
+            out[0] = static_cast<char>(size >> 24);
+            out[1] = static_cast<char>(size >> 16);
+            out[2] = static_cast<char>(size >> 8);
+            out[3] = static_cast<char>(size);
+            return 4;
+        }
+        std::size_t n = 0;
+        while (size >= 0x80)
+        {
+            out[n++] = static_cast<char>((size & 0x7F) | 0x80);
+            size >>= 7;
+        }
+        out[n++] = static_cast<char>(size);
+        return n;
+    }
+
+    /**
+     * @brief Length-prefixed message codec over a duplex stream.
+     *
+     * write_frame() sends the prefix and the payload together: as one gathered write
+     * when the stream has write_vectored() (TcpClient, UnixClient, DuplexStream), else
+     * encoded into the stream's buffer via reserve()/commit(), else as two writes.
+     *
+     * read_frame() returns a view of the payload inside the receive buffer; no copy is
+     * made. The view stays valid until the next read_frame() call. For streams with their
+     * own read buffer (DuplexStream, make_stream()) consider raw_stream buffers, since
+     * FramedStream already reads in large chunks.
+     *
+     * Unix SeqPacket sockets keep record boundaries themselves; use Stream sockets here.
+     *
+     * Example:
+     * @code
+     * TcpClient client(TcpEndpoint{"127.0.0.1", 9000});
+     * client.open();
+     * FramedStream framed(std::move(client));
+     * framed.write_frame(std::span<const char>("PING", 4));
+     * while (auto frame = framed.read_frame())
+     *     handle(*frame);
+     * @endcode
+     */
+    template<typename Stream>
+        requires net_io_concepts::Readable<Stream> && net_io_concepts::Writable<Stream>
+    class FramedStream
+    {
+    public:
+        static constexpr std::size_t max_prefix_size = max_frame_prefix_size;
+
+        explicit FramedStream(Stream stream, FramingOptions options = {})
+            : stream_(std::move(stream)), options_(options)
+        {
+            if (options_.read_buffer < max_prefix_size)
+                options_.read_buffer = max_prefix_size;
+        }
+
+        FramedStream(FramedStream&&) = default;
+        FramedStream& operator=(FramedStream&&) = default;
+
+        /**
+         * @brief Send one frame.
+         * @throws std::length_error if the payload exceeds max_frame_size.
+         */
+        void write_frame(const char* data, std::size_t size)
+        {
+            char prefix[max_prefix_size];
+            std::size_t prefix_size = encode_prefix(prefix, checked_size(size));
+
+            if constexpr (requires(Stream& s, std::span<const std::span<const char>> parts) { s.write_vectored(parts); })
+            {
+                const std::span<const char> parts[2] = {
+                    std::span<const char>(prefix, prefix_size), std::span<const char>(data, size) };
+                stream_.write_vectored(std::span<const std::span<const char>>(parts, size > 0 ? 2 : 1));
+            }
+            else
+            {
+                if constexpr (requires(Stream& s, std::size_t n) { s.reserve(n); s.commit(n); })
+                {
+                    std::span<char> space = stream_.reserve(prefix_size + size);
+                    if (space.size() >= prefix_size + size)
+                    {
+                        std::memcpy(space.data(), prefix, prefix_size);
+                        if (size > 0)
+                            std::memcpy(space.data() + prefix_size, data, size);
+                        stream_.commit(prefix_size + size);
+                        return;
+                    }
+                }
+                stream_.write(prefix, prefix_size);
+                if (size > 0)
+                    stream_.write(data, size);
+            }
+        }
+        void write_frame(std::span<const char> payload)
+        {
+            write_frame(payload.data(), payload.size());
+        }
+        void write_frame(std::span<const std::byte> payload)
+        {
+            write_frame(reinterpret_cast<const char*>(payload.data()), payload.size());
+        }
+
+        /**
+         * @brief Send several frames, gathered into as few writes as possible.
+         * @throws std::length_error if any payload exceeds max_frame_size (nothing is sent).
+         */
+        void write_frames(std::span<const std::span<const char>> frames)
+        {
+            for (const auto& frame : frames)
+                checked_size(frame.size());
+
+            if constexpr (requires(Stream& s, std::span<const std::span<const char>> parts) { s.write_vectored(parts); })
+            {
+                constexpr std::size_t batch = 32;
+                char prefixes[batch][max_prefix_size];
+                std::span<const char> parts[batch * 2];
+                for (std::size_t first = 0; first < frames.size(); first += batch)
+                {
+                    std::size_t count = 0;
+                    for (std::size_t i = first; i < frames.size() && i < first + batch; ++i)
+                    {
+                        char* prefix = prefixes[i - first];
+                        std::size_t size = frames[i].size();
+                        parts[count++] = std::span<const char>(prefix, encode_prefix(prefix, static_cast<std::uint32_t>(size)));
+                        if (size > 0)
+                            parts[count++] = frames[i];
+                    }
+                    stream_.write_vectored(std::span<const std::span<const char>>(parts, count));
+                }
+            }
+            else
+            {
+                for (const auto& frame : frames)
+                    write_frame(frame.data(), frame.size());
+            }
+        }
+
+        /// Flushes the underlying stream if it buffers writes.
+        void flush()
+        {
+            if constexpr (requires(Stream& s) { s.flush(); })
+                stream_.flush();
+        }
+
+        /**
+         * @brief Receive the next frame.
+         * @return A view of the payload, valid until the next read_frame(); std::nullopt
+         *         if the peer closed the stream between frames.
+         * @throws std::runtime_error on an oversized or malformed prefix, or if the
+         *         stream ends inside a frame.
+         */
+        std::optional<std::span<const char>> read_frame()
+        {
+            if (!buffer_)
+                buffer_ = std::make_unique<char[]>(options_.read_buffer);
+
+            while (true)
+            {
+                Header header = decode_prefix();
+                if (header.prefix_size > 0)
+                {
+                    std::size_t frame_size = header.prefix_size + header.payload_size;
+                    if (frame_size <= end_ - begin_)
+                    {
+                        const char* payload = buffer_.get() + begin_ + header.prefix_size;
+                        begin_ += frame_size;
+                        return std::span<const char>(payload, header.payload_size);
+                    }
+                    if (frame_size > options_.read_buffer)
+                        return read_large_frame(header);
+                    if (frame_size > options_.read_buffer - begin_)
+                        compact();
+                }
+                else if (begin_ + max_prefix_size > options_.read_buffer)
+                {
+                    compact();
+                }
+                if (begin_ == end_)
+                    begin_ = end_ = 0;
+
+                std::size_t n = stream_.read(buffer_.get() + end_, options_.read_buffer - end_);
+                if (n == 0)
+                {
+                    if (begin_ == end_)
+                        return std::nullopt;
+                    throw std::runtime_error("FramedStream: stream ended inside a frame");
+                }
+                end_ += n;
+            }
+        }
+
+        /// Returns true if read_frame() can return a frame without reading from the stream.
+        bool has_buffered_frame() const
+        {
+            Header header = decode_prefix();
+            return header.prefix_size > 0 && header.prefix_size + header.payload_size <= end_ - begin_;
+        }
+
+        /// Returns the number of received bytes not yet returned as frames.
+        std::size_t read_buffered() const noexcept { return end_ - begin_; }
+
+        const FramingOptions& options() const noexcept { return options_; }
+
+        // Access to the underlying stream; reading or writing it directly breaks the framing.
+        Stream& stream() noexcept { return stream_; }
+        const Stream& stream() const noexcept { return stream_; }
+
+    private:
+        struct Header
+        {
+            std::size_t prefix_size = 0; // 0 = incomplete
+            std::size_t payload_size = 0;
+        };
+
+        std::uint32_t checked_size(std::size_t size) const
+        {
+            if (size > options_.max_frame_size || size > UINT32_MAX)
+                throw std::length_error("FramedStream: frame exceeds max_frame_size");
+            return static_cast<std::uint32_t>(size);
+        }
+
+        std::size_t encode_prefix(char* out, std::uint32_t size) const noexcept
+        {
+            return encode_frame_prefix(out, size, options_.prefix);
+        }
+
+        Header decode_prefix() const
+        {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(buffer_.get() + begin_);
+            std::size_t available = end_ - begin_;
+            Header header;
+            if (options_.prefix == FramePrefix::Fixed32)
+            {
+                if (available < 4)
+                    return header;
+                header.payload_size = (std::size_t{ p[0] } << 24) | (std::size_t{ p[1] } << 16)
+                    | (std::size_t{ p[2] } << 8) | std::size_t{ p[3] };
+                header.prefix_size = 4;
+            }
+            else
+            {
+                std::uint64_t value = 0;
+                std::size_t i = 0;
+                while (true)
+                {
+                    if (i == available)
+                        return header;
+                    if (i == max_prefix_size)
+                        throw std::runtime_error("FramedStream: malformed length prefix");
+                    value |= std::uint64_t{ p[i] & 0x7Fu } << (7 * i);
+                    if ((p[i++] & 0x80) == 0)
+                        break;
+                }
+                if (value > UINT32_MAX)
+                    throw std::runtime_error("FramedStream: malformed length prefix");
+                header.payload_size = static_cast<std::size_t>(value);
+                header.prefix_size = i;
+            }
+            if (header.payload_size > options_.max_frame_size)
+                throw std::runtime_error("FramedStream: incoming frame exceeds max_frame_size");
+            return header;
+        }
+
+        // Moves the unconsumed bytes to the front of the receive buffer.
+        void compact() noexcept
+        {
+            std::size_t n = end_ - begin_;
+            if (n > 0 && begin_ > 0)
+                std::memmove(buffer_.get(), buffer_.get() + begin_, n);
+            begin_ = 0;
+            end_ = n;
+        }
+
+        // Frames that do not fit the receive buffer are read directly into large_.
+        std::span<const char> read_large_frame(Header header)
+        {
+            large_.resize(header.payload_size);
+            std::size_t have = end_ - begin_ - header.prefix_size;
+            std::memcpy(large_.data(), buffer_.get() + begin_ + header.prefix_size, have);
+            begin_ = end_ = 0;
+            while (have < header.payload_size)
+            {
+                std::size_t n = stream_.read(large_.data() + have, header.payload_size - have);
+                if (n == 0)
+                    throw std::runtime_error("FramedStream: stream ended inside a frame");
+                have += n;
+            }
+            return std::span<const char>(large_.data(), large_.size());
+        }
+
+        Stream stream_;
+        FramingOptions options_;
+        std::unique_ptr<char[]> buffer_;
+        std::size_t begin_ = 0;
+        std::size_t end_ = 0;
+        std::vector<char> large_;
+    };
+}
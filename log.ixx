@@ -0,0 +1,369 @@
+module;
+
+#ifndef _MSC_VER
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#endif
+
+// This module provides the logging hook used by net_io. Records below a
+// compile-time level are removed entirely, the runtime level costs one relaxed
+// atomic load, and messages are only formatted once a record passes both.
+
+// Records below this level are compiled out (0=Trace, 1=Debug, 2=Info, 3=Warn,
+// 4=Error, 5=Off). Set through the NET_IO_LOG_LEVEL CMake option.
+#ifndef NET_IO_LOG_LEVEL
+#define NET_IO_LOG_LEVEL 1
+#endif
+
+export module net_io.log;
+
+#ifdef _MSC_VER
+import <atomic>;
+import <chrono>;
+import <condition_variable>;
+import <cstdint>;
+import <cstdio>;
+import <deque>;
+import <functional>;
+import <memory>;
+import <mutex>;
+import <string>;
+import <string_view>;
+import <thread>;
+import <utility>;
+#endif
+
+export namespace net_io
+{
+  /// Severity of a log record; Off disables logging.
+  enum class LogLevel : int
+  {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+  };
+
+  /// Records below this level are not compiled in (see NET_IO_LOG_LEVEL).
+  inline constexpr LogLevel compiled_log_level = static_cast<LogLevel>(NET_IO_LOG_LEVEL);
+
+  /**
+   * @brief A log record as handed to the sink.
+   *
+   * The views are only valid during the sink call; a sink that keeps the record
+   * must copy them.
+   */
+  struct LogRecord
+  {
+    LogLevel level;
+    std::string_view component; ///< E.g. "TcpClient".
+    std::string_view message;
+    std::uint64_t suppressed = 0; ///< Records dropped by the call site's rate limit before this one.
+  };
+
+  /// Receives the records that pass the level filter; may be called from any thread.
+  using LogSink = std::function<void(const LogRecord&)>;
+
+  /**
+   * @brief Global log configuration: runtime level and sink.
+   *
+   * The level check is a relaxed atomic load, so a disabled record costs a load and
+   * a branch. The default level is Warn and the default sink writes one line per
+   * record to stderr.
+   *
+   * Example usage:
+   * @code
+   * net_io::Log::set_level(net_io::LogLevel::Debug);
+   * net_io::Log::set_sink(net_io::async_log_sink(net_io::stderr_log_sink()));
+   * @endcode
+   */
+  class Log
+  {
+  public:
+    /// Set the runtime level; records below it are dropped before formatting.
+    static void set_level(LogLevel level) noexcept
+    {
+      level_.store(level, std::memory_order_relaxed);
+    }
+
+    static LogLevel level() noexcept
+    {
+      return level_.load(std::memory_order_relaxed);
+    }
+
+    /// Returns true if a record of this level would reach the sink.
+    static bool enabled(LogLevel level) noexcept
+    {
+      return level >= compiled_log_level && level >= level_.load(std::memory_order_relaxed);
+    }
+
+    /// Replace the sink; an empty function restores the stderr sink. Thread-safe.
+    static void set_sink(LogSink sink)
+    {
+      auto next = sink ? std::make_shared<const LogSink>(std::move(sink)) : nullptr;
+      std::shared_ptr<const LogSink> prev;
+      {
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        prev = std::exchange(sink_, std::move(next));
+      }
+      // prev (possibly an async sink draining its queue) is released outside the lock.
+    }
+
+    /// Hand a record to the current sink, bypassing the level filter.
+    static void write(const LogRecord& record)
+    {
+      std::shared_ptr<const LogSink> sink;
+      {
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        sink = sink_;
+      }
+      if (sink)
+        (*sink)(record);
+      else
+        write_stderr(record);
+    }
+
+    /// Formats a record as "[component] message" plus a suppression note.
+    static std::string format(const LogRecord& record)
+    {
+      std::string line;
+      line.reserve(record.component.size() + record.message.size() + 48);
+      line += '[';
+      line += record.component;
+      line += "] ";
+      line += record.message;
+      if (record.suppressed)
+      {
+        line += " (";
+        line += std::to_string(record.suppressed);
+        line += " similar messages suppressed)";
+      }
+      return line;
+    }
+
+    /// The default sink: one unbuffered write per record, no flush of other streams.
+    static void write_stderr(const LogRecord& record)
+    {
+      std::string line = format(record);
+      line += '\n';
+      std::fwrite(line.data(), 1, line.size(), stderr);
+    }
+
+  private:
+    static inline std::atomic<LogLevel> level_{ LogLevel::Warn };
+    static inline std::mutex sink_mutex_;
+    static inline std::shared_ptr<const LogSink> sink_;
+  };
+
+  /// Returns a sink that writes to stderr (the default).
+  inline LogSink stderr_log_sink()
+  {
+    return [](const LogRecord& record) { Log::write_stderr(record); };
+  }
+
+  namespace detail
+  {
+    // Queue and worker thread behind async_log_sink().
+    class AsyncLogSink
+    {
+    public:
+      AsyncLogSink(LogSink inner, std::size_t capacity)
+        : inner_(std::move(inner)), capacity_(capacity ? capacity : 1)
+      {
+        worker_ = std::thread([this] { run(); });
+      }
+
+      AsyncLogSink(const AsyncLogSink&) = delete;
+      AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+      ~AsyncLogSink()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stop_ = true;
+        }
+        cv_.notify_one();
+        worker_.join();
+      }
+
+      void push(const LogRecord& record)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (queue_.size() >= capacity_)
+          {
+            ++dropped_;
+            return;
+          }
+          queue_.push_back(Entry{ record.level, std::string(record.component),
+                                  std::string(record.message), record.suppressed });
+        }
+        cv_.notify_one();
+      }
+
+    private:
+      struct Entry
+      {
+        LogLevel level;
+        std::string component;
+        std::string message;
+        std::uint64_t suppressed;
+      };
+
+      void run()
+      {
+        std::deque<Entry> batch;
+        while (true)
+        {
+          std::uint64_t dropped = 0;
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty())
+              return; // stopped and drained
+            batch.swap(queue_);
+            dropped = std::exchange(dropped_, 0);
+          }
+          for (const Entry& e : batch)
+            inner_(LogRecord{ e.level, e.component, e.message, e.suppressed });
+          batch.clear();
+          if (dropped)
+          {
+            std::string note = std::to_string(dropped) + " log records dropped (queue full)";
+            inner_(LogRecord{ LogLevel::Warn, "net_io", note, 0 });
+          }
+        }
+      }
+
+      LogSink inner_;
+      std::size_t capacity_;
+      std::mutex mutex_;
+      std::condition_variable cv_;
+      std::deque<Entry> queue_;
+      std::uint64_t dropped_ = 0;
+      bool stop_ = false;
+      std::thread worker_;
+    };
+  }
+
+  /**
+   * @brief Wrap a sink so that logging threads only enqueue the record.
+   * @param inner The sink called on the background thread.
+   * @param capacity Records queued at most; further records are dropped and counted.
+   *
+   * The worker thread is joined (after draining the queue) when the returned sink and
+   * all its copies are destroyed, e.g. when Log::set_sink() replaces it.
+   */
+  inline LogSink async_log_sink(LogSink inner, std::size_t capacity = 4096)
+  {
+    auto sink = std::make_shared<detail::AsyncLogSink>(std::move(inner), capacity);
+    return [sink](const LogRecord& record) { sink->push(record); };
+  }
+
+  /**
+   * @brief Per-call-site rate limit: at most limit records per second pass.
+   *
+   * Records over the limit are counted, and the count is reported with the next record
+   * that passes. Lock-free; the count is approximate when threads race at the start
+   * of a new second.
+   */
+  class LogRateLimit
+  {
+  public:
+    explicit constexpr LogRateLimit(std::uint32_t per_second = 10) noexcept
+      : limit_(per_second)
+    {}
+
+    LogRateLimit(const LogRateLimit&) = delete;
+    LogRateLimit& operator=(const LogRateLimit&) = delete;
+
+    /**
+     * @brief Returns true if a record may be written now.
+     * @param suppressed Set to the number of records dropped since the last admitted one.
+     */
+    bool admit(std::uint64_t& suppressed) noexcept
+    {
+      const std::int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+      std::int64_t window = window_.load(std::memory_order_relaxed);
+      if (window != now && window_.compare_exchange_strong(window, now, std::memory_order_relaxed))
+        count_.store(0, std::memory_order_relaxed);
+      if (count_.fetch_add(1, std::memory_order_relaxed) < limit_)
+      {
+        suppressed = dropped_.exchange(0, std::memory_order_relaxed);
+        return true;
+      }
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+  private:
+    std::uint32_t limit_;
+    std::atomic<std::int64_t> window_{ -1 };
+    std::atomic<std::uint32_t> count_{ 0 };
+    std::atomic<std::uint64_t> dropped_{ 0 };
+  };
+
+  /**
+   * @brief Log a record whose message is built only if the level is enabled.
+   * @tparam Level Severity; below compiled_log_level the call compiles to nothing.
+   * @param component Source of the record, e.g. "TcpClient".
+   * @param make_message Callable returning the message (std::string, std::string_view or
+   *                     const char*).
+   *
+   * Example:
+   * @code
+   * net_io::log_message<net_io::LogLevel::Debug>("TcpClient", [&] {
+   *     return "open() success, fd_=" + std::to_string(fd_);
+   * });
+   * @endcode
+   */
+  template<LogLevel Level, typename MakeMessage>
+  inline void log_message(std::string_view component, MakeMessage&& make_message)
+  {
+    if constexpr (Level >= compiled_log_level && Level != LogLevel::Off)
+    {
+      if (Log::enabled(Level))
+      {
+        const auto& message = make_message();
+        Log::write(LogRecord{ Level, component, message, 0 });
+      }
+    }
+  }
+
+  /**
+   * @brief Log a record through a rate limit, typically a function-local static.
+   *
+   * Example:
+   * @code
+   * static net_io::LogRateLimit limit;
+   * net_io::log_message<net_io::LogLevel::Warn>(limit, "UdpTransport", [&] { return describe(err); });
+   * @endcode
+   */
+  template<LogLevel Level, typename MakeMessage>
+  inline void log_message(LogRateLimit& limit, std::string_view component, MakeMessage&& make_message)
+  {
+    if constexpr (Level >= compiled_log_level && Level != LogLevel::Off)
+    {
+      std::uint64_t suppressed = 0;
+      if (Log::enabled(Level) && limit.admit(suppressed))
+      {
+        const auto& message = make_message();
+        Log::write(LogRecord{ Level, component, message, suppressed });
+      }
+    }
+  }
+}
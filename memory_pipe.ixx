@@ -0,0 +1,472 @@
+module;
+
+#include <errno.h>
+#include <mutex>
+
+#ifndef _MSC_VER
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides an in-process transport pair backed by bounded memory queues.
+// It behaves like a connected socket pair without touching the kernel, so protocol
+// layers, adapters and server handlers can be exercised and measured in isolation.
+
+export module net_io.memory_pipe;
+
+#ifdef _MSC_VER
+import <algorithm>;
+import <chrono>;
+import <condition_variable>;
+import <cstddef>;
+import <cstring>;
+import <deque>;
+import <map>;
+import <memory>;
+import <optional>;
+import <span>;
+import <stdexcept>;
+import <string>;
+import <utility>;
+import <vector>;
+#endif
+
+// Module imports (sorted)
+import net_io_base;
+import net_io_concepts;
+export import net_io_base; // Export sock_t and invalid_socket
+
+namespace net_io::detail
+{
+  /// Bounded single-direction byte queue shared by the two ends of a pipe.
+  class PipeBuffer
+  {
+  public:
+    explicit PipeBuffer(std::size_t capacity)
+      : data_(std::max<std::size_t>(capacity, 1))
+    {}
+
+    // Blocks while the buffer is full. Returns false if the reading end is closed.
+    bool write(const char* src, std::size_t size)
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      while (size > 0)
+      {
+        writable_.wait(lock, [&] { return size_ < data_.size() || reader_closed_; });
+        if (reader_closed_)
+          return false;
+        std::size_t n = std::min(size, data_.size() - size_);
+        std::size_t tail = (head_ + size_) % data_.size();
+        std::size_t first = std::min(n, data_.size() - tail);
+        std::memcpy(data_.data() + tail, src, first);
+        std::memcpy(data_.data(), src + first, n - first);
+        size_ += n;
+        src += n;
+        size -= n;
+        readable_.notify_one();
+      }
+      return true;
+    }
+
+    // Blocks until data is available. Returns 0 once the writing end is closed and drained.
+    std::size_t read(char* dst, std::size_t size)
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      readable_.wait(lock, [&] { return size_ > 0 || writer_closed_ || reader_closed_; });
+      if (reader_closed_)
+        return 0;
+      std::size_t n = std::min(size, size_);
+      std::size_t first = std::min(n, data_.size() - head_);
+      std::memcpy(dst, data_.data() + head_, first);
+      std::memcpy(dst + first, data_.data(), n - first);
+      head_ = (head_ + n) % data_.size();
+      size_ -= n;
+      writable_.notify_one();
+      return n;
+    }
+
+    void close_writer()
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      writer_closed_ = true;
+      readable_.notify_all();
+    }
+
+    void close_reader()
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      reader_closed_ = true;
+      readable_.notify_all();
+      writable_.notify_all();
+    }
+
+    std::size_t buffered() const
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      return size_;
+    }
+
+  private:
+    mutable std::mutex mtx_;
+    std::condition_variable readable_;
+    std::condition_variable writable_;
+    std::vector<char> data_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    bool writer_closed_ = false;
+    bool reader_closed_ = false;
+  };
+}
+
+export namespace net_io
+{
+  /**
+   * @brief Name of an in-process MemoryPipeServer, used in place of a TcpEndpoint.
+   *
+   * - name: Key under which the server is registered while it is started.
+   * - capacity: Buffer size per direction of each connection, in bytes.
+   */
+  struct MemoryPipeEndpoint
+  {
+    std::string name;
+    std::size_t capacity = 64 * 1024;
+  };
+
+  class MemoryPipeServer;
+
+  /**
+   * @brief One end of an in-process, bidirectional byte pipe.
+   *
+   * Each direction is a bounded queue: write() blocks while the peer's receive queue
+   * is full, read() blocks until data is available and returns 0 once the peer closed.
+   * This mirrors a blocking TcpClient without any system calls, so it can stand in
+   * for sockets when testing or benchmarking the protocol layers.
+   *
+   * Satisfies net_io_concepts::Transportable. Not copyable, but movable.
+   *
+   * Example usage:
+   * @code
+   * auto [a, b] = net_io::MemoryPipeTransport::pair();
+   * a.write("ping", 4);
+   * char buf[4];
+   * b.read(buf, sizeof(buf));
+   *
+   * // Connect to a started MemoryPipeServer
+   * net_io::MemoryPipeTransport client(net_io::MemoryPipeEndpoint{"bench"});
+   * client.open();
+   * @endcode
+   */
+  class MemoryPipeTransport
+  {
+  public:
+    /// Construct an unconnected transport.
+    MemoryPipeTransport() = default;
+
+    /**
+     * @brief Construct a transport that connects to a MemoryPipeServer on open().
+     * @param ep Name of the server and buffer size per direction.
+     */
+    explicit MemoryPipeTransport(MemoryPipeEndpoint ep)
+      : ep_(std::move(ep))
+    {}
+
+    /**
+     * @brief Create two connected ends.
+     * @param capacity Buffer size per direction, in bytes.
+     */
+    static std::pair<MemoryPipeTransport, MemoryPipeTransport> pair(std::size_t capacity = 64 * 1024)
+    {
+      auto ab = std::make_shared<detail::PipeBuffer>(capacity);
+      auto ba = std::make_shared<detail::PipeBuffer>(capacity);
+      return { MemoryPipeTransport(ba, ab), MemoryPipeTransport(ab, ba) };
+    }
+
+    // Not copyable: both ends own their side of the pipe.
+    MemoryPipeTransport(const MemoryPipeTransport&) = delete;
+    MemoryPipeTransport& operator=(const MemoryPipeTransport&) = delete;
+
+    MemoryPipeTransport(MemoryPipeTransport&&) noexcept = default;
+
+    MemoryPipeTransport& operator=(MemoryPipeTransport&& other) noexcept
+    {
+      if (this != &other)
+      {
+        close();
+        in_ = std::move(other.in_);
+        out_ = std::move(other.out_);
+        ep_ = std::move(other.ep_);
+      }
+      return *this;
+    }
+
+    ~MemoryPipeTransport()
+    {
+      close();
+    }
+
+    /**
+     * @brief Connect to the MemoryPipeServer named by the endpoint.
+     *
+     * Does nothing for ends created by pair() or accepted by a server.
+     * @throws SocketException if no server with that name is started.
+     */
+    void open();
+
+    /**
+     * @brief Shut down both directions but keep the buffers.
+     *
+     * Unlike close(), this may be called while another thread is blocked in read() or
+     * write() on this end: the read returns 0 and the write throws.
+     */
+    void shutdown() noexcept
+    {
+      if (out_)
+        out_->close_writer();
+      if (in_)
+        in_->close_reader();
+    }
+
+    /**
+     * @brief Close both directions (idempotent).
+     *
+     * The peer's read() returns 0 after draining, and its write() throws.
+     */
+    void close() noexcept
+    {
+      if (out_)
+      {
+        out_->close_writer();
+        out_.reset();
+      }
+      if (in_)
+      {
+        in_->close_reader();
+        in_.reset();
+      }
+    }
+
+    /**
+     * @brief Write all bytes, blocking while the peer's queue is full.
+     * @throws SocketException if not connected or the peer has closed.
+     */
+    void write(const char* data, std::size_t size)
+    {
+      if (!out_)
+        throw SocketException("MemoryPipeTransport::write(): not connected", ENOTCONN);
+      if (!out_->write(data, size))
+        throw SocketException("MemoryPipeTransport::write(): peer closed", EPIPE);
+    }
+
+    /**
+     * @brief Write several buffers in order (same semantics as write() on each).
+     * @throws SocketException if not connected or the peer has closed.
+     */
+    void write_vectored(std::span<const std::span<const char>> parts)
+    {
+      for (const auto& part : parts)
+        write(part.data(), part.size());
+    }
+
+    /**
+     * @brief Read up to size bytes, blocking until at least one byte is available.
+     * @return Number of bytes read, or 0 if the peer closed or the transport is not connected.
+     */
+    std::size_t read(char* data, std::size_t size)
+    {
+      if (!in_ || size == 0)
+        return 0;
+      return in_->read(data, size);
+    }
+
+    /// Returns whether the transport is connected.
+    bool is_open() const noexcept
+    {
+      return in_ != nullptr;
+    }
+
+    /// Returns the number of received bytes not yet read.
+    std::size_t available() const
+    {
+      return in_ ? in_->buffered() : 0;
+    }
+
+  private:
+    friend class MemoryPipeServer;
+
+    MemoryPipeTransport(std::shared_ptr<detail::PipeBuffer> in, std::shared_ptr<detail::PipeBuffer> out)
+      : in_(std::move(in)), out_(std::move(out))
+    {}
+
+    std::shared_ptr<detail::PipeBuffer> in_;
+    std::shared_ptr<detail::PipeBuffer> out_;
+    std::optional<MemoryPipeEndpoint> ep_;
+  };
+
+  /**
+   * @brief In-process server that accepts MemoryPipeTransport connections by name.
+   *
+   * Satisfies net_io_concepts::Acceptable and can replace TcpServer in
+   * run_server_with_executor(). start() registers the name process-wide; clients
+   * connect with MemoryPipeTransport(MemoryPipeEndpoint{name}).open() or
+   * net_io_adapters::make_stream(MemoryPipeEndpoint{name}).
+   *
+   * Example usage:
+   * @code
+   * net_io::MemoryPipeServer server(net_io::MemoryPipeEndpoint{"bench"});
+   * server.start();
+   * net_io::MemoryPipeTransport conn = server.accept();
+   * @endcode
+   */
+  class MemoryPipeServer
+  {
+  public:
+    /// Construct and store the endpoint, but do not start
+    explicit MemoryPipeServer(MemoryPipeEndpoint ep)
+      : state_(std::make_shared<State>())
+    {
+      if (ep.name.empty())
+        throw std::invalid_argument("MemoryPipeServer: empty name");
+      state_->ep = std::move(ep);
+    }
+
+    MemoryPipeServer(const MemoryPipeServer&) = delete;
+    MemoryPipeServer& operator=(const MemoryPipeServer&) = delete;
+
+    ~MemoryPipeServer() { stop(); }
+
+    /**
+     * @brief Register the server name so clients can connect.
+     * @throws SocketException if another started server uses the same name.
+     */
+    void start()
+    {
+      {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        state_->stopped = false;
+      }
+      std::lock_guard<std::mutex> lock(registry_mutex());
+      auto& slot = registry()[state_->ep.name];
+      if (auto other = slot.lock(); other && other != state_)
+        throw SocketException("MemoryPipeServer: name in use", EADDRINUSE, state_->ep.name);
+      slot = state_;
+    }
+
+    /// Set accept timeout in milliseconds (-1 = wait forever)
+    void set_accept_timeout(int ms)
+    {
+      accept_timeout_ms_ = ms;
+    }
+
+    /**
+     * @brief Accept the next pending connection.
+     * @throws SocketException on timeout or if the server is stopped.
+     */
+    MemoryPipeTransport accept()
+    {
+      std::unique_lock<std::mutex> lock(state_->mtx);
+      auto ready = [&] { return !state_->pending.empty() || state_->stopped; };
+      if (accept_timeout_ms_ >= 0)
+      {
+        if (!state_->cv.wait_for(lock, std::chrono::milliseconds(accept_timeout_ms_), ready))
+          throw SocketException("accept timeout", 0);
+      }
+      else
+      {
+        state_->cv.wait(lock, ready);
+      }
+      if (state_->pending.empty())
+        throw SocketException("MemoryPipeServer: stopped", 0, state_->ep.name);
+      MemoryPipeTransport conn = std::move(state_->pending.front());
+      state_->pending.pop_front();
+      return conn;
+    }
+
+    /// Unregister the name, refuse pending connections and wake blocked accept() calls
+    void stop() noexcept
+    {
+      {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        auto it = registry().find(state_->ep.name);
+        if (it != registry().end() && it->second.lock() == state_)
+          registry().erase(it);
+      }
+      std::lock_guard<std::mutex> lock(state_->mtx);
+      state_->stopped = true;
+      state_->pending.clear();
+      state_->cv.notify_all();
+    }
+
+  private:
+    friend class MemoryPipeTransport;
+
+    struct State
+    {
+      std::mutex mtx;
+      std::condition_variable cv;
+      std::deque<MemoryPipeTransport> pending;
+      MemoryPipeEndpoint ep;
+      bool stopped = true;
+    };
+
+    static std::mutex& registry_mutex()
+    {
+      static std::mutex mtx;
+      return mtx;
+    }
+
+    static std::map<std::string, std::weak_ptr<State>>& registry()
+    {
+      static std::map<std::string, std::weak_ptr<State>> servers;
+      return servers;
+    }
+
+    // Creates a connected pair, queues the server end and returns the client end.
+    static MemoryPipeTransport connect(const MemoryPipeEndpoint& ep)
+    {
+      std::shared_ptr<State> state;
+      {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        auto it = registry().find(ep.name);
+        if (it != registry().end())
+          state = it->second.lock();
+      }
+      if (!state)
+        throw SocketException("MemoryPipeTransport: connection refused", ECONNREFUSED, ep.name);
+
+      auto [client, server_end] = MemoryPipeTransport::pair(ep.capacity);
+      std::lock_guard<std::mutex> lock(state->mtx);
+      if (state->stopped)
+        throw SocketException("MemoryPipeTransport: connection refused", ECONNREFUSED, ep.name);
+      state->pending.push_back(std::move(server_end));
+      state->cv.notify_one();
+      return std::move(client);
+    }
+
+    std::shared_ptr<State> state_;
+    int accept_timeout_ms_ = -1; // -1 = no timeout
+  };
+
+  inline void MemoryPipeTransport::open()
+  {
+    if (in_ || !ep_)
+      return;
+    MemoryPipeTransport conn = MemoryPipeServer::connect(*ep_);
+    in_ = std::move(conn.in_);
+    out_ = std::move(conn.out_);
+  }
+
+  static_assert(net_io_concepts::Transportable<MemoryPipeTransport>, "MemoryPipeTransport does not implement Transportable concept!");
+  static_assert(net_io_concepts::Acceptable<MemoryPipeServer>, "MemoryPipeServer does not implement Acceptable concept!");
+}
@@ -43,4 +43,6 @@ export import :concepts;
 export import :file;
 export import :data;
 export import :buffered;
-export import :iostream;
\ No newline at end of file
+export import :iostream;
+export import :pipeline;
+export import :any;
\ No newline at end of file
@@ -0,0 +1,426 @@
+// modern_io_any.ixx
+module;
+
+#ifndef _MSC_VER
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#endif
+
+export module modern_io:any;
+import :concepts;
+
+#ifdef _MSC_VER
+import <algorithm>;
+import <concepts>;
+import <cstddef>;
+import <cstring>;
+import <memory>;
+import <new>;
+import <span>;
+import <type_traits>;
+import <utility>;
+#endif
+
+namespace modern_io
+{
+
+namespace detail
+{
+    // Streams up to this size (and nothrow-movable) are stored inside the Any object;
+    // larger ones (e.g. FileOutputStream with its std::ofstream) are heap-allocated.
+    inline constexpr std::size_t any_inline_size = 64;
+
+    template<typename S>
+    inline constexpr bool any_stored_inline =
+        sizeof(S) <= any_inline_size &&
+        alignof(S) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<S>;
+
+    struct AnyStorage
+    {
+        alignas(std::max_align_t) std::byte bytes[any_inline_size];
+    };
+
+    template<typename S>
+    S& any_object(AnyStorage& storage) noexcept
+    {
+        if constexpr (any_stored_inline<S>)
+            return *std::launder(reinterpret_cast<S*>(storage.bytes));
+        else
+            return **reinterpret_cast<S**>(storage.bytes);
+    }
+
+    template<typename S>
+    const S& any_object(const AnyStorage& storage) noexcept
+    {
+        return any_object<S>(const_cast<AnyStorage&>(storage));
+    }
+
+    template<typename S>
+    void any_emplace(AnyStorage& storage, S&& stream)
+    {
+        using T = std::decay_t<S>;
+        if constexpr (any_stored_inline<T>)
+            ::new (static_cast<void*>(storage.bytes)) T(std::forward<S>(stream));
+        else
+            ::new (static_cast<void*>(storage.bytes)) T*(new T(std::forward<S>(stream)));
+    }
+
+    // Move-constructs the stream into to and destroys it in from.
+    template<typename S>
+    void any_relocate(AnyStorage& from, AnyStorage& to) noexcept
+    {
+        if constexpr (any_stored_inline<S>)
+        {
+            S& obj = any_object<S>(from);
+            ::new (static_cast<void*>(to.bytes)) S(std::move(obj));
+            obj.~S();
+        }
+        else
+        {
+            ::new (static_cast<void*>(to.bytes)) S*(*reinterpret_cast<S**>(from.bytes));
+        }
+    }
+
+    template<typename S>
+    void any_destroy(AnyStorage& storage) noexcept
+    {
+        if constexpr (any_stored_inline<S>)
+            any_object<S>(storage).~S();
+        else
+            delete *reinterpret_cast<S**>(storage.bytes);
+    }
+
+    struct OutputStreamVTable
+    {
+        void (*write)(AnyStorage&, const char*, std::size_t);
+        void (*flush)(AnyStorage&);
+        void (*relocate)(AnyStorage&, AnyStorage&) noexcept;
+        void (*destroy)(AnyStorage&) noexcept;
+    };
+
+    struct InputStreamVTable
+    {
+        std::size_t (*read)(AnyStorage&, char*, std::size_t);
+        bool (*eof)(const AnyStorage&) noexcept;
+        void (*relocate)(AnyStorage&, AnyStorage&) noexcept;
+        void (*destroy)(AnyStorage&) noexcept;
+    };
+
+    template<typename S>
+    inline constexpr OutputStreamVTable output_vtable{
+        [](AnyStorage& s, const char* data, std::size_t size) { any_object<S>(s).write(data, size); },
+        [](AnyStorage& s) { any_object<S>(s).flush(); },
+        &any_relocate<S>,
+        &any_destroy<S>,
+    };
+
+    template<typename S>
+    inline constexpr InputStreamVTable input_vtable{
+        [](AnyStorage& s, char* data, std::size_t size) -> std::size_t { return any_object<S>(s).read(data, size); },
+        [](const AnyStorage& s) noexcept -> bool { return any_object<S>(s).eof(); },
+        &any_relocate<S>,
+        &any_destroy<S>,
+    };
+}
+
+// ------------------------------------------------------------------------
+// AnyOutputStream: type-erased OutputStream with a write buffer
+// ------------------------------------------------------------------------
+/**
+ * @brief Holds any OutputStream behind a non-template type, e.g. for plugin
+ *        boundaries or pipelines chosen at runtime.
+ *
+ * Small streams live in inline storage, others on the heap; calls go through a
+ * static table of function pointers. Writes are collected in a buffer, so only
+ * buffer flushes, large writes and flush() cross the type-erasure boundary, and
+ * DataOutputStream encodes values straight into the buffer (reserve/commit).
+ * Pass a buffer size of 0 to forward every write. The buffer is flushed (errors
+ * ignored) on destruction; call flush() to see errors.
+ *
+ * Example:
+ * @code
+ * AnyOutputStream sink = to_file ? AnyOutputStream(FileOutputStream("log.bin"))
+ *                                : AnyOutputStream(OstreamOutputStream(std::cout));
+ * DataOutputStream out(std::move(sink));
+ * out.write_int32(42);
+ * out.flush();
+ * @endcode
+ */
+export class AnyOutputStream
+{
+public:
+    static constexpr std::size_t default_buffer_size = 4096;
+
+    /// Takes ownership of stream; buffer_size 0 disables buffering.
+    template<typename S>
+        requires OutputStream<std::decay_t<S>> && (!std::same_as<std::decay_t<S>, AnyOutputStream>)
+    explicit AnyOutputStream(S&& stream, std::size_t buffer_size = default_buffer_size)
+      : vtable_(&detail::output_vtable<std::decay_t<S>>)
+      , capacity_(buffer_size)
+    {
+        detail::any_emplace(storage_, std::forward<S>(stream));
+    }
+
+    /// Move constructor
+    AnyOutputStream(AnyOutputStream&& other) noexcept
+      : vtable_(std::exchange(other.vtable_, nullptr))
+      , buffer_(std::move(other.buffer_))
+      , capacity_(other.capacity_)
+      , pos_(std::exchange(other.pos_, 0))
+    {
+        if (vtable_)
+            vtable_->relocate(other.storage_, storage_);
+    }
+
+    /// Move assignment
+    AnyOutputStream& operator=(AnyOutputStream&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            vtable_ = std::exchange(other.vtable_, nullptr);
+            buffer_ = std::move(other.buffer_);
+            capacity_ = other.capacity_;
+            pos_ = std::exchange(other.pos_, 0);
+            if (vtable_)
+                vtable_->relocate(other.storage_, storage_);
+        }
+        return *this;
+    }
+
+    AnyOutputStream(const AnyOutputStream&) = delete;
+    AnyOutputStream& operator=(const AnyOutputStream&) = delete;
+
+    ~AnyOutputStream() noexcept
+    {
+        reset();
+    }
+
+    /// Write n bytes from data.
+    void write(const char* data, std::size_t size)
+    {
+        if (size == 0)
+            return;
+        if (pos_ + size > capacity_)
+        {
+            flush_buffer();
+            if (size >= capacity_)
+            {
+                vtable_->write(storage_, data, size);
+                return;
+            }
+        }
+        std::memcpy(buffer() + pos_, data, size);
+        pos_ += size;
+    }
+
+    /// Write a std::span<std::byte>.
+    void write(std::span<const std::byte> data)
+    {
+        write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    /// Write a std::span<char>.
+    void write(std::span<const char> data)
+    {
+        write(data.data(), data.size());
+    }
+
+    /// Return at least n bytes of buffer space (flushing if needed), or an empty span
+    /// if n exceeds the buffer size. Fill it and call commit().
+    [[nodiscard]] std::span<char> reserve(std::size_t n)
+    {
+        if (n > capacity_)
+            return {};
+        if (capacity_ - pos_ < n)
+            flush_buffer();
+        return std::span<char>(buffer() + pos_, capacity_ - pos_);
+    }
+
+    /// Append the first n bytes of the span returned by reserve().
+    void commit(std::size_t n)
+    {
+        pos_ += n;
+    }
+
+    /// Write the buffered bytes and flush the wrapped stream.
+    void flush()
+    {
+        flush_buffer();
+        vtable_->flush(storage_);
+    }
+
+    /// Number of bytes waiting for flush().
+    [[nodiscard]] std::size_t buffered() const noexcept { return pos_; }
+
+private:
+    char* buffer()
+    {
+        if (!buffer_)
+            buffer_ = std::make_unique_for_overwrite<char[]>(capacity_);
+        return buffer_.get();
+    }
+
+    void flush_buffer()
+    {
+        if (pos_ > 0)
+        {
+            std::size_t n = std::exchange(pos_, 0);
+            vtable_->write(storage_, buffer_.get(), n);
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (vtable_)
+        {
+            try { flush_buffer(); } catch (...) {}
+            vtable_->destroy(storage_);
+            vtable_ = nullptr;
+        }
+    }
+
+    const detail::OutputStreamVTable* vtable_;
+    detail::AnyStorage                storage_;
+    std::unique_ptr<char[]>           buffer_;
+    std::size_t                       capacity_;
+    std::size_t                       pos_ = 0;
+};
+
+// ------------------------------------------------------------------------
+// AnyInputStream: type-erased InputStream with a read buffer
+// ------------------------------------------------------------------------
+/**
+ * @brief Holds any InputStream behind a non-template type.
+ *
+ * Storage and dispatch as in AnyOutputStream. Reads are served from a buffer that
+ * is refilled with one call of the wrapped stream, so small reads (a length prefix,
+ * then a value) do not cross the type-erasure boundary. A read returns what is
+ * buffered without waiting for more; reads at least as large as the buffer bypass
+ * it when it is empty. Pass a buffer size of 0 to forward every read.
+ */
+export class AnyInputStream
+{
+public:
+    static constexpr std::size_t default_buffer_size = 4096;
+
+    /// Takes ownership of stream; buffer_size 0 disables buffering.
+    template<typename S>
+        requires InputStream<std::decay_t<S>> && (!std::same_as<std::decay_t<S>, AnyInputStream>)
+    explicit AnyInputStream(S&& stream, std::size_t buffer_size = default_buffer_size)
+      : vtable_(&detail::input_vtable<std::decay_t<S>>)
+      , capacity_(buffer_size)
+    {
+        detail::any_emplace(storage_, std::forward<S>(stream));
+    }
+
+    /// Move constructor
+    AnyInputStream(AnyInputStream&& other) noexcept
+      : vtable_(std::exchange(other.vtable_, nullptr))
+      , buffer_(std::move(other.buffer_))
+      , capacity_(other.capacity_)
+      , pos_(std::exchange(other.pos_, 0))
+      , end_(std::exchange(other.end_, 0))
+    {
+        if (vtable_)
+            vtable_->relocate(other.storage_, storage_);
+    }
+
+    /// Move assignment
+    AnyInputStream& operator=(AnyInputStream&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            vtable_ = std::exchange(other.vtable_, nullptr);
+            buffer_ = std::move(other.buffer_);
+            capacity_ = other.capacity_;
+            pos_ = std::exchange(other.pos_, 0);
+            end_ = std::exchange(other.end_, 0);
+            if (vtable_)
+                vtable_->relocate(other.storage_, storage_);
+        }
+        return *this;
+    }
+
+    AnyInputStream(const AnyInputStream&) = delete;
+    AnyInputStream& operator=(const AnyInputStream&) = delete;
+
+    ~AnyInputStream() noexcept
+    {
+        reset();
+    }
+
+    /// Read up to size bytes into data, return the number of bytes read.
+    std::size_t read(char* data, std::size_t size)
+    {
+        if (pos_ == end_)
+        {
+            if (size == 0)
+                return 0;
+            if (size >= capacity_)
+                return vtable_->read(storage_, data, size);
+            if (!buffer_)
+                buffer_ = std::make_unique_for_overwrite<char[]>(capacity_);
+            pos_ = 0;
+            end_ = vtable_->read(storage_, buffer_.get(), capacity_);
+            if (end_ == 0)
+                return 0;
+        }
+        std::size_t n = std::min(size, end_ - pos_);
+        std::memcpy(data, buffer_.get() + pos_, n);
+        pos_ += n;
+        return n;
+    }
+
+    /// Read into a std::span<std::byte>.
+    std::size_t read(std::span<std::byte> data)
+    {
+        return read(reinterpret_cast<char*>(data.data()), data.size());
+    }
+
+    /// Read into a std::span<char>.
+    std::size_t read(std::span<char> data)
+    {
+        return read(data.data(), data.size());
+    }
+
+    /// Return true if the buffer is drained and the wrapped stream is at end-of-file.
+    [[nodiscard]] bool eof() const noexcept
+    {
+        return pos_ == end_ && vtable_->eof(storage_);
+    }
+
+    /// Number of bytes buffered but not yet returned by read().
+    [[nodiscard]] std::size_t buffered() const noexcept { return end_ - pos_; }
+
+private:
+    void reset() noexcept
+    {
+        if (vtable_)
+        {
+            vtable_->destroy(storage_);
+            vtable_ = nullptr;
+        }
+    }
+
+    const detail::InputStreamVTable* vtable_;
+    detail::AnyStorage               storage_;
+    std::unique_ptr<char[]>          buffer_;
+    std::size_t                      capacity_;
+    std::size_t                      pos_ = 0;
+    std::size_t                      end_ = 0;
+};
+
+static_assert(ReservableOutputStream<AnyOutputStream>);
+static_assert(InputStream<AnyInputStream>);
+
+} // namespace modern_io
@@ -91,6 +91,45 @@ public:
         write(data.data(), data.size());
     }
 
+    /// Write several buffers; large writes go to the sink in one vectored call if it has one.
+    void write_vectored(std::span<const std::span<const char>> parts)
+    {
+        std::size_t total = 0;
+        for (const auto& part : parts)
+            total += part.size();
+        if constexpr (VectoredOutputStream<S>)
+        {
+            if (total > BufSize - pos_)
+            {
+                flush_buffer();
+                if (total >= BufSize)
+                {
+                    sink_.write_vectored(parts);
+                    return;
+                }
+            }
+        }
+        for (const auto& part : parts)
+            write(part.data(), part.size());
+    }
+
+    /// Return at least n contiguous bytes of buffer space (flushing if needed), or an
+    /// empty span if n exceeds BufSize. Fill it and call commit().
+    [[nodiscard]] std::span<char> reserve(std::size_t n)
+    {
+        if (n > BufSize)
+            return {};
+        if (BufSize - pos_ < n)
+            flush_buffer();
+        return std::span<char>(buffer_.data() + pos_, BufSize - pos_);
+    }
+
+    /// Append the first n bytes of the span returned by reserve().
+    void commit(std::size_t n)
+    {
+        pos_ += n;
+    }
+
     /// Flush all remaining data.
     void flush()
     {
@@ -98,6 +137,17 @@ public:
         sink_.flush();
     }
 
+    /// Native handle of the wrapped stream; flush() before using it directly.
+    auto native_handle() const
+        requires NativeHandleStream<S>
+    {
+        return sink_.native_handle();
+    }
+
+    /// The wrapped stream.
+    S& next_layer() noexcept { return sink_; }
+    const S& next_layer() const noexcept { return sink_; }
+
     ~BufferedOutputStream() noexcept
     {
         try { flush(); } catch (...) {}
@@ -208,6 +258,17 @@ public:
         return (pos_ == end_) && source_.eof();
     }
 
+    /// Native handle of the wrapped stream; buffered bytes are not visible through it.
+    auto native_handle() const
+        requires NativeHandleStream<S>
+    {
+        return source_.native_handle();
+    }
+
+    /// The wrapped stream.
+    S& next_layer() noexcept { return source_; }
+    const S& next_layer() const noexcept { return source_; }
+
 private:
     S                  source_;
     std::vector<char>  buffer_;
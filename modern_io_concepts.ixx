@@ -16,6 +16,7 @@ module;
 #include <limits>
 #include <bit>
 #include <future>
+#include <system_error>
 #endif
 
 
@@ -36,6 +37,7 @@ import <utility>;
 import <limits>;
 import <bit>;
 import <future>;
+import <system_error>;
 #endif
 
 namespace modern_io
@@ -55,14 +57,48 @@ concept OutputStream = requires(S s, const char* ptr, std::size_t n, std::span<s
 
 /**
  * @brief InputStream concept for sources that can read bytes.
+ *
+ * eof() must be callable on a const stream: wrappers such as AnyInputStream query it
+ * from their own const eof().
  */
 export
 template<typename S>
-concept InputStream = requires(S s, char* ptr, std::size_t n, std::span<std::byte> bspan, std::span<char> cspan) {
+concept InputStream = requires(S s, const S& cs, char* ptr, std::size_t n, std::span<std::byte> bspan, std::span<char> cspan) {
     { s.read(ptr, n) } -> std::convertible_to<std::size_t>;
     { s.read(bspan) } -> std::convertible_to<std::size_t>;
     { s.read(cspan) } -> std::convertible_to<std::size_t>;
-    { s.eof() } -> std::same_as<bool>;
+    { cs.eof() } -> std::same_as<bool>;
+};
+
+/**
+ * @brief Output stream that lends out its buffer: reserve(n) returns a writable span of at
+ *        least n bytes (empty if it cannot), commit(k) appends the first k bytes of it.
+ *
+ * Serializers use it to encode values in place instead of copying through write().
+ */
+export
+template<typename S>
+concept ReservableOutputStream = OutputStream<S> && requires(S s, std::size_t n) {
+    { s.reserve(n) } -> std::same_as<std::span<char>>;
+    { s.commit(n) }  -> std::same_as<void>;
+};
+
+/**
+ * @brief Output stream that writes several buffers in one call (e.g. writev()).
+ */
+export
+template<typename S>
+concept VectoredOutputStream = OutputStream<S> && requires(S s, std::span<const std::span<const char>> parts) {
+    { s.write_vectored(parts) } -> std::same_as<void>;
+};
+
+/**
+ * @brief Stream backed by an OS handle, e.g. for fd passing or sendfile().
+ */
+export
+template<typename S>
+concept NativeHandleStream = requires(const S& s) {
+    s.native_handle();
 };
 
 export
@@ -84,4 +120,51 @@ concept AsyncInputStream = requires(S s, char* ptr, std::size_t n, std::span<std
 };
 
 
+/**
+ * @brief Callable that receives the result of an asynchronous operation.
+ *
+ * Handlers are taken by value and moved into the operation, so the stream can keep
+ * them in place instead of in a shared state as std::future does.
+ */
+export
+template<typename H, typename... Args>
+concept CompletionHandler = std::move_constructible<std::decay_t<H>> && std::invocable<std::decay_t<H>&, Args...>;
+
+// Handler types used to check the completion stream concepts.
+struct IoCompletionArchetype { void operator()(std::error_code, std::size_t) {} };
+struct FlushCompletionArchetype { void operator()(std::error_code) {} };
+
+/**
+ * @brief Output stream that reports completion to a handler instead of a future.
+ *
+ * write_async() calls the handler with (std::error_code, bytes written) once all bytes
+ * are written or an error occurred; flush_async() calls it with (std::error_code).
+ * The buffer must stay valid until the handler runs.
+ */
+export
+template<typename S>
+concept CompletionOutputStream = requires(S s, const char* ptr, std::size_t n, std::span<const std::byte> bspan, std::span<const char> cspan,
+                                          IoCompletionArchetype h, FlushCompletionArchetype fh) {
+    { s.write_async(ptr, n, h) }  -> std::same_as<void>;
+    { s.write_async(bspan, h) }   -> std::same_as<void>;
+    { s.write_async(cspan, h) }   -> std::same_as<void>;
+    { s.flush_async(fh) }         -> std::same_as<void>;
+};
+
+/**
+ * @brief Input stream that reports completion to a handler instead of a future.
+ *
+ * read_async() calls the handler with (std::error_code, bytes read); 0 bytes without an
+ * error means end of stream, after which eof() returns true.
+ */
+export
+template<typename S>
+concept CompletionInputStream = requires(S s, char* ptr, std::size_t n, std::span<std::byte> bspan, std::span<char> cspan,
+                                         IoCompletionArchetype h) {
+    { s.read_async(ptr, n, h) } -> std::same_as<void>;
+    { s.read_async(bspan, h) }  -> std::same_as<void>;
+    { s.read_async(cspan, h) }  -> std::same_as<void>;
+    { s.eof() }                 -> std::same_as<bool>;
+};
+
 } // namespace modern_io
\ No newline at end of file
@@ -91,7 +91,7 @@ public:
             buf[1] = std::byte((v >>  8) & 0xFF);
             buf[0] = std::byte((v      ) & 0xFF);
         }
-        sink_.write(std::span<const std::byte>(buf, 4));
+        put(buf, 4);
     }
 
     /// Write a uint32_t.
@@ -114,7 +114,7 @@ public:
             for (int i = 0; i < 8; ++i)
                 buf[7 - i] = std::byte((v >> (56 - 8 * i)) & 0xFF);
         }
-        sink_.write(std::span<const std::byte>(buf, 8));
+        put(buf, 8);
     }
 
     /// Write a uint64_t.
@@ -148,7 +148,27 @@ public:
         sink_.write(std::span<const char>(s.data(), s.size()));
     }
 
+    /// The wrapped stream.
+    S& next_layer() noexcept { return sink_; }
+    const S& next_layer() const noexcept { return sink_; }
+
 private:
+    // Encoded values go straight into the sink's buffer when it lends one out.
+    void put(const std::byte* data, std::size_t n)
+    {
+        if constexpr (ReservableOutputStream<S>)
+        {
+            std::span<char> space = sink_.reserve(n);
+            if (space.size() >= n)
+            {
+                std::memcpy(space.data(), data, n);
+                sink_.commit(n);
+                return;
+            }
+        }
+        sink_.write(std::span<const std::byte>(data, n));
+    }
+
     S             sink_;
     std::endian   order_;
 };
@@ -188,17 +208,16 @@ public:
     [[nodiscard]] std::vector<std::byte> read_bytes(std::size_t n)
     {
         std::vector<std::byte> buf(n);
-        std::size_t got = source_.read(std::span<std::byte>(buf.data(), n));
-        if (got != n)
-            throw std::runtime_error("Unexpected EOF");
+        read_exact(buf.data(), n);
         return buf;
     }
 
     /// Read an int32_t.
     [[nodiscard]] int32_t read_int32()
     {
-        auto buf = read_bytes(4);
-        auto ptr = reinterpret_cast<const uint8_t*>(buf.data());
+        std::byte buf[4];
+        read_exact(buf, 4);
+        auto ptr = reinterpret_cast<const uint8_t*>(buf);
         int32_t v = 0;
         if (order_ == std::endian::big)
         {
@@ -226,8 +245,9 @@ public:
     /// Read an int64_t.
     [[nodiscard]] int64_t read_int64()
     {
-        auto buf = read_bytes(8);
-        auto ptr = reinterpret_cast<const uint8_t*>(buf.data());
+        std::byte buf[8];
+        read_exact(buf, 8);
+        auto ptr = reinterpret_cast<const uint8_t*>(buf);
         int64_t v = 0;
         if (order_ == std::endian::big)
         {
@@ -272,8 +292,9 @@ public:
         int32_t len = read_int32();
         if (len < 0 || len > std::numeric_limits<int32_t>::max())
             throw std::runtime_error("Invalid string length");
-        auto buf = read_bytes(static_cast<std::size_t>(len));
-        return std::string(reinterpret_cast<char*>(buf.data()), buf.size());
+        std::string s(static_cast<std::size_t>(len), '\0');
+        read_exact(reinterpret_cast<std::byte*>(s.data()), s.size());
+        return s;
     }
 
     /// Return true if end-of-file is reached.
@@ -282,7 +303,24 @@ public:
         return source_.eof();
     }
 
+    /// The wrapped stream.
+    S& next_layer() noexcept { return source_; }
+    const S& next_layer() const noexcept { return source_; }
+
 private:
+    void read_exact(std::byte* data, std::size_t n)
+    {
+        std::size_t got = 0;
+        // Socket and buffered sources may return fewer bytes than requested.
+        while (got < n)
+        {
+            std::size_t r = source_.read(std::span<std::byte>(data + got, n - got));
+            if (r == 0)
+                throw std::runtime_error("Unexpected EOF");
+            got += r;
+        }
+    }
+
     S             source_;
     std::endian   order_;
 };
@@ -0,0 +1,411 @@
+// modern_io_pipeline.ixx
+module;
+
+#ifndef _MSC_VER
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#endif
+
+export module modern_io:pipeline;
+import :concepts;
+import :file;
+import :data;
+import :buffered;
+
+#ifdef _MSC_VER
+import <array>;
+import <bit>;
+import <concepts>;
+import <cstddef>;
+import <cstdint>;
+import <span>;
+import <string>;
+import <type_traits>;
+import <utility>;
+#endif
+
+namespace modern_io
+{
+
+// ------------------------------------------------------------------------
+// Crc32: CRC-32 (IEEE 802.3, as used by zlib/PNG)
+// ------------------------------------------------------------------------
+// Slicing-by-8 lookup tables for the reflected polynomial 0xEDB88320: table 0 is the
+// byte-wise table, table k advances a byte by k further positions.
+constexpr std::array<std::array<std::uint32_t, 256>, 8> make_crc32_tables() noexcept
+{
+    std::array<std::array<std::uint32_t, 256>, 8> tables{};
+    for (std::uint32_t i = 0; i < 256; ++i)
+    {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        tables[0][i] = c;
+    }
+    for (std::size_t t = 1; t < 8; ++t)
+        for (std::uint32_t i = 0; i < 256; ++i)
+            tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+    return tables;
+}
+
+inline constexpr std::array<std::array<std::uint32_t, 256>, 8> crc32_tables = make_crc32_tables();
+
+/**
+ * @brief Incremental CRC-32 over a byte sequence.
+ *
+ * Example:
+ * @code
+ * Crc32 crc;
+ * crc.update("123456789", 9);
+ * // crc.value() == 0xCBF43926
+ * @endcode
+ */
+export class Crc32
+{
+public:
+    /// Add size bytes to the checksum.
+    void update(const void* data, std::size_t size) noexcept
+    {
+        const auto& t = crc32_tables;
+        auto p = static_cast<const unsigned char*>(data);
+        std::uint32_t c = state_;
+        for (; size >= 8; size -= 8, p += 8)
+        {
+            std::uint32_t lo = c ^ (std::uint32_t(p[0]) | std::uint32_t(p[1]) << 8 |
+                                    std::uint32_t(p[2]) << 16 | std::uint32_t(p[3]) << 24);
+            c = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+                t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        }
+        if (size >= 4)
+        {
+            std::uint32_t lo = c ^ (std::uint32_t(p[0]) | std::uint32_t(p[1]) << 8 |
+                                    std::uint32_t(p[2]) << 16 | std::uint32_t(p[3]) << 24);
+            c = t[3][lo & 0xFF] ^ t[2][(lo >> 8) & 0xFF] ^ t[1][(lo >> 16) & 0xFF] ^ t[0][lo >> 24];
+            size -= 4;
+            p += 4;
+        }
+        for (; size > 0; --size, ++p)
+            c = t[0][(c ^ *p) & 0xFF] ^ (c >> 8);
+        state_ = c;
+    }
+
+    /// Checksum of the bytes added so far.
+    [[nodiscard]] std::uint32_t value() const noexcept
+    {
+        return state_ ^ 0xFFFFFFFFu;
+    }
+
+    /// Start over with an empty sequence.
+    void reset() noexcept
+    {
+        state_ = 0xFFFFFFFFu;
+    }
+
+private:
+    std::uint32_t state_ = 0xFFFFFFFFu;
+};
+
+// ------------------------------------------------------------------------
+// ChecksummedOutputStream<S> / ChecksummedInputStream<S>
+//   keep a running CRC-32 of the bytes passing through
+// ------------------------------------------------------------------------
+/**
+ * @brief Output stream wrapper that computes the CRC-32 of everything written.
+ *
+ * Passes reserve()/commit(), write_vectored() and native_handle() through when the
+ * wrapped stream has them, so a buffered layer below keeps its fast paths.
+ */
+export
+template<OutputStream S>
+class ChecksummedOutputStream
+{
+public:
+    /// Constructor with sink.
+    explicit ChecksummedOutputStream(S sink)
+      : sink_(std::move(sink))
+    {}
+
+    ChecksummedOutputStream(ChecksummedOutputStream&&) noexcept = default;
+    ChecksummedOutputStream& operator=(ChecksummedOutputStream&&) noexcept = default;
+    ChecksummedOutputStream(const ChecksummedOutputStream&) = delete;
+    ChecksummedOutputStream& operator=(const ChecksummedOutputStream&) = delete;
+
+    /// Write n bytes from data.
+    void write(const char* data, std::size_t size)
+    {
+        crc_.update(data, size);
+        sink_.write(data, size);
+    }
+
+    /// Write a std::span<std::byte>.
+    void write(std::span<const std::byte> data)
+    {
+        write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    /// Write a std::span<char>.
+    void write(std::span<const char> data)
+    {
+        write(data.data(), data.size());
+    }
+
+    /// Write several buffers in one call of the wrapped stream.
+    void write_vectored(std::span<const std::span<const char>> parts)
+        requires VectoredOutputStream<S>
+    {
+        for (const auto& part : parts)
+            crc_.update(part.data(), part.size());
+        sink_.write_vectored(parts);
+    }
+
+    /// Reserve buffer space in the wrapped stream (see ReservableOutputStream).
+    [[nodiscard]] std::span<char> reserve(std::size_t n)
+        requires ReservableOutputStream<S>
+    {
+        std::span<char> space = sink_.reserve(n);
+        reserved_ = space.data();
+        return space;
+    }
+
+    /// Commit n reserved bytes and add them to the checksum.
+    void commit(std::size_t n)
+        requires ReservableOutputStream<S>
+    {
+        crc_.update(reserved_, n);
+        sink_.commit(n);
+    }
+
+    /// Flush the wrapped stream.
+    void flush()
+    {
+        sink_.flush();
+    }
+
+    /// CRC-32 of the bytes written since construction or reset_checksum().
+    [[nodiscard]] std::uint32_t checksum() const noexcept { return crc_.value(); }
+
+    void reset_checksum() noexcept { crc_.reset(); }
+
+    /// Native handle of the wrapped stream; bytes written through it are not checksummed.
+    auto native_handle() const
+        requires NativeHandleStream<S>
+    {
+        return sink_.native_handle();
+    }
+
+    /// The wrapped stream.
+    S& next_layer() noexcept { return sink_; }
+    const S& next_layer() const noexcept { return sink_; }
+
+private:
+    S      sink_;
+    Crc32  crc_;
+    char*  reserved_ = nullptr;
+};
+
+/**
+ * @brief Input stream wrapper that computes the CRC-32 of everything read.
+ */
+export
+template<InputStream S>
+class ChecksummedInputStream
+{
+public:
+    /// Constructor with source.
+    explicit ChecksummedInputStream(S source)
+      : source_(std::move(source))
+    {}
+
+    ChecksummedInputStream(ChecksummedInputStream&&) noexcept = default;
+    ChecksummedInputStream& operator=(ChecksummedInputStream&&) noexcept = default;
+    ChecksummedInputStream(const ChecksummedInputStream&) = delete;
+    ChecksummedInputStream& operator=(const ChecksummedInputStream&) = delete;
+
+    /// Read up to size bytes into data, return the number of bytes read.
+    std::size_t read(char* data, std::size_t size)
+    {
+        std::size_t n = source_.read(data, size);
+        crc_.update(data, n);
+        return n;
+    }
+
+    /// Read into a std::span<std::byte>.
+    std::size_t read(std::span<std::byte> data)
+    {
+        return read(reinterpret_cast<char*>(data.data()), data.size());
+    }
+
+    /// Read into a std::span<char>.
+    std::size_t read(std::span<char> data)
+    {
+        return read(data.data(), data.size());
+    }
+
+    /// Return true if end-of-file is reached.
+    [[nodiscard]] bool eof() const noexcept
+    {
+        return source_.eof();
+    }
+
+    /// CRC-32 of the bytes read since construction or reset_checksum().
+    [[nodiscard]] std::uint32_t checksum() const noexcept { return crc_.value(); }
+
+    void reset_checksum() noexcept { crc_.reset(); }
+
+    /// Native handle of the wrapped stream.
+    auto native_handle() const
+        requires NativeHandleStream<S>
+    {
+        return source_.native_handle();
+    }
+
+    /// The wrapped stream.
+    S& next_layer() noexcept { return source_; }
+    const S& next_layer() const noexcept { return source_; }
+
+private:
+    S      source_;
+    Crc32  crc_;
+};
+
+template<typename Stream>
+ChecksummedOutputStream(Stream&&) -> ChecksummedOutputStream<std::decay_t<Stream>>;
+
+template<typename Stream>
+ChecksummedInputStream(Stream&&) -> ChecksummedInputStream<std::decay_t<Stream>>;
+
+// ------------------------------------------------------------------------
+// Pipeline builder: stream | layer | layer ...
+// ------------------------------------------------------------------------
+/**
+ * @brief Base of the pipeline layers accepted by operator|.
+ *
+ * A layer is a const callable that takes a stream by value and returns the wrapped
+ * stream. Custom layers derive from pipeline_layer to take part in composition.
+ */
+export struct pipeline_layer {};
+
+/// Wraps a stream with BufferedOutputStream/BufferedInputStream of N bytes.
+export
+template<std::size_t N>
+struct buffered_layer : pipeline_layer
+{
+    template<typename S>
+        requires OutputStream<std::decay_t<S>> || InputStream<std::decay_t<S>>
+    auto operator()(S&& stream) const
+    {
+        if constexpr (OutputStream<std::decay_t<S>>)
+            return BufferedOutputStream<std::decay_t<S>, N>(std::forward<S>(stream));
+        else
+            return BufferedInputStream<std::decay_t<S>, N>(std::forward<S>(stream));
+    }
+};
+
+/// Wraps a stream with ChecksummedOutputStream/ChecksummedInputStream.
+export struct checksummed_layer : pipeline_layer
+{
+    template<typename S>
+        requires OutputStream<std::decay_t<S>> || InputStream<std::decay_t<S>>
+    auto operator()(S&& stream) const
+    {
+        if constexpr (OutputStream<std::decay_t<S>>)
+            return ChecksummedOutputStream<std::decay_t<S>>(std::forward<S>(stream));
+        else
+            return ChecksummedInputStream<std::decay_t<S>>(std::forward<S>(stream));
+    }
+};
+
+/// Terminates a pipeline with DataOutputStream/DataInputStream in the given byte order.
+export
+template<std::endian Order>
+struct data_layer : pipeline_layer
+{
+    template<typename S>
+        requires OutputStream<std::decay_t<S>> || InputStream<std::decay_t<S>>
+    auto operator()(S&& stream) const
+    {
+        if constexpr (OutputStream<std::decay_t<S>>)
+            return DataOutputStream<std::decay_t<S>>(std::forward<S>(stream), Order);
+        else
+            return DataInputStream<std::decay_t<S>>(std::forward<S>(stream), Order);
+    }
+};
+
+export template<std::size_t N = 8192>
+inline constexpr buffered_layer<N> buffered{};
+
+export inline constexpr checksummed_layer checksummed{};
+
+export template<std::endian Order = std::endian::big>
+inline constexpr data_layer<Order> data{};
+
+/**
+ * @brief Compose a stream with a layer at compile time.
+ *
+ * Each layer wraps the stream by value, so the result is one concrete type such as
+ * DataOutputStream<ChecksummedOutputStream<BufferedOutputStream<FileOutputStream, 65536>>>.
+ * Capabilities (reserve/commit, write_vectored, native_handle) of inner layers stay
+ * visible through the outer ones. Streams that are both input and output are wrapped
+ * as output streams.
+ *
+ * Example:
+ * @code
+ * using namespace modern_io::literals;
+ * auto out = file_out("x.bin") | buffered<64_KiB> | checksummed | data<std::endian::big>;
+ * out.write_int32(42);
+ * out.flush();
+ * std::uint32_t crc = out.next_layer().checksum();
+ * @endcode
+ */
+export
+template<typename S, typename Layer>
+    requires std::derived_from<Layer, pipeline_layer> && std::invocable<const Layer&, S>
+auto operator|(S&& stream, const Layer& layer)
+{
+    return layer(std::forward<S>(stream));
+}
+
+/// Pipeline source: a file opened for writing.
+export inline FileOutputStream file_out(const std::string& path)
+{
+    return FileOutputStream(path);
+}
+
+/// Pipeline source: a file opened for reading.
+export inline FileInputStream file_in(const std::string& path)
+{
+    return FileInputStream(path);
+}
+
+/**
+ * @brief The innermost stream of a layered stream, found through next_layer().
+ */
+export
+template<typename S>
+decltype(auto) lowest_layer(S& stream) noexcept
+{
+    if constexpr (requires { stream.next_layer(); })
+        return lowest_layer(stream.next_layer());
+    else
+        return (stream);
+}
+
+/// Byte-size literals for buffer sizes, e.g. buffered<64_KiB>.
+export namespace literals
+{
+    constexpr std::size_t operator""_KiB(unsigned long long n) noexcept { return static_cast<std::size_t>(n) * 1024; }
+    constexpr std::size_t operator""_MiB(unsigned long long n) noexcept { return static_cast<std::size_t>(n) * 1024 * 1024; }
+}
+
+static_assert(ReservableOutputStream<ChecksummedOutputStream<BufferedOutputStream<FileOutputStream>>>);
+static_assert(VectoredOutputStream<ChecksummedOutputStream<BufferedOutputStream<FileOutputStream>>>);
+static_assert(InputStream<ChecksummedInputStream<BufferedInputStream<FileInputStream>>>);
+
+} // namespace modern_io
@@ -4,17 +4,43 @@ export module net_io;
 
 import net_io_base;
 import net_io_concepts;
+import net_io.log;
 export import net_io_base;
 export import net_io_concepts;
+export import net_io.log;
 
+import net_io.resolver;
 import net_io.tcp_endpoint;
 import net_io.tcp_client;
 import net_io.tcp_server;
+import net_io.tcp_forwarder;
 import net_io.udp_endpoint;
 import net_io.udp_transport;
+import net_io.unix_endpoint;
+import net_io.unix_client;
+import net_io.unix_server;
+import net_io.shm_transport;
+import net_io.memory_pipe;
+import net_io.write_queue;
+import net_io.task;
+import net_io.timer_wheel;
+import net_io.event_loop;
+import net_io.async_stream;
 
+export import net_io.resolver;
 export import net_io.tcp_endpoint;
 export import net_io.tcp_client;
 export import net_io.tcp_server;
+export import net_io.tcp_forwarder;
 export import net_io.udp_endpoint;
 export import net_io.udp_transport;
+export import net_io.unix_endpoint;
+export import net_io.unix_client;
+export import net_io.unix_server;
+export import net_io.shm_transport;
+export import net_io.memory_pipe;
+export import net_io.write_queue;
+export import net_io.task;
+export import net_io.timer_wheel;
+export import net_io.event_loop;
+export import net_io.async_stream;
@@ -3,6 +3,12 @@ module;
 #include <optional>
 #include <mutex>
 #include <functional>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <system_error>
 
 // Platform-specific includes for sockaddr_storage and socklen_t
 #if defined(_WIN32)
@@ -28,7 +34,6 @@ module;
 #include <utility>
 #include <limits>
 #include <bit>
-#include <iostream>
 #include <memory>
 #include <thread>
 #endif
@@ -51,7 +56,6 @@ import <type_traits>;
 import <utility>;
 import <limits>;
 import <bit>;
-import <iostream>;
 #endif
 
 import modern_io;   // Provides modern_io::OutputStream and modern_io::InputStream interfaces.
@@ -63,8 +67,18 @@ import net_io.tcp_client;
 import net_io.tcp_server;
 import net_io.udp_endpoint;
 import net_io.udp_transport;
+import net_io.unix_endpoint;
+import net_io.unix_client;
+import net_io.unix_server;
+import net_io.shm_transport;
+import net_io.memory_pipe;
+import net_io.async_stream;
+import net_io.log;
 import net_io_concepts; // Imports network transport concepts for constraints.
 
+import net_io_adapters.executors;
+export import net_io_adapters.executors; // Executor concept, ThreadExecutor, ThreadPoolExecutor
+
 export namespace net_io_adapters
 {
 
@@ -258,6 +272,359 @@ export namespace net_io_adapters
         std::shared_ptr<T> t_; ///< shared_ptr statt Referenz!
     };
 
+    /**
+     * @brief Buffer sizes of the streams created by make_stream() and the server stream builders.
+     *
+     * A size of 0 disables that direction's buffer (raw mode: every write() and read()
+     * goes straight to the transport). See raw_stream.
+     */
+    struct StreamBufferOptions
+    {
+        std::size_t read_buffer = 16 * 1024;  ///< Receive buffer; reads are served from it.
+        std::size_t write_buffer = 16 * 1024; ///< Send buffer; writes are coalesced until flush().
+    };
+
+    /// Unbuffered streams: each write() and read() is one transport call.
+    inline constexpr StreamBufferOptions raw_stream{ 0, 0 };
+
+    namespace detail
+    {
+        /**
+         * @brief Send buffer of BufferedTransportSink and DuplexStream.
+         *
+         * Holds only the buffer state; each call takes the transport from its owner, so
+         * the shared_ptr sink and the by-value DuplexStream share one implementation.
+         */
+        class StreamWriteBuffer
+        {
+        public:
+            explicit StreamWriteBuffer(std::size_t capacity) noexcept
+                : capacity_(capacity)
+            {
+            }
+
+            StreamWriteBuffer(StreamWriteBuffer&& other) noexcept
+                : buffer_(std::move(other.buffer_)), capacity_(other.capacity_), pos_(std::exchange(other.pos_, 0))
+            {
+            }
+
+            StreamWriteBuffer& operator=(StreamWriteBuffer&& other) noexcept
+            {
+                buffer_ = std::move(other.buffer_);
+                capacity_ = other.capacity_;
+                pos_ = std::exchange(other.pos_, 0);
+                return *this;
+            }
+
+            template<typename T>
+            void write(T& t, const char* data, std::size_t size)
+            {
+                if (size == 0)
+                    return;
+                if (pos_ + size > capacity_)
+                {
+                    flush(t);
+                    if (size >= capacity_)
+                    {
+                        t.write(data, size);
+                        return;
+                    }
+                }
+                std::memcpy(space() + pos_, data, size);
+                pos_ += size;
+            }
+
+            /// Small gathers are copied into the buffer; otherwise the buffered bytes and
+            /// the parts leave in one gathered transport write.
+            template<typename T>
+            void write_vectored(T& t, std::span<const std::span<const char>> parts)
+            {
+                std::size_t total = 0;
+                for (const auto& part : parts)
+                    total += part.size();
+                if (pos_ + total <= capacity_)
+                {
+                    if (total == 0)
+                        return;
+                    char* buffer = space();
+                    for (const auto& part : parts)
+                    {
+                        std::memcpy(buffer + pos_, part.data(), part.size());
+                        pos_ += part.size();
+                    }
+                    return;
+                }
+                if (pos_ == 0)
+                {
+                    t.write_vectored(parts);
+                    return;
+                }
+                constexpr std::size_t max_inline = 16;
+                if (parts.size() >= max_inline)
+                {
+                    flush(t);
+                    t.write_vectored(parts);
+                    return;
+                }
+                std::span<const char> gathered[max_inline];
+                gathered[0] = std::span<const char>(buffer_.get(), pos_);
+                for (std::size_t i = 0; i < parts.size(); ++i)
+                    gathered[i + 1] = parts[i];
+                pos_ = 0;
+                t.write_vectored(std::span<const std::span<const char>>(gathered, parts.size() + 1));
+            }
+
+            /// Returns at least n bytes of buffer space (flushing if needed), or an empty span
+            /// if n exceeds the buffer size.
+            template<typename T>
+            std::span<char> reserve(T& t, std::size_t n)
+            {
+                if (n > capacity_)
+                    return {};
+                if (capacity_ - pos_ < n)
+                    flush(t);
+                return std::span<char>(space() + pos_, capacity_ - pos_);
+            }
+
+            void commit(std::size_t n) noexcept { pos_ += n; }
+
+            /// Send the buffered bytes in one transport write.
+            template<typename T>
+            void flush(T& t)
+            {
+                if (pos_ > 0)
+                {
+                    std::size_t n = std::exchange(pos_, 0);
+                    t.write(buffer_.get(), n);
+                }
+            }
+
+            std::size_t buffered() const noexcept { return pos_; }
+
+        private:
+            char* space()
+            {
+                if (!buffer_)
+                    buffer_ = std::make_unique<char[]>(capacity_);
+                return buffer_.get();
+            }
+
+            std::unique_ptr<char[]> buffer_; // allocated on the first buffered write
+            std::size_t capacity_;
+            std::size_t pos_ = 0;
+        };
+
+        /**
+         * @brief Receive buffer of BufferedTransportSource and DuplexStream.
+         *
+         * Like StreamWriteBuffer, each read() takes the transport from its owner.
+         */
+        class StreamReadBuffer
+        {
+        public:
+            explicit StreamReadBuffer(std::size_t capacity) noexcept
+                : capacity_(capacity)
+            {
+            }
+
+            StreamReadBuffer(StreamReadBuffer&& other) noexcept
+                : buffer_(std::move(other.buffer_)), capacity_(other.capacity_)
+                , pos_(std::exchange(other.pos_, 0)), end_(std::exchange(other.end_, 0)), eof_(other.eof_)
+            {
+            }
+
+            StreamReadBuffer& operator=(StreamReadBuffer&& other) noexcept
+            {
+                buffer_ = std::move(other.buffer_);
+                capacity_ = other.capacity_;
+                pos_ = std::exchange(other.pos_, 0);
+                end_ = std::exchange(other.end_, 0);
+                eof_ = other.eof_;
+                return *this;
+            }
+
+            template<typename T>
+            std::size_t read(T& t, char* data, std::size_t size)
+            {
+                if (pos_ == end_)
+                {
+                    if (size == 0)
+                        return 0;
+                    if (size >= capacity_)
+                        return fill(t, data, size);
+                    if (!buffer_)
+                        buffer_ = std::make_unique<char[]>(capacity_);
+                    pos_ = 0;
+                    end_ = fill(t, buffer_.get(), capacity_);
+                    if (end_ == 0)
+                        return 0;
+                }
+                std::size_t n = std::min(size, end_ - pos_);
+                std::memcpy(data, buffer_.get() + pos_, n);
+                pos_ += n;
+                return n;
+            }
+
+            bool eof() const noexcept { return eof_ && pos_ == end_; }
+
+            std::size_t buffered() const noexcept { return end_ - pos_; }
+
+        private:
+            template<typename T>
+            std::size_t fill(T& t, char* data, std::size_t size)
+            {
+                std::size_t n = t.read(data, size);
+                if (n == 0)
+                    eof_ = true;
+                return n;
+            }
+
+            std::unique_ptr<char[]> buffer_; // allocated on the first buffered read
+            std::size_t capacity_;
+            std::size_t pos_ = 0;
+            std::size_t end_ = 0;
+            bool eof_ = false;
+        };
+    }
+
+    /**
+     * @brief TransportSink that coalesces writes in a userland buffer until flush().
+     *
+     * Writes that do not fit into the remaining space flush the buffer first; writes at
+     * least as large as the buffer go to the transport directly. The buffer is allocated
+     * on the first buffered write and flushed (errors ignored) on destruction. With a
+     * capacity of 0 it behaves like TransportSink.
+     *
+     * Example:
+     * @code
+     * BufferedTransportSink<net_io::TcpClient> sink(client, 16 * 1024);
+     * sink.write("PING", 4);
+     * sink.flush(); // one send()
+     * @endcode
+     */
+    template<net_io_concepts::Writable T>
+    class BufferedTransportSink
+    {
+    public:
+        explicit BufferedTransportSink(std::shared_ptr<T> t, std::size_t capacity = StreamBufferOptions{}.write_buffer) noexcept
+            : t_(std::move(t)), out_(capacity)
+        {
+        }
+
+        BufferedTransportSink(BufferedTransportSink&& other) noexcept
+            : t_(std::move(other.t_)), out_(std::move(other.out_))
+        {
+        }
+
+        BufferedTransportSink& operator=(BufferedTransportSink&&) = delete;
+        BufferedTransportSink(const BufferedTransportSink&) = delete;
+        BufferedTransportSink& operator=(const BufferedTransportSink&) = delete;
+
+        ~BufferedTransportSink()
+        {
+            try { flush_buffer(); } catch (...) {}
+        }
+
+        void write(const char* data, std::size_t size)
+        {
+            out_.write(*t_, data, size);
+        }
+        void write(std::span<const std::byte> data)
+        {
+            write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+        void write(std::span<const char> data)
+        {
+            write(data.data(), data.size());
+        }
+
+        /// Send the buffered bytes in one transport write.
+        void flush()
+        {
+            flush_buffer();
+        }
+
+        /// Returns the number of bytes waiting for flush().
+        std::size_t buffered() const noexcept { return out_.buffered(); }
+
+        template<typename U = T, typename... Args>
+        auto write_to(Args&&... args)
+            -> decltype(std::declval<U&>().write_to(std::forward<Args>(args)...))
+        {
+            return t_->write_to(std::forward<Args>(args)...);
+        }
+
+        std::shared_ptr<T>& underlying() noexcept { return t_; }
+        const std::shared_ptr<T>& underlying() const noexcept { return t_; }
+
+    private:
+        void flush_buffer()
+        {
+            if (out_.buffered() > 0)
+                out_.flush(*t_);
+        }
+
+        std::shared_ptr<T> t_;
+        detail::StreamWriteBuffer out_;
+    };
+
+    /**
+     * @brief TransportSource that serves reads from a receive buffer.
+     *
+     * An empty buffer is refilled with a single transport read of up to capacity bytes,
+     * so many small reads (a length prefix, then the payload) cost one recv(). A read
+     * returns what is buffered without waiting for more, like a socket read; reads at
+     * least as large as the buffer bypass it when it is empty. With a capacity of 0 it
+     * behaves like TransportSource.
+     */
+    template<net_io_concepts::Readable T>
+    class BufferedTransportSource
+    {
+    public:
+        explicit BufferedTransportSource(std::shared_ptr<T> t, std::size_t capacity = StreamBufferOptions{}.read_buffer) noexcept
+            : t_(std::move(t)), in_(capacity)
+        {
+        }
+
+        BufferedTransportSource(BufferedTransportSource&& other) noexcept
+            : t_(std::move(other.t_)), in_(std::move(other.in_))
+        {
+        }
+
+        BufferedTransportSource& operator=(BufferedTransportSource&&) = delete;
+        BufferedTransportSource(const BufferedTransportSource&) = delete;
+        BufferedTransportSource& operator=(const BufferedTransportSource&) = delete;
+
+        std::size_t read(char* data, std::size_t size)
+        {
+            return in_.read(*t_, data, size);
+        }
+        std::size_t read(std::span<std::byte> data)
+        {
+            return read(reinterpret_cast<char*>(data.data()), data.size());
+        }
+        std::size_t read(std::span<char> data)
+        {
+            return read(data.data(), data.size());
+        }
+
+        /// Returns true once the transport reported end of stream and the buffer is drained.
+        bool eof() const noexcept
+        {
+            return in_.eof();
+        }
+
+        /// Returns the number of received bytes not yet returned by read().
+        std::size_t buffered() const noexcept { return in_.buffered(); }
+
+        std::shared_ptr<T>& underlying() noexcept { return t_; }
+        const std::shared_ptr<T>& underlying() const noexcept { return t_; }
+
+    private:
+        std::shared_ptr<T> t_;
+        detail::StreamReadBuffer in_;
+    };
+
     // Adapter for UDP datagram output, buffers until flush
     template<net_io_concepts::Writable T> // <--- angepasst
     class DatagramSink
@@ -589,7 +956,7 @@ export namespace net_io_adapters
         auto native_handle() const
         {
             // Assumption: Source is TransportSource<TcpClient>
-            return src_.underlying().native_handle();
+            return src_.underlying()->native_handle();
         }
 
     private:
@@ -687,6 +1054,13 @@ export namespace net_io_adapters
             return ptr_->get_peer(std::forward<Args>(args)...);
         }
 
+        // Native socket handle, e.g. for TcpForwarder (only if available)
+        auto native_handle() const
+            requires requires(const T& t) { t.native_handle(); }
+        {
+            return ptr_->native_handle();
+        }
+
         // Access to the shared object
         std::shared_ptr<T>& get() noexcept 
         { 
@@ -762,30 +1136,89 @@ export namespace net_io_adapters
         }
         && (!UdpEndpointLike<T>);
 
+    /**
+     * @brief Concept for types that behave like a Unix domain socket endpoint.
+     *
+     * A type satisfies UnixEndpointLike if it provides the following members:
+     *   - path: convertible to std::string (filesystem path or '@'-prefixed abstract name)
+     *   - type: convertible to net_io::UnixSocketType (stream or seqpacket)
+     *
+     * Example:
+     * @code
+     * static_assert(UnixEndpointLike<net_io::UnixEndpoint>);
+     * @endcode
+     */
+    template<typename T>
+    concept UnixEndpointLike = requires(T ep)
+    {
+        { ep.path } -> std::convertible_to<std::string>;
+        { ep.type } -> std::convertible_to<net_io::UnixSocketType>;
+    };
+
+    /// True for std::shared_ptr specializations (selects the shared-ownership branch of make_stream).
+    template<typename T>
+    inline constexpr bool is_shared_ptr_v = false;
+    template<typename T>
+    inline constexpr bool is_shared_ptr_v<std::shared_ptr<T>> = true;
+
+    /**
+     * @brief Wraps an open connection-oriented transport into a (buffered) SharedStream.
+     * @param transport The transport, shared by the source and sink.
+     * @param buffers Buffer sizes; raw_stream for unbuffered reads and writes.
+     */
+    template<typename T>
+    auto make_buffered_stream(std::shared_ptr<T> transport, StreamBufferOptions buffers = {})
+    {
+        auto src  = BufferedTransportSource<T>(transport, buffers.read_buffer);
+        auto sink = BufferedTransportSink<T>(transport, buffers.write_buffer);
+        using DuplexType = TcpDuplexStream<decltype(src), decltype(sink)>;
+        auto duplex = std::make_shared<DuplexType>(std::move(src), std::move(sink));
+        return SharedStream<DuplexType>(duplex);
+    }
+
     // --- Generische Factory für beliebige Transporttypen (Client) ---
     /**
      * @brief Erzeugt einen SharedStream für beliebige Transporttypen.
      *        Die Factory erkennt TCP/UDP/sonstige Transports automatisch.
      *        Die Rückgabe ist immer ein SharedStream, der InputStream/OutputStream erfüllt.
+     * @param buffers Buffer sizes for connection-oriented transports (see StreamBufferOptions).
+     *
+     * Connection-oriented streams are buffered: writes are coalesced until flush() and
+     * reads are served from a receive buffer, so DataOutputStream::write_string() plus
+     * flush() is one send() and DataInputStream::read_string() usually one recv(). Pass
+     * raw_stream for unbuffered streams. Unix SeqPacket endpoints are never write-buffered
+     * (that would merge records); UDP endpoints keep their datagram adapters.
      *
      * Beispiel:
      *   auto stream = make_stream(TcpEndpoint{...});
+     *   auto stream = make_stream(TcpEndpoint{...}, {64 * 1024, 4 * 1024});
+     *   auto stream = make_stream(TcpEndpoint{...}, raw_stream);
      *   auto stream = make_stream(UdpEndpoint{...});
+     *   auto stream = make_stream(UnixEndpoint{"/run/app.sock"});
+     *   auto stream = make_stream(MemoryPipeEndpoint{"bench"});
      *   auto stream = make_stream(std::make_shared<MyTransport>(...));
      */
     template<typename EndpointOrTransport>
-    auto make_stream(EndpointOrTransport&& ep_or_transport)
+    auto make_stream(EndpointOrTransport&& ep_or_transport, StreamBufferOptions buffers = {})
     {
         using T = std::decay_t<EndpointOrTransport>;
         if constexpr (TcpEndpointLike<T>) {
             // TCP Endpoint: Erzeuge TcpClient, öffne Verbindung, adaptiere
             auto client = std::make_shared<net_io::TcpClient>(std::forward<EndpointOrTransport>(ep_or_transport));
             client->open();
-            auto src  = TransportSource<net_io::TcpClient>(client);
-            auto sink = TransportSink<net_io::TcpClient>(client);
-            using DuplexType = TcpDuplexStream<decltype(src), decltype(sink)>;
-            auto duplex = std::make_shared<DuplexType>(std::move(src), std::move(sink));
-            return SharedStream<DuplexType>(duplex);
+            return make_buffered_stream(std::move(client), buffers);
+        } else if constexpr (UnixEndpointLike<T>) {
+            // Unix endpoint: connect a UnixClient and adapt it like a TCP connection
+            auto client = std::make_shared<net_io::UnixClient>(net_io::UnixEndpoint(ep_or_transport.path, ep_or_transport.type));
+            client->open();
+            if (ep_or_transport.type != net_io::UnixSocketType::Stream)
+                buffers.write_buffer = 0; // one write() per record
+            return make_buffered_stream(std::move(client), buffers);
+        } else if constexpr (std::same_as<T, net_io::MemoryPipeEndpoint>) {
+            // In-process endpoint: connect to the named MemoryPipeServer
+            auto pipe = std::make_shared<net_io::MemoryPipeTransport>(std::forward<EndpointOrTransport>(ep_or_transport));
+            pipe->open();
+            return make_buffered_stream(std::move(pipe), buffers);
         } else if constexpr (UdpEndpointLike<T>) {
             // UDP Endpoint: Erzeuge UdpTransport, öffne Verbindung, adaptiere
             auto udp = std::make_shared<net_io::UdpTransport>();
@@ -804,112 +1237,769 @@ export namespace net_io_adapters
             using DuplexType = DuplexDatagramStream<decltype(src), decltype(sink)>;
             auto duplex = std::make_shared<DuplexType>(std::move(src), std::move(sink));
             return SharedStream<DuplexType>(duplex);
-        } else if constexpr (std::is_pointer_v<T> ||
-                             std::is_same_v<T, std::shared_ptr<std::decay_t<decltype(*ep_or_transport)>>>)
+        } else if constexpr (std::is_pointer_v<T> || is_shared_ptr_v<T>)
         {
             // Für shared_ptr<T> oder T* (z.B. eigene Transportklassen)
-            using U = std::remove_pointer_t<T>;
-            std::shared_ptr<U> ptr = std::is_pointer_v<T> ? std::shared_ptr<U>(ep_or_transport) : ep_or_transport;
-            auto src  = TransportSource<U>(ptr);
-            auto sink = TransportSink<U>(ptr);
-            using DuplexType = TcpDuplexStream<decltype(src), decltype(sink)>;
-            auto duplex = std::make_shared<DuplexType>(std::move(src), std::move(sink));
-            return SharedStream<DuplexType>(duplex);
+            using U = typename std::pointer_traits<T>::element_type;
+            std::shared_ptr<U> ptr;
+            if constexpr (std::is_pointer_v<T>)
+                ptr.reset(ep_or_transport); // takes ownership of the raw pointer
+            else
+                ptr = std::forward<EndpointOrTransport>(ep_or_transport);
+            return make_buffered_stream(std::move(ptr), buffers);
         } else {
             // Für beliebige Transport-Objekte (by value/ref)
             auto obj = std::make_shared<T>(std::forward<EndpointOrTransport>(ep_or_transport));
-            auto src  = TransportSource<T>(obj);
-            auto sink = TransportSink<T>(obj);
-            using DuplexType = TcpDuplexStream<decltype(src), decltype(sink)>;
-            auto duplex = std::make_shared<DuplexType>(std::move(src), std::move(sink));
-            return SharedStream<DuplexType>(duplex);
+            return make_buffered_stream(std::move(obj), buffers);
         }
     }
 
-    // --- Convenience StreamBuilder for TCP ---
+    // ------------------------------------------------------------------------
+    // DuplexStream<Transport>: buffered duplex stream that owns its transport
+    // ------------------------------------------------------------------------
     /**
-     * @brief Convenience StreamBuilder for TCP: creates a SharedStream with keepalive.
-     * @param client shared_ptr to TcpClient
-     * @param server shared_ptr to TcpServer
-     * @return SharedStream with keepalive for both server and client
+     * @brief Non-owning InputStream view of a stream (see DuplexStream::reader()).
+     *
+     * Holds a pointer only, so copying it into a DataInputStream costs nothing. The
+     * viewed stream must outlive the view.
      */
-    inline auto tcp_stream_builder(
-        std::shared_ptr<net_io::TcpClient> client,
-        std::shared_ptr<net_io::TcpServer> server)
+    template<typename Stream>
+    class StreamReader
     {
-        auto src  = TransportSource<net_io::TcpClient>(client);
-        auto sink = TransportSink<net_io::TcpClient>(client);
-        using DuplexType = TcpDuplexStream<decltype(src), decltype(sink)>;
-        struct DuplexWithKeepalive : DuplexType {
-            std::shared_ptr<net_io::TcpServer> keepalive_server_;
-            std::shared_ptr<net_io::TcpClient> keepalive_client_;
-            DuplexWithKeepalive(DuplexType&& base,
-                               std::shared_ptr<net_io::TcpServer> s,
-                               std::shared_ptr<net_io::TcpClient> c)
-                : DuplexType(std::move(base)), keepalive_server_(std::move(s)), keepalive_client_(std::move(c)) {}
-        };
-        auto duplex = std::make_shared<DuplexWithKeepalive>(
-            DuplexType(std::move(src), std::move(sink)), server, client
-        );
-        return SharedStream<DuplexWithKeepalive>(duplex);
-    }
+    public:
+        explicit StreamReader(Stream& stream) noexcept
+            : stream_(&stream)
+        {
+        }
 
-    // --- Executor concept und Beispiel-Executor ---
-    /**
-     * @brief Concept for Executor: Must support execute(std::function<void()>).
-     */
-    template<typename E>
-    concept Executor = requires(E e, std::function<void()> f) {
-        { e.execute(std::move(f)) };
+        std::size_t read(char* data, std::size_t size)
+        {
+            return stream_->read(data, size);
+        }
+        std::size_t read(std::span<std::byte> data)
+        {
+            return stream_->read(reinterpret_cast<char*>(data.data()), data.size());
+        }
+        std::size_t read(std::span<char> data)
+        {
+            return stream_->read(data.data(), data.size());
+        }
+        bool eof() const noexcept
+        {
+            return stream_->eof();
+        }
+
+        auto native_handle() const
+            requires requires(const Stream& s) { s.native_handle(); }
+        {
+            return stream_->native_handle();
+        }
+
+    private:
+        Stream* stream_;
     };
 
     /**
-     * @brief Simple executor that starts a new thread for each task.
+     * @brief Non-owning OutputStream view of a stream (see DuplexStream::writer()).
+     *
+     * Holds a pointer only; the viewed stream must outlive the view.
      */
-    class ThreadExecutor {
+    template<typename Stream>
+    class StreamWriter
+    {
     public:
-        void execute(std::function<void()> f) {
-            std::thread(std::move(f)).detach();
+        explicit StreamWriter(Stream& stream) noexcept
+            : stream_(&stream)
+        {
         }
-    };
 
-    /**
-     * @brief Generic server factory that submits a task to the executor for each new connection.
-     *        Die Callback- und StreamBuilder-Parameter stehen jetzt vorne, damit Template-Deduktion funktioniert.
-     */
-    template<
-        typename Callback,
-        typename StreamBuilder,
-        net_io_concepts::Acceptable ServerType,
+        void write(const char* data, std::size_t size)
+        {
+            stream_->write(data, size);
+        }
+        void write(std::span<const std::byte> data)
+        {
+            stream_->write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+        void write(std::span<const char> data)
+        {
+            stream_->write(data.data(), data.size());
+        }
+        void flush()
+        {
+            stream_->flush();
+        }
+
+        void write_vectored(std::span<const std::span<const char>> parts)
+            requires requires(Stream& s) { s.write_vectored(parts); }
+        {
+            stream_->write_vectored(parts);
+        }
+
+        // Lets DataOutputStream and modern_io pipeline layers encode into the stream's buffer.
+        std::span<char> reserve(std::size_t n)
+            requires requires(Stream& s) { s.reserve(n); s.commit(n); }
+        {
+            return stream_->reserve(n);
+        }
+        void commit(std::size_t n)
+            requires requires(Stream& s) { s.reserve(n); s.commit(n); }
+        {
+            stream_->commit(n);
+        }
+
+        auto native_handle() const
+            requires requires(const Stream& s) { s.native_handle(); }
+        {
+            return stream_->native_handle();
+        }
+
+    private:
+        Stream* stream_;
+    };
+
+    /**
+     * @brief Buffered duplex stream that owns its transport by value.
+     *
+     * The single-owner counterpart of make_stream()'s SharedStream: the transport and
+     * both buffers live in the object, so read() and write() reach the socket without
+     * shared_ptr hops or reference counting. The buffers are the ones of
+     * BufferedTransportSource/BufferedTransportSink (see StreamBufferOptions). The
+     * stream is move-only; reader() and writer() hand out pointer-sized views for
+     * DataInputStream/DataOutputStream.
+     *
+     * Example:
+     * @code
+     * auto stream = make_duplex_stream(TcpEndpoint{"127.0.0.1", 9000});
+     * DataOutputStream out(stream.writer());
+     * DataInputStream in(stream.reader());
+     * out.write_string("PING");
+     * out.flush();
+     * std::string reply = in.read_string();
+     * @endcode
+     */
+    template<typename Transport>
+        requires net_io_concepts::Readable<Transport> && net_io_concepts::Writable<Transport>
+    class DuplexStream
+    {
+    public:
+        using transport_type = Transport;
+
+        explicit DuplexStream(Transport transport, StreamBufferOptions buffers = {})
+            : transport_(std::move(transport)), in_(buffers.read_buffer), out_(buffers.write_buffer)
+        {
+        }
+
+        DuplexStream(DuplexStream&& other) noexcept(std::is_nothrow_move_constructible_v<Transport>)
+            : transport_(std::move(other.transport_)), in_(std::move(other.in_)), out_(std::move(other.out_))
+        {
+        }
+
+        DuplexStream& operator=(DuplexStream&& other)
+        {
+            if (this != &other)
+            {
+                try { out_.flush(transport_); } catch (...) {}
+                transport_ = std::move(other.transport_);
+                in_ = std::move(other.in_);
+                out_ = std::move(other.out_);
+            }
+            return *this;
+        }
+
+        DuplexStream(const DuplexStream&) = delete;
+        DuplexStream& operator=(const DuplexStream&) = delete;
+
+        ~DuplexStream()
+        {
+            try { out_.flush(transport_); } catch (...) {}
+        }
+
+        // OutputStream methods
+        void write(const char* data, std::size_t size)
+        {
+            out_.write(transport_, data, size);
+        }
+        void write(std::span<const std::byte> data)
+        {
+            write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+        void write(std::span<const char> data)
+        {
+            write(data.data(), data.size());
+        }
+        void flush()
+        {
+            out_.flush(transport_);
+        }
+
+        /// Writes several buffers in order. Small gathers are copied into the write buffer;
+        /// otherwise the buffered bytes and the parts leave in one gathered transport write.
+        void write_vectored(std::span<const std::span<const char>> parts)
+            requires requires(Transport& t) { t.write_vectored(parts); }
+        {
+            out_.write_vectored(transport_, parts);
+        }
+
+        /// Returns at least n bytes of write buffer space (flushing if needed), or an empty
+        /// span if n exceeds the buffer size. Fill it and call commit().
+        std::span<char> reserve(std::size_t n)
+        {
+            return out_.reserve(transport_, n);
+        }
+
+        /// Appends the first n bytes of the span returned by reserve().
+        void commit(std::size_t n)
+        {
+            out_.commit(n);
+        }
+
+        // InputStream methods
+        std::size_t read(char* data, std::size_t size)
+        {
+            return in_.read(transport_, data, size);
+        }
+        std::size_t read(std::span<std::byte> data)
+        {
+            return read(reinterpret_cast<char*>(data.data()), data.size());
+        }
+        std::size_t read(std::span<char> data)
+        {
+            return read(data.data(), data.size());
+        }
+
+        /// Returns true once the transport reported end of stream and the buffer is drained.
+        bool eof() const noexcept
+        {
+            return in_.eof();
+        }
+
+        /// Non-owning InputStream view, e.g. DataInputStream in(stream.reader()).
+        StreamReader<DuplexStream> reader() noexcept { return StreamReader<DuplexStream>(*this); }
+
+        /// Non-owning OutputStream view, e.g. DataOutputStream out(stream.writer()).
+        StreamWriter<DuplexStream> writer() noexcept { return StreamWriter<DuplexStream>(*this); }
+
+        /// Returns the number of received bytes not yet returned by read().
+        std::size_t read_buffered() const noexcept { return in_.buffered(); }
+
+        /// Returns the number of bytes waiting for flush().
+        std::size_t write_buffered() const noexcept { return out_.buffered(); }
+
+        // Access to the native socket handle (if available)
+        auto native_handle() const
+            requires requires(const Transport& t) { t.native_handle(); }
+        {
+            return transport_.native_handle();
+        }
+
+        // Access to the owned transport; bypassing the buffers reorders data.
+        Transport& transport() noexcept { return transport_; }
+        const Transport& transport() const noexcept { return transport_; }
+
+    private:
+        Transport transport_;
+        detail::StreamReadBuffer in_;
+        detail::StreamWriteBuffer out_;
+    };
+
+    /**
+     * @brief Connects to a TCP, Unix or in-process endpoint and returns a DuplexStream.
+     * @param ep Endpoint as accepted by make_stream().
+     * @param buffers Buffer sizes; raw_stream for unbuffered reads and writes.
+     *
+     * Use this instead of make_stream() when the connection has a single owner. Unix
+     * SeqPacket endpoints are never write-buffered.
+     */
+    template<typename Endpoint>
+    auto make_duplex_stream(Endpoint&& ep, StreamBufferOptions buffers = {})
+    {
+        using T = std::decay_t<Endpoint>;
+        if constexpr (TcpEndpointLike<T>) {
+            net_io::TcpClient client(std::forward<Endpoint>(ep));
+            client.open();
+            return DuplexStream<net_io::TcpClient>(std::move(client), buffers);
+        } else if constexpr (UnixEndpointLike<T>) {
+            net_io::UnixClient client(net_io::UnixEndpoint(ep.path, ep.type));
+            client.open();
+            if (ep.type != net_io::UnixSocketType::Stream)
+                buffers.write_buffer = 0; // one write() per record
+            return DuplexStream<net_io::UnixClient>(std::move(client), buffers);
+        } else {
+            static_assert(std::same_as<T, net_io::MemoryPipeEndpoint>,
+                          "make_duplex_stream: unsupported endpoint type");
+            net_io::MemoryPipeTransport pipe(std::forward<Endpoint>(ep));
+            pipe.open();
+            return DuplexStream<net_io::MemoryPipeTransport>(std::move(pipe), buffers);
+        }
+    }
+
+    static_assert(modern_io::InputStream<StreamReader<DuplexStream<net_io::TcpClient>>>);
+    static_assert(modern_io::ReservableOutputStream<StreamWriter<DuplexStream<net_io::TcpClient>>>);
+    static_assert(modern_io::NativeHandleStream<StreamWriter<DuplexStream<net_io::TcpClient>>>);
+
+    // --- Convenience StreamBuilders for connection-oriented servers ---
+    /**
+     * @brief Creates a SharedStream for an accepted connection that keeps client and server alive.
+     * @param client shared_ptr to the accepted connection (e.g. TcpClient, UnixClient)
+     * @param server shared_ptr to the server that accepted it
+     * @param buffers Buffer sizes of the stream (see make_stream()); raw_stream for unbuffered.
+     * @return SharedStream with keepalive for both server and client
+     *
+     * The stream is buffered like the ones from make_stream(): handlers call flush() to
+     * send, and whatever is still buffered is sent when the last copy of the stream is
+     * released. For other sizes, pass a builder such as
+     * [](auto c, auto s) { return keepalive_stream_builder(c, s, raw_stream); }.
+     */
+    template<typename ClientType, typename ServerType>
+    auto keepalive_stream_builder(
+        std::shared_ptr<ClientType> client,
+        std::shared_ptr<ServerType> server,
+        StreamBufferOptions buffers = {})
+    {
+        auto src  = BufferedTransportSource<ClientType>(client, buffers.read_buffer);
+        auto sink = BufferedTransportSink<ClientType>(client, buffers.write_buffer);
+        using DuplexType = TcpDuplexStream<decltype(src), decltype(sink)>;
+        struct DuplexWithKeepalive : DuplexType {
+            std::shared_ptr<ServerType> keepalive_server_;
+            std::shared_ptr<ClientType> keepalive_client_;
+            DuplexWithKeepalive(DuplexType&& base,
+                               std::shared_ptr<ServerType> s,
+                               std::shared_ptr<ClientType> c)
+                : DuplexType(std::move(base)), keepalive_server_(std::move(s)), keepalive_client_(std::move(c)) {}
+        };
+        auto duplex = std::make_shared<DuplexWithKeepalive>(
+            DuplexType(std::move(src), std::move(sink)), server, client
+        );
+        return SharedStream<DuplexWithKeepalive>(duplex);
+    }
+
+    /**
+     * @brief Convenience StreamBuilder for TCP: creates a SharedStream with keepalive.
+     * @param client shared_ptr to TcpClient
+     * @param server shared_ptr to TcpServer
+     * @return SharedStream with keepalive for both server and client
+     */
+    inline auto tcp_stream_builder(
+        std::shared_ptr<net_io::TcpClient> client,
+        std::shared_ptr<net_io::TcpServer> server)
+    {
+        return keepalive_stream_builder(std::move(client), std::move(server));
+    }
+
+    /**
+     * @brief Convenience StreamBuilder for Unix domain sockets: creates a SharedStream with keepalive.
+     * @param client shared_ptr to UnixClient
+     * @param server shared_ptr to UnixServer
+     * @return SharedStream with keepalive for both server and client
+     */
+    inline auto unix_stream_builder(
+        std::shared_ptr<net_io::UnixClient> client,
+        std::shared_ptr<net_io::UnixServer> server)
+    {
+        StreamBufferOptions buffers;
+        if (client->type() != net_io::UnixSocketType::Stream)
+            buffers.write_buffer = 0; // one write() per record
+        return keepalive_stream_builder(std::move(client), std::move(server), buffers);
+    }
+
+    /**
+     * @brief Convenience StreamBuilder for in-process pipes: creates a SharedStream with keepalive.
+     * @param client shared_ptr to MemoryPipeTransport
+     * @param server shared_ptr to MemoryPipeServer
+     * @return SharedStream with keepalive for both server and client
+     */
+    inline auto memory_pipe_stream_builder(
+        std::shared_ptr<net_io::MemoryPipeTransport> client,
+        std::shared_ptr<net_io::MemoryPipeServer> server)
+    {
+        return keepalive_stream_builder(std::move(client), std::move(server));
+    }
+
+    /**
+     * @brief std::future front-end for a completion-based stream.
+     *
+     * Satisfies modern_io::AsyncInputStream and modern_io::AsyncOutputStream on top of a
+     * stream with the completion interface (e.g. net_io::AsyncStream), for code written
+     * against the future-returning concepts. Each call posts the operation to the
+     * stream's event loop, so it may be made from any thread; do not wait on the future
+     * on the loop thread itself. Every operation pays for a promise/future shared state
+     * and a posted function, so use the completion interface where throughput matters.
+     *
+     * Example usage:
+     * @code
+     * net_io::AsyncStream<net_io::TcpClient> stream(loop, std::move(client));
+     * FutureStream futures(stream);
+     * std::thread loop_thread([&] { loop.run(); });
+     * std::size_t n = futures.read_async(buf, sizeof(buf)).get();
+     * @endcode
+     */
+    template<typename S>
+        requires modern_io::CompletionInputStream<S> && modern_io::CompletionOutputStream<S>
+              && requires(S& s) { s.loop().post(std::function<void()>{}); }
+    class FutureStream
+    {
+    public:
+        explicit FutureStream(S& stream)
+            : stream_(stream)
+        {}
+
+        std::future<std::size_t> read_async(char* data, std::size_t size)
+        {
+            auto promise = std::make_shared<std::promise<std::size_t>>();
+            auto future = promise->get_future();
+            submit(promise, [this, data, size, promise] {
+                stream_.read_async(data, size, [promise](std::error_code ec, std::size_t n) {
+                    if (ec)
+                        promise->set_exception(std::make_exception_ptr(net_io::SocketException("read_async failed", ec.value())));
+                    else
+                        promise->set_value(n);
+                });
+            });
+            return future;
+        }
+        std::future<std::size_t> read_async(std::span<std::byte> buf)
+        {
+            return read_async(reinterpret_cast<char*>(buf.data()), buf.size());
+        }
+        std::future<std::size_t> read_async(std::span<char> buf)
+        {
+            return read_async(buf.data(), buf.size());
+        }
+
+        std::future<bool> eof_async()
+        {
+            auto promise = std::make_shared<std::promise<bool>>();
+            auto future = promise->get_future();
+            submit(promise, [this, promise] { promise->set_value(stream_.eof()); });
+            return future;
+        }
+
+        std::future<void> write_async(const char* data, std::size_t size)
+        {
+            auto promise = std::make_shared<std::promise<void>>();
+            auto future = promise->get_future();
+            submit(promise, [this, data, size, promise] {
+                stream_.write_async(data, size, [promise](std::error_code ec, std::size_t) {
+                    if (ec)
+                        promise->set_exception(std::make_exception_ptr(net_io::SocketException("write_async failed", ec.value())));
+                    else
+                        promise->set_value();
+                });
+            });
+            return future;
+        }
+        std::future<void> write_async(std::span<const std::byte> buf)
+        {
+            return write_async(reinterpret_cast<const char*>(buf.data()), buf.size());
+        }
+        std::future<void> write_async(std::span<const char> buf)
+        {
+            return write_async(buf.data(), buf.size());
+        }
+
+        std::future<void> flush_async()
+        {
+            auto promise = std::make_shared<std::promise<void>>();
+            auto future = promise->get_future();
+            submit(promise, [this, promise] {
+                stream_.flush_async([promise](std::error_code ec) {
+                    if (ec)
+                        promise->set_exception(std::make_exception_ptr(net_io::SocketException("flush_async failed", ec.value())));
+                    else
+                        promise->set_value();
+                });
+            });
+            return future;
+        }
+
+    private:
+        // Runs start on the loop thread; an exception from starting fails the future.
+        template<typename T, typename Start>
+        void submit(std::shared_ptr<std::promise<T>> promise, Start start)
+        {
+            stream_.loop().post([promise = std::move(promise), start = std::move(start)]() mutable {
+                try
+                {
+                    start();
+                }
+                catch (...)
+                {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+        }
+
+        S& stream_;
+    };
+
+    static_assert(modern_io::CompletionInputStream<net_io::AsyncStream<net_io::TcpClient>>);
+    static_assert(modern_io::CompletionOutputStream<net_io::AsyncStream<net_io::TcpClient>>);
+    static_assert(modern_io::AsyncInputStream<FutureStream<net_io::AsyncStream<net_io::TcpClient>>>);
+    static_assert(modern_io::AsyncOutputStream<FutureStream<net_io::AsyncStream<net_io::TcpClient>>>);
+
+    /**
+     * @brief Counters of a server started with run_server_with_executor().
+     *
+     * All fields are atomics and may be read at any time while the server runs.
+     */
+    struct ServerMetrics
+    {
+        std::atomic<std::uint64_t> accepted{ 0 };      ///< Connections accepted.
+        std::atomic<std::uint64_t> handled{ 0 };       ///< on_client() calls completed.
+        std::atomic<std::uint64_t> accept_errors{ 0 }; ///< Failed accept()/stream builds.
+        std::atomic<std::uint64_t> handler_errors{ 0 };///< on_client() calls that threw.
+        std::atomic<std::size_t>   active{ 0 };        ///< Handlers currently running.
+        std::atomic<std::size_t>   peak_active{ 0 };   ///< Highest concurrent handler count.
+        std::atomic<std::size_t>   pending{ 0 };       ///< Connections waiting for a slot.
+    };
+
+    /**
+     * @brief Limits for dispatching accepted connections to handlers.
+     *
+     * - max_concurrent_handlers: Upper bound of on_client() calls running at the same
+     *   time (0 = unlimited, one executor task per connection).
+     * - max_pending: Accepted connections that may wait for a free handler slot. When
+     *   the queue is full, the accept loop pauses and further clients wait in the
+     *   kernel backlog.
+     * - metrics: Optional counters updated by the server (see ServerMetrics).
+     */
+    struct ServerOptions
+    {
+        std::size_t max_concurrent_handlers = 0;
+        std::size_t max_pending = 64;
+        std::shared_ptr<ServerMetrics> metrics;
+    };
+
+    namespace detail
+    {
+        // Shared between the accept loop and the handler tasks of one server.
+        template<typename Stream, typename Callback>
+        struct Dispatcher
+        {
+            Dispatcher(Callback cb, const ServerOptions& opts)
+                : on_client(std::move(cb)), options(opts)
+                , metrics(opts.metrics ? opts.metrics : std::make_shared<ServerMetrics>())
+            {
+            }
+
+            Callback on_client;
+            ServerOptions options;
+            std::shared_ptr<ServerMetrics> metrics;
+            std::mutex mtx;
+            std::condition_variable slot_freed;
+            std::deque<Stream> pending;
+            std::size_t active = 0;
+
+            bool has_free_slot() const
+            {
+                return options.max_concurrent_handlers == 0 || active < options.max_concurrent_handlers;
+            }
+
+            void mark_started()
+            {
+                ++active;
+                std::size_t now = metrics->active.fetch_add(1) + 1;
+                std::size_t peak = metrics->peak_active.load();
+                while (now > peak && !metrics->peak_active.compare_exchange_weak(peak, now)) {}
+            }
+
+            // Gives back a slot taken by mark_started() whose task never ran.
+            void abandon() noexcept
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                --active;
+                metrics->active.fetch_sub(1);
+                slot_freed.notify_all();
+            }
+
+            // Handler task for one connection. Destroying it unrun (the executor threw,
+            // was shut down or discarded it) releases the slot taken for it.
+            struct Task
+            {
+                Task(std::shared_ptr<Dispatcher> d, Stream s)
+                    : self(std::move(d)), stream(std::move(s))
+                {
+                }
+
+                Task(Task&&) = default;
+                Task& operator=(Task&&) = delete;
+
+                ~Task()
+                {
+                    if (self)
+                        self->abandon();
+                }
+
+                void operator()()
+                {
+                    run(std::move(self), std::move(stream));
+                }
+
+                std::shared_ptr<Dispatcher> self;
+                Stream stream;
+            };
+
+            // Runs the handler, then keeps the slot and serves queued connections.
+            static void run(std::shared_ptr<Dispatcher> self, Stream stream)
+            {
+                while (true)
+                {
+                    // Nothing may escape: the slot below must be released in any case.
+                    try {
+                        self->on_client(stream);
+                    } catch (const std::exception& ex) {
+                        self->metrics->handler_errors.fetch_add(1);
+                        static net_io::LogRateLimit limit;
+                        net_io::log_message<net_io::LogLevel::Error>(limit, "net_io_adapters", [&] {
+                            return std::string("Error in client handler: ") + ex.what();
+                        });
+                    } catch (...) {
+                        self->metrics->handler_errors.fetch_add(1);
+                        static net_io::LogRateLimit limit;
+                        net_io::log_message<net_io::LogLevel::Error>(limit, "net_io_adapters", [] {
+                            return std::string("Unknown error in client handler");
+                        });
+                    }
+                    self->metrics->handled.fetch_add(1);
+
+                    std::lock_guard<std::mutex> lock(self->mtx);
+                    if (self->pending.empty())
+                    {
+                        --self->active;
+                        self->metrics->active.fetch_sub(1);
+                        self->slot_freed.notify_one();
+                        return;
+                    }
+                    stream = std::move(self->pending.front());
+                    self->pending.pop_front();
+                    self->metrics->pending.fetch_sub(1);
+                    self->slot_freed.notify_one();
+                }
+            }
+        };
+    }
+
+    /**
+     * @brief Generic server factory that submits a task to the executor for each new connection.
+     *
+     * The accept loop runs as one executor task and hands every accepted connection to
+     * its own executor task, so a slow handler no longer delays accepting other clients.
+     * With options.max_concurrent_handlers set, at most that many handlers run at once;
+     * further connections wait in a queue of options.max_pending entries, and the accept
+     * loop pauses while the queue is full.
+     *
+     * The executor must be able to run the accept loop and the handlers at the same
+     * time (e.g. ThreadExecutor, or a pool with more than one worker).
+     *
+     * Example:
+     * @code
+     * ServerOptions opts{ .max_concurrent_handlers = 64, .max_pending = 256,
+     *                     .metrics = std::make_shared<ServerMetrics>() };
+     * run_tcp_server(executor, opts, [](auto stream) { ... }, running, TcpEndpoint{"0.0.0.0", 9000});
+     * @endcode
+     */
+    template<
+        typename Callback,
+        typename StreamBuilder,
+        net_io_concepts::Acceptable ServerType,
         net_io_concepts::Transportable ClientType,
         Executor Exec,
         typename... ServerArgs
     >
     void run_server_with_executor(
         Exec& executor,
+        const ServerOptions& options,
         StreamBuilder make_stream,
         Callback&& on_client,
         std::atomic<bool>& running,
         ServerArgs&&... server_args
     )
     {
+        using StreamType = std::invoke_result_t<StreamBuilder&, std::shared_ptr<ClientType>, std::shared_ptr<ServerType>>;
+        using DispatcherType = detail::Dispatcher<StreamType, std::decay_t<Callback>>;
+
         auto server = std::make_shared<ServerType>(std::forward<ServerArgs>(server_args)...);
         server->start();
+        auto dispatcher = std::make_shared<DispatcherType>(std::forward<Callback>(on_client), options);
 
-        executor.execute([server, &executor, make_stream, on_client = std::forward<Callback>(on_client), &running]() mutable {
+        executor.execute([server, &executor, make_stream, dispatcher, &running]() mutable {
             while (running) {
                 try {
                     auto accepted = server->accept();
                     auto client = std::make_shared<ClientType>(std::move(accepted));
                     auto stream = make_stream(client, server);
-                    on_client(stream);
+                    dispatcher->metrics->accepted.fetch_add(1);
+
+                    std::unique_lock<std::mutex> lock(dispatcher->mtx);
+                    if (dispatcher->has_free_slot()) {
+                        dispatcher->mark_started();
+                        lock.unlock();
+                        execute_unique(executor, typename DispatcherType::Task(dispatcher, std::move(stream)));
+                    } else {
+                        // All handlers busy: queue the connection, pausing accept while the queue is full.
+                        // running is the caller's flag and nobody notifies slot_freed when it
+                        // drops, so the wait rechecks it periodically.
+                        while (!dispatcher->slot_freed.wait_for(lock, std::chrono::milliseconds(50), [&] {
+                            return dispatcher->pending.size() < dispatcher->options.max_pending
+                                || dispatcher->has_free_slot() || !running;
+                        })) {}
+                        if (dispatcher->has_free_slot()) {
+                            dispatcher->mark_started();
+                            lock.unlock();
+                            execute_unique(executor, typename DispatcherType::Task(dispatcher, std::move(stream)));
+                        } else if (dispatcher->pending.size() < dispatcher->options.max_pending) {
+                            dispatcher->pending.push_back(std::move(stream));
+                            dispatcher->metrics->pending.fetch_add(1);
+                        }
+                    }
                 } catch (const std::exception& ex) {
-                    std::cerr << "[net_io_adapters] Error accepting connection: " << ex.what() << std::endl;
+                    dispatcher->metrics->accept_errors.fetch_add(1);
+                    static net_io::LogRateLimit limit;
+                    net_io::log_message<net_io::LogLevel::Error>(limit, "net_io_adapters", [&] {
+                        return std::string("Error accepting connection: ") + ex.what();
+                    });
+                } catch (...) {
+                    dispatcher->metrics->accept_errors.fetch_add(1);
+                    static net_io::LogRateLimit limit;
+                    net_io::log_message<net_io::LogLevel::Error>(limit, "net_io_adapters", [] {
+                        return std::string("Unknown error accepting connection");
+                    });
                 }
             }
         });
     }
 
+    /**
+     * @brief Generic server factory with default ServerOptions (unlimited concurrent handlers).
+     *        Die Callback- und StreamBuilder-Parameter stehen jetzt vorne, damit Template-Deduktion funktioniert.
+     */
+    template<
+        typename Callback,
+        typename StreamBuilder,
+        net_io_concepts::Acceptable ServerType,
+        net_io_concepts::Transportable ClientType,
+        Executor Exec,
+        typename... ServerArgs
+    >
+    void run_server_with_executor(
+        Exec& executor,
+        StreamBuilder make_stream,
+        Callback&& on_client,
+        std::atomic<bool>& running,
+        ServerArgs&&... server_args
+    )
+    {
+        run_server_with_executor<Callback, StreamBuilder, ServerType, ClientType, Exec, ServerArgs...>(
+            executor,
+            ServerOptions{},
+            std::move(make_stream),
+            std::forward<Callback>(on_client),
+            running,
+            std::forward<ServerArgs>(server_args)...
+        );
+    }
+
     /**
      * @brief Convenience function to run a TCP server using run_server_with_executor.
      *        Behält die Flexibilität bzgl. Executor, Callback und StreamBuilder.
@@ -917,6 +2007,7 @@ export namespace net_io_adapters
      * @tparam Executor        Typ des Executors
      * @tparam StreamBuilder   Typ des Stream-Builders
      * @param executor         Executor-Instanz
+     * @param options          Limits für gleichzeitige Handler und Warteschlange
      * @param on_client        Callback für neue Clients
      * @param running          Atomic-Flag zum Stoppen des Servers
      * @param server_args      Argumente für den TcpServer-Konstruktor
@@ -929,6 +2020,7 @@ export namespace net_io_adapters
     >
     void run_tcp_server(
         Executor& executor,
+        const ServerOptions& options,
         Callback&& on_client,
         std::atomic<bool>& running,
         ServerArgs&&... server_args
@@ -943,11 +2035,176 @@ export namespace net_io_adapters
             ServerArgs...
         >(
             executor,
+            options,
             tcp_stream_builder,
             std::forward<Callback>(on_client),
             running,
             std::forward<ServerArgs>(server_args)...
         );
     }
+
+    /**
+     * @brief run_tcp_server with default ServerOptions.
+     */
+    template<
+        typename Callback,
+        typename Executor,
+        typename... ServerArgs
+    >
+    void run_tcp_server(
+        Executor& executor,
+        Callback&& on_client,
+        std::atomic<bool>& running,
+        ServerArgs&&... server_args
+    )
+    {
+        run_tcp_server(
+            executor,
+            ServerOptions{},
+            std::forward<Callback>(on_client),
+            running,
+            std::forward<ServerArgs>(server_args)...
+        );
+    }
+
+    /**
+     * @brief Convenience function to run a Unix domain socket server using run_server_with_executor.
+     * @tparam Callback        Type of the client callback
+     * @tparam Executor        Type of the executor
+     * @param executor         Executor instance
+     * @param options          Handler concurrency limits and pending queue size
+     * @param on_client        Callback for new clients
+     * @param running          Atomic flag to stop the server
+     * @param server_args      Arguments for the UnixServer constructor (usually a UnixEndpoint)
+     *
+     * Example:
+     * @code
+     * run_unix_server(executor, [](auto stream) { ... }, running, net_io::UnixEndpoint{"@myapp"});
+     * @endcode
+     */
+    template<
+        typename Callback,
+        typename Executor,
+        typename StreamBuilder = decltype(unix_stream_builder),
+        typename... ServerArgs
+    >
+    void run_unix_server(
+        Executor& executor,
+        const ServerOptions& options,
+        Callback&& on_client,
+        std::atomic<bool>& running,
+        ServerArgs&&... server_args
+    )
+    {
+        run_server_with_executor<
+            Callback,
+            StreamBuilder,
+            net_io::UnixServer,
+            net_io::UnixClient,
+            Executor,
+            ServerArgs...
+        >(
+            executor,
+            options,
+            unix_stream_builder,
+            std::forward<Callback>(on_client),
+            running,
+            std::forward<ServerArgs>(server_args)...
+        );
+    }
+
+    /**
+     * @brief run_unix_server with default ServerOptions.
+     */
+    template<
+        typename Callback,
+        typename Executor,
+        typename... ServerArgs
+    >
+    void run_unix_server(
+        Executor& executor,
+        Callback&& on_client,
+        std::atomic<bool>& running,
+        ServerArgs&&... server_args
+    )
+    {
+        run_unix_server(
+            executor,
+            ServerOptions{},
+            std::forward<Callback>(on_client),
+            running,
+            std::forward<ServerArgs>(server_args)...
+        );
+    }
+
+    /**
+     * @brief Convenience function to run an in-process MemoryPipeServer using run_server_with_executor.
+     * @tparam Callback        Type of the client callback
+     * @tparam Executor        Type of the executor
+     * @param executor         Executor instance
+     * @param options          Handler concurrency limits and pending queue size
+     * @param on_client        Callback for new clients
+     * @param running          Atomic flag to stop the server
+     * @param server_args      Arguments for the MemoryPipeServer constructor (a MemoryPipeEndpoint)
+     *
+     * Example:
+     * @code
+     * run_memory_pipe_server(executor, [](auto stream) { ... }, running, net_io::MemoryPipeEndpoint{"bench"});
+     * @endcode
+     */
+    template<
+        typename Callback,
+        typename Executor,
+        typename StreamBuilder = decltype(memory_pipe_stream_builder),
+        typename... ServerArgs
+    >
+    void run_memory_pipe_server(
+        Executor& executor,
+        const ServerOptions& options,
+        Callback&& on_client,
+        std::atomic<bool>& running,
+        ServerArgs&&... server_args
+    )
+    {
+        run_server_with_executor<
+            Callback,
+            StreamBuilder,
+            net_io::MemoryPipeServer,
+            net_io::MemoryPipeTransport,
+            Executor,
+            ServerArgs...
+        >(
+            executor,
+            options,
+            memory_pipe_stream_builder,
+            std::forward<Callback>(on_client),
+            running,
+            std::forward<ServerArgs>(server_args)...
+        );
+    }
+
+    /**
+     * @brief run_memory_pipe_server with default ServerOptions.
+     */
+    template<
+        typename Callback,
+        typename Executor,
+        typename... ServerArgs
+    >
+    void run_memory_pipe_server(
+        Executor& executor,
+        Callback&& on_client,
+        std::atomic<bool>& running,
+        ServerArgs&&... server_args
+    )
+    {
+        run_memory_pipe_server(
+            executor,
+            ServerOptions{},
+            std::forward<Callback>(on_client),
+            running,
+            std::forward<ServerArgs>(server_args)...
+        );
+    }
 } // namespace net_io_adapters
 
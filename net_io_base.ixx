@@ -10,12 +10,15 @@ module;
   #include <ws2tcpip.h>
 #else
   #include <arpa/inet.h>    // Provides functions for IP address manipulation (e.g., inet_pton, inet_ntop), multicast, and broadcast.
+  #include <cerrno>         // errno values classified by IoResult.
   #include <cstdint>
   #include <cstring>
   #include <fcntl.h>        // Provides file control options, including nonblocking sockets (O_NONBLOCK).
   #include <netdb.h>        // Provides network database operations (e.g., getaddrinfo).
+  #include <poll.h>         // poll() for readiness waits on client sockets.
   #include <sys/socket.h>   // Core socket API (socket, bind, connect, etc.).
   #include <sys/types.h>
+  #include <sys/uio.h>      // iovec for gathered sends.
   #include <unistd.h>       // Provides close(), read(), write(), and other POSIX APIs.
 #endif
 
@@ -25,8 +28,11 @@ module;
 #include <optional>
 
 #ifndef _MSC_VER
+#include <cstddef>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <utility>
 #include <vector>
 #endif
@@ -34,8 +40,11 @@ module;
 export module net_io_base;
 
 #ifdef _MSC_VER
+import <cstddef>;
+import <span>;
 import <stdexcept>;
 import <string>;
+import <system_error>;
 import <utility>;
 import <vector>;
 #endif
@@ -115,6 +124,217 @@ namespace net_io
     std::optional<std::string> peer_;
   };
 
+  /**
+   * @brief Outcome of a non-throwing I/O call.
+   *
+   * - Ok: the call transferred IoResult::bytes (0 only for an empty request).
+   * - Eof: the peer closed the connection.
+   * - WouldBlock: a nonblocking socket had no data, buffer space or pending connection.
+   * - Timeout: a read, write or accept timeout expired.
+   * - Error: any other failure, see IoResult::error.
+   */
+  export enum class IoStatus
+  {
+    Ok,
+    Eof,
+    WouldBlock,
+    Timeout,
+    Error
+  };
+
+  /**
+   * @brief Result of the try_ I/O functions: a byte count, or the reason there is none.
+   *
+   * The try_ functions never throw, so a hot loop can treat would-block, timeout and
+   * end of stream as ordinary values instead of paying for exception unwinding. The
+   * throwing functions (read(), write(), accept()) are built on top of them.
+   *
+   * Example:
+   * @code
+   * net_io::IoResult r = client.try_read(buf, sizeof(buf));
+   * if (r)
+   *   consume(buf, r.bytes);
+   * else if (r.eof())
+   *   client.close();
+   * else if (!r.would_block())
+   *   log(r.error_code().message());
+   * @endcode
+   */
+  export struct IoResult
+  {
+    std::size_t bytes = 0;
+    IoStatus status = IoStatus::Ok;
+    int error = 0; ///< errno or WSAGetLastError() value unless Ok or Eof.
+
+    bool ok() const noexcept { return status == IoStatus::Ok; }
+    bool eof() const noexcept { return status == IoStatus::Eof; }
+    bool would_block() const noexcept { return status == IoStatus::WouldBlock; }
+    bool timed_out() const noexcept { return status == IoStatus::Timeout; }
+    explicit operator bool() const noexcept { return ok(); }
+
+    /// Returns the error as std::error_code (empty for Ok and Eof).
+    std::error_code error_code() const noexcept
+    {
+      return std::error_code(error, std::system_category());
+    }
+  };
+
+  /**
+   * @brief Tell whether a socket is in nonblocking mode.
+   * @param fd The socket handle.
+   *
+   * For sockets adopted from elsewhere; objects that switch the mode themselves keep
+   * track of it. Windows cannot query the mode and always reports false.
+   */
+  export inline bool is_nonblocking(sock_t fd) noexcept
+  {
+#if defined(_WIN32)
+    (void)fd;
+    return false;
+#else
+    if (fd == invalid_socket)
+      return false;
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && (flags & O_NONBLOCK) != 0;
+#endif
+  }
+
+  /**
+   * @brief Classify the error of a failed socket call.
+   * @param err The errno or WSAGetLastError() value.
+   * @param nonblocking Whether the socket is in nonblocking mode, as recorded by its owner.
+   *
+   * On POSIX, EAGAIN means "would block" on a nonblocking socket but "timed out" on a
+   * blocking socket with SO_RCVTIMEO/SO_SNDTIMEO, so the socket's mode decides.
+   */
+  export inline IoResult io_failure(int err, bool nonblocking) noexcept
+  {
+    IoResult r;
+    r.error = err;
+#if defined(_WIN32)
+    (void)nonblocking;
+    if (err == WSAEWOULDBLOCK)
+      r.status = IoStatus::WouldBlock;
+    else if (err == WSAETIMEDOUT)
+      r.status = IoStatus::Timeout;
+    else
+      r.status = IoStatus::Error;
+#else
+    if (err == EAGAIN || err == EWOULDBLOCK)
+      r.status = nonblocking ? IoStatus::WouldBlock : IoStatus::Timeout;
+    else if (err == ETIMEDOUT)
+      r.status = IoStatus::Timeout;
+    else
+      r.status = IoStatus::Error;
+#endif
+    return r;
+  }
+
+  /**
+   * @brief Send several buffers in order with as few system calls as possible.
+   * @param fd A connected stream or seqpacket socket.
+   * @param parts The buffers; up to 64 go into one sendmsg()/WSASend() call.
+   * @param flags send flags, e.g. MSG_NOSIGNAL (ignored on Windows).
+   * @param nonblocking Whether fd is in nonblocking mode (see io_failure()).
+   * @return Ok with the total byte count once everything is sent, or the failure
+   *         with IoResult::bytes set to what was sent before it.
+   *
+   * A length prefix and its payload thus leave in one call instead of two (or a copy
+   * into a staging buffer). Partial sends continue with the remaining bytes.
+   */
+  export inline IoResult send_gathered(sock_t fd, std::span<const std::span<const char>> parts, int flags,
+                                         bool nonblocking) noexcept
+  {
+    constexpr std::size_t max_parts = 64;
+    std::size_t sent_total = 0;
+    std::size_t index = 0;  // first part not completely sent
+    std::size_t offset = 0; // bytes of parts[index] already sent
+    while (true)
+    {
+      while (index < parts.size() && offset == parts[index].size())
+      {
+        ++index;
+        offset = 0;
+      }
+      if (index == parts.size())
+        return IoResult{ sent_total, IoStatus::Ok, 0 };
+
+#if defined(_WIN32)
+      (void)flags;
+      WSABUF bufs[max_parts];
+      DWORD count = 0;
+      for (std::size_t i = index; i < parts.size() && count < max_parts; ++i)
+      {
+        std::size_t skip = (i == index) ? offset : 0;
+        if (parts[i].size() > skip)
+          bufs[count++] = WSABUF{ static_cast<ULONG>(parts[i].size() - skip), const_cast<char*>(parts[i].data() + skip) };
+      }
+      DWORD sent = 0;
+      if (::WSASend(fd, bufs, count, &sent, 0, nullptr, nullptr) == SOCKET_ERROR)
+      {
+        IoResult r = io_failure(WSAGetLastError(), nonblocking);
+        r.bytes = sent_total;
+        return r;
+      }
+      std::size_t advance = sent;
+#else
+      iovec iov[max_parts];
+      std::size_t count = 0;
+      for (std::size_t i = index; i < parts.size() && count < max_parts; ++i)
+      {
+        std::size_t skip = (i == index) ? offset : 0;
+        if (parts[i].size() > skip)
+          iov[count++] = iovec{ const_cast<char*>(parts[i].data() + skip), parts[i].size() - skip };
+      }
+      msghdr msg{};
+      msg.msg_iov = iov;
+      msg.msg_iovlen = count;
+      ssize_t ret = ::sendmsg(fd, &msg, flags);
+      if (ret < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        IoResult r = io_failure(errno, nonblocking);
+        r.bytes = sent_total;
+        return r;
+      }
+      std::size_t advance = static_cast<std::size_t>(ret);
+#endif
+      sent_total += advance;
+      while (advance > 0)
+      {
+        std::size_t left = parts[index].size() - offset;
+        if (advance < left)
+        {
+          offset += advance;
+          break;
+        }
+        advance -= left;
+        ++index;
+        offset = 0;
+      }
+    }
+  }
+
+  /**
+   * @brief Wait until sockets become ready, with poll() (WSAPoll() on Windows).
+   * @param fds The sockets and the events to wait for; revents is set on return.
+   * @param timeout_ms Maximum wait in milliseconds (-1 = no timeout).
+   * @return Number of ready sockets, 0 on timeout, or -1 on failure (errno or
+   *         WSAGetLastError()).
+   *
+   * Use this rather than select() for connections: FD_SET() on a descriptor at or
+   * above FD_SETSIZE (usually 1024) writes out of bounds, and busy processes get there.
+   */
+  export inline int poll_sockets(std::span<pollfd> fds, int timeout_ms) noexcept
+  {
+#if defined(_WIN32)
+    return ::WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeout_ms);
+#else
+    return ::poll(fds.data(), static_cast<nfds_t>(fds.size()), timeout_ms);
+#endif
+  }
+
   /**
    * @brief Enumeration of common socket options for cross-platform configuration.
    *
@@ -125,6 +345,7 @@ namespace net_io
    * - NonBlocking: Sets the socket to non-blocking mode.
    * - ReadTimeoutMs: Sets the receive timeout in milliseconds.
    * - WriteTimeoutMs: Sets the send timeout in milliseconds.
+   * - ZeroCopy: Enables MSG_ZEROCOPY sends (Linux only, ignored elsewhere).
    */
   export enum class SocketOption
   {
@@ -133,7 +354,8 @@ namespace net_io
     Broadcast,
     NonBlocking,
     ReadTimeoutMs,
-    WriteTimeoutMs
+    WriteTimeoutMs,
+    ZeroCopy
   };
 
   /**
@@ -210,6 +432,32 @@ namespace net_io
 #endif
         break;
       }
+      case SocketOption::ZeroCopy:
+      {
+#if defined(SO_ZEROCOPY)
+        ::setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &value, sizeof(value));
+#endif
+        break;
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the length of the socket address actually stored in a sockaddr_storage.
+   *
+   * Some platforms reject connect()/bind() when the length is sizeof(sockaddr_storage),
+   * so the family-specific size should be passed instead.
+   *
+   * @param addr The address (AF_INET or AF_INET6).
+   * @return sizeof(sockaddr_in), sizeof(sockaddr_in6), or sizeof(sockaddr_storage) for other families.
+   */
+  export inline socklen_t sockaddr_length(const sockaddr_storage& addr) noexcept
+  {
+    switch (addr.ss_family)
+    {
+      case AF_INET:  return static_cast<socklen_t>(sizeof(sockaddr_in));
+      case AF_INET6: return static_cast<socklen_t>(sizeof(sockaddr_in6));
+      default:       return static_cast<socklen_t>(sizeof(sockaddr_storage));
     }
   }
 
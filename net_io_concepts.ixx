@@ -66,6 +66,31 @@ namespace net_io_concepts
     { t.write(buf, n) } -> std::same_as<void>;
   };
 
+  /**
+   * @brief Concept for types that support partial, nonblocking writes.
+   *
+   * A type satisfies this concept if it provides a member function
+   * with the following signature:
+   *   std::size_t write_some(const char* buf, std::size_t n);
+   *
+   * write_some() writes as many bytes as possible without blocking and returns
+   * how many were written (0 if the stream is currently not writable).
+   *
+   * Example:
+   * @code
+   * struct MySocket
+   * {
+   *     std::size_t write_some(const char* buf, std::size_t n) { ... }
+   * };
+   * static_assert(PartialWritable<MySocket>);
+   * @endcode
+   */
+  export template<typename T>
+  concept PartialWritable = requires(T& t, const char* buf, std::size_t n)
+  {
+    { t.write_some(buf, n) } -> std::convertible_to<std::size_t>;
+  };
+
   /**
    * @brief Concept for transportable types.
    *
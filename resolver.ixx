@@ -0,0 +1,511 @@
+module;
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  #pragma comment(lib, "ws2_32.lib") // Only needed for static linking on Windows.
+#else
+  #include <arpa/inet.h>
+  #include <netdb.h>
+  #include <sys/socket.h>
+#endif
+
+#include <mutex>
+
+#ifndef _MSC_VER
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides a process-wide, thread-safe cache in front of getaddrinfo.
+// TcpEndpoint and UdpEndpoint resolve through it, so repeated connects and peer
+// changes do not pay a resolver round trip each time.
+
+export module net_io.resolver;
+import net_io_base;
+export import net_io_base;
+
+#ifdef _MSC_VER
+import <algorithm>;
+import <chrono>;
+import <condition_variable>;
+import <cstdint>;
+import <cstring>;
+import <deque>;
+import <map>;
+import <optional>;
+import <stdexcept>;
+import <string>;
+import <thread>;
+import <tuple>;
+import <utility>;
+import <vector>;
+#endif
+
+export namespace net_io
+{
+  /**
+   * @brief Counters describing Resolver cache behaviour.
+   *
+   * - numeric: Lookups answered by the numeric-address fast path (no getaddrinfo).
+   * - hits / misses: Cache hits and lookups that had to call getaddrinfo.
+   * - negative_hits: Hits on a cached resolution failure.
+   * - refreshes: Entries refreshed by the background thread before expiring.
+   */
+  struct ResolverStats
+  {
+    std::uint64_t numeric       = 0;
+    std::uint64_t hits          = 0;
+    std::uint64_t misses        = 0;
+    std::uint64_t negative_hits = 0;
+    std::uint64_t refreshes     = 0;
+  };
+
+  /**
+   * @brief Process-wide getaddrinfo cache with TTL, negative caching and background refresh.
+   *
+   * - Numeric addresses ("127.0.0.1", "::1") are converted with inet_pton and never reach
+   *   getaddrinfo or the cache.
+   * - Successful lookups are cached for the TTL (default 60 s), failures for the negative
+   *   TTL (default 5 s). getaddrinfo does not report record TTLs, so both are fixed.
+   * - A background thread re-resolves entries that were used recently and are about to
+   *   expire, so hot names never block their callers on expiry.
+   * - try_resolve() never blocks: it answers from the cache or schedules the lookup on
+   *   the background thread and returns std::nullopt.
+   * - Concurrent lookups of the same name share a single getaddrinfo call.
+   *
+   * Entries are keyed by host, socket type and passive flag; the port is applied to a
+   * copy of the cached addresses on each lookup. Past 4096 entries the expired ones and
+   * then the least recently used ones are evicted.
+   *
+   * Example:
+   * @code
+   * auto& r = net_io::Resolver::instance();
+   * auto addrs = r.resolve("example.com", 443, SOCK_STREAM);
+   * if (auto cached = r.try_resolve("example.org", 443, SOCK_STREAM)) { ... }
+   * @endcode
+   */
+  class Resolver
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    Resolver() = default;
+
+    Resolver(const Resolver&) = delete;
+    Resolver& operator=(const Resolver&) = delete;
+
+    /**
+     * @brief Destructor. Stops and joins the background thread.
+     */
+    ~Resolver()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+      }
+      work_cv_.notify_all();
+      if (worker_.joinable())
+        worker_.join();
+    }
+
+    /**
+     * @brief Returns the process-wide resolver used by TcpEndpoint and UdpEndpoint.
+     */
+    static Resolver& instance()
+    {
+      static Resolver resolver;
+      return resolver;
+    }
+
+    /**
+     * @brief Resolve a host to all candidate addresses, using the cache.
+     * @param host Hostname or numeric address (ignored if passive).
+     * @param port Port stored into every returned address.
+     * @param socktype SOCK_STREAM or SOCK_DGRAM.
+     * @param passive If true, resolve the wildcard address for binding (AI_PASSIVE).
+     * @return Non-empty list of addresses in resolver order.
+     * @throws std::runtime_error if resolution fails (also while a failure is negatively cached).
+     */
+    std::vector<sockaddr_storage> resolve(const std::string& host, uint16_t port,
+                                          int socktype, bool passive = false)
+    {
+      if (!passive)
+      {
+        if (auto numeric = parse_numeric(host, port))
+        {
+          std::lock_guard<std::mutex> lock(mtx_);
+          ++stats_.numeric;
+          return { *numeric };
+        }
+      }
+
+      Key key{ passive ? std::string() : host, socktype, passive };
+      std::unique_lock<std::mutex> lock(mtx_);
+      while (true)
+      {
+        auto now = clock::now();
+        auto it = cache_.find(key);
+        if (it != cache_.end() && !it->second.in_flight && it->second.expires > now)
+        {
+          it->second.last_used = now;
+          return answer(it->second, port);
+        }
+        if (it != cache_.end() && it->second.in_flight)
+        {
+          // Another thread is resolving this name; share its result.
+          done_cv_.wait(lock);
+          continue;
+        }
+
+        ++stats_.misses;
+        Entry& entry = cache_[key];
+        entry.in_flight = true;
+        entry.last_used = now;
+        lock.unlock();
+        Entry fresh = lookup(key);
+        lock.lock();
+        store(key, std::move(fresh));
+        Entry& stored = cache_[key];
+        stored.last_used = clock::now();
+        done_cv_.notify_all();
+        return answer(stored, port, false);
+      }
+    }
+
+    /**
+     * @brief Non-blocking lookup.
+     * @return The cached (or numeric) addresses, or std::nullopt if the name is not cached yet;
+     *         in that case the lookup is scheduled on the background thread.
+     * @throws std::runtime_error if a resolution failure is negatively cached.
+     */
+    std::optional<std::vector<sockaddr_storage>> try_resolve(const std::string& host, uint16_t port,
+                                                             int socktype, bool passive = false)
+    {
+      if (!passive)
+      {
+        if (auto numeric = parse_numeric(host, port))
+        {
+          std::lock_guard<std::mutex> lock(mtx_);
+          ++stats_.numeric;
+          return std::vector<sockaddr_storage>{ *numeric };
+        }
+      }
+
+      Key key{ passive ? std::string() : host, socktype, passive };
+      std::lock_guard<std::mutex> lock(mtx_);
+      auto now = clock::now();
+      auto it = cache_.find(key);
+      if (it != cache_.end() && !it->second.in_flight && it->second.expires > now)
+      {
+        it->second.last_used = now;
+        return answer(it->second, port);
+      }
+      if (it == cache_.end() || !it->second.in_flight)
+      {
+        Entry& entry = cache_[key];
+        entry.in_flight = true;
+        entry.last_used = now;
+        schedule(key);
+      }
+      return std::nullopt;
+    }
+
+    /**
+     * @brief Set the lifetime of successful lookups.
+     */
+    void set_ttl(std::chrono::milliseconds ttl)
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      ttl_ = ttl;
+    }
+
+    /**
+     * @brief Set the lifetime of cached resolution failures.
+     */
+    void set_negative_ttl(std::chrono::milliseconds ttl)
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      negative_ttl_ = ttl;
+    }
+
+    /**
+     * @brief Enable or disable background refresh of hot entries (enabled by default).
+     */
+    void set_background_refresh(bool enable)
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      refresh_enabled_ = enable;
+    }
+
+    /**
+     * @brief Drop all cached entries (in-flight lookups complete normally).
+     *
+     * Background refreshes that are queued or running are discarded when they finish.
+     */
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      ++generation_;
+      for (auto it = cache_.begin(); it != cache_.end();)
+        it = it->second.in_flight ? std::next(it) : cache_.erase(it);
+    }
+
+    /**
+     * @brief Returns a snapshot of the cache counters.
+     */
+    ResolverStats stats() const
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      return stats_;
+    }
+
+    /**
+     * @brief Convert a numeric IPv4/IPv6 address without calling getaddrinfo.
+     * @return The address with the port set, or std::nullopt if host is not numeric.
+     */
+    static std::optional<sockaddr_storage> parse_numeric(const std::string& host, uint16_t port)
+    {
+      sockaddr_storage storage;
+      std::memset(&storage, 0, sizeof(storage));
+      auto* v4 = reinterpret_cast<sockaddr_in*>(&storage);
+      if (::inet_pton(AF_INET, host.c_str(), &v4->sin_addr) == 1)
+      {
+        v4->sin_family = AF_INET;
+        v4->sin_port = htons(port);
+        return storage;
+      }
+      auto* v6 = reinterpret_cast<sockaddr_in6*>(&storage);
+      if (::inet_pton(AF_INET6, host.c_str(), &v6->sin6_addr) == 1)
+      {
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = htons(port);
+        return storage;
+      }
+      return std::nullopt; // hostnames and scoped addresses ("fe80::1%eth0") take the slow path
+    }
+
+  private:
+    using Key = std::tuple<std::string, int, bool>;
+
+    struct Entry
+    {
+      std::vector<sockaddr_storage> addrs; ///< Empty for a negative entry.
+      std::string error;                   ///< Resolution error (negative entry).
+      clock::time_point expires{};
+      clock::time_point last_used{};
+      bool in_flight = false;  ///< No usable answer yet; callers wait for the lookup.
+      bool refreshing = false; ///< Background refresh queued; callers keep the old answer.
+    };
+
+    // A queued background lookup; generation is the clear() count when it was queued.
+    struct Job
+    {
+      Key key;
+      bool refresh = false;
+      std::uint64_t generation = 0;
+    };
+
+    static constexpr std::size_t max_entries_ = 4096;
+
+    // Returns a copy of a cached entry with the port applied; throws for negative entries.
+    std::vector<sockaddr_storage> answer(const Entry& entry, uint16_t port, bool count_hit = true)
+    {
+      if (entry.addrs.empty())
+      {
+        if (count_hit) ++stats_.negative_hits;
+        throw std::runtime_error(entry.error);
+      }
+      if (count_hit) ++stats_.hits;
+      std::vector<sockaddr_storage> out = entry.addrs;
+      for (auto& a : out)
+      {
+        if (a.ss_family == AF_INET)
+          reinterpret_cast<sockaddr_in*>(&a)->sin_port = htons(port);
+        else if (a.ss_family == AF_INET6)
+          reinterpret_cast<sockaddr_in6*>(&a)->sin6_port = htons(port);
+      }
+      return out;
+    }
+
+    // Runs getaddrinfo without holding the lock.
+    static Entry lookup(const Key& key)
+    {
+#if defined(_WIN32)
+      detail::ensure_wsa();
+#endif
+      const auto& [host, socktype, passive] = key;
+      addrinfo hints{}, *res = nullptr;
+      hints.ai_family   = AF_UNSPEC;      // Allow IPv4 or IPv6.
+      hints.ai_socktype = socktype;
+      hints.ai_flags    = passive ? AI_PASSIVE : 0;
+
+      Entry entry;
+      int err = getaddrinfo(passive ? nullptr : host.c_str(), "0", &hints, &res);
+      if (err != 0 || !res)
+      {
+        entry.error = "getaddrinfo failed: ";
+#if defined(_WIN32)
+        entry.error += std::to_string(WSAGetLastError());
+#else
+        entry.error += gai_strerror(err);
+#endif
+        return entry;
+      }
+      for (auto rp = res; rp; rp = rp->ai_next)
+      {
+        sockaddr_storage storage;
+        std::memset(&storage, 0, sizeof(storage));
+        std::memcpy(&storage, rp->ai_addr, rp->ai_addrlen);
+        bool duplicate = false;
+        for (const auto& seen : entry.addrs)
+          duplicate = duplicate || std::memcmp(&seen, &storage, sizeof(storage)) == 0;
+        if (!duplicate)
+          entry.addrs.push_back(storage);
+      }
+      freeaddrinfo(res);
+      return entry;
+    }
+
+    // Installs a lookup result (lock held).
+    void store(const Key& key, Entry fresh)
+    {
+      auto now = clock::now();
+      Entry& entry = cache_[key];
+      fresh.expires = now + (fresh.addrs.empty() ? negative_ttl_ : ttl_);
+      fresh.last_used = entry.last_used;
+      fresh.in_flight = false;
+      fresh.refreshing = entry.refreshing;
+      entry = std::move(fresh);
+      if (refresh_enabled_ && !entry.addrs.empty())
+        ensure_worker();
+
+      if (cache_.size() > max_entries_)
+        evict(key, now);
+    }
+
+    // Bounds the cache (lock held): drops expired entries, then the least recently used
+    // ones. Entries with a lookup in flight and the key just stored are kept.
+    void evict(const Key& keep, clock::time_point now)
+    {
+      for (auto it = cache_.begin(); it != cache_.end();)
+      {
+        bool expired = !it->second.in_flight && it->second.expires <= now && it->first != keep;
+        it = expired ? cache_.erase(it) : std::next(it);
+      }
+      if (cache_.size() <= max_entries_)
+        return;
+
+      // Evict to 7/8 of the cap so the following inserts do not rescan the cache.
+      std::vector<std::map<Key, Entry>::iterator> candidates;
+      candidates.reserve(cache_.size());
+      for (auto it = cache_.begin(); it != cache_.end(); ++it)
+      {
+        if (!it->second.in_flight && it->first != keep)
+          candidates.push_back(it);
+      }
+      std::size_t excess = std::min(cache_.size() - (max_entries_ - max_entries_ / 8), candidates.size());
+      std::nth_element(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(excess), candidates.end(),
+        [](const auto& a, const auto& b) { return a->second.last_used < b->second.last_used; });
+      for (std::size_t i = 0; i < excess; ++i)
+        cache_.erase(candidates[i]);
+    }
+
+    // Queues a background lookup (lock held).
+    void schedule(const Key& key)
+    {
+      queue_.push_back(Job{ key, false, generation_ });
+      ensure_worker();
+      work_cv_.notify_one();
+    }
+
+    // Starts the background thread on first use (lock held).
+    void ensure_worker()
+    {
+      if (!worker_.joinable() && !stop_)
+        worker_ = std::thread([this]() { run(); });
+    }
+
+    // Background thread: serves try_resolve() misses and refreshes hot entries.
+    void run()
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      while (!stop_)
+      {
+        if (queue_.empty())
+        {
+          work_cv_.wait_for(lock, std::chrono::seconds(1));
+          if (stop_)
+            break;
+          if (refresh_enabled_)
+            collect_refreshes();
+          if (queue_.empty())
+            continue;
+        }
+
+        Job job = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        Entry fresh = lookup(job.key);
+        lock.lock();
+        if (job.refresh)
+        {
+          ++stats_.refreshes;
+          // A refresh of an entry that was cleared or evicted meanwhile is stale.
+          auto it = cache_.find(job.key);
+          if (job.generation != generation_ || it == cache_.end())
+            continue;
+          it->second.refreshing = false;
+          // A failed refresh keeps serving the last good answer until it expires.
+          if (fresh.addrs.empty() && !it->second.addrs.empty())
+            continue;
+        }
+        store(job.key, std::move(fresh));
+        done_cv_.notify_all();
+      }
+    }
+
+    // Queues entries used within the last TTL that expire within the next quarter TTL (lock held).
+    void collect_refreshes()
+    {
+      auto now = clock::now();
+      auto window = ttl_ / 4;
+      for (auto& [key, entry] : cache_)
+      {
+        if (entry.in_flight || entry.refreshing || entry.addrs.empty())
+          continue;
+        if (entry.expires - now <= window && now - entry.last_used <= ttl_)
+        {
+          entry.refreshing = true;
+          queue_.push_back(Job{ key, true, generation_ });
+        }
+      }
+    }
+
+    mutable std::mutex mtx_;
+    std::condition_variable work_cv_;  ///< Wakes the background thread.
+    std::condition_variable done_cv_;  ///< Signals completed lookups to waiting callers.
+    std::map<Key, Entry> cache_;
+    std::deque<Job> queue_; ///< Pending lookups.
+    std::thread worker_;
+    std::uint64_t generation_ = 0; ///< Number of clear() calls.
+    bool stop_ = false;
+    bool refresh_enabled_ = true;
+    std::chrono::milliseconds ttl_{ 60000 };
+    std::chrono::milliseconds negative_ttl_{ 5000 };
+    ResolverStats stats_;
+  };
+}
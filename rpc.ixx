@@ -0,0 +1,693 @@
+module;
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+#else
+  #include <sys/socket.h>
+#endif
+
+#include <mutex>
+
+#ifndef _MSC_VER
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides pipelined request/response RPC over one framed connection:
+// many calls in flight, replies matched by call id in any order, queued requests
+// batched into one write, per-call deadlines, and a server dispatching to an executor.
+
+export module net_io_adapters.rpc;
+
+#ifdef _MSC_VER
+import <atomic>;
+import <chrono>;
+import <condition_variable>;
+import <cstddef>;
+import <cstdint>;
+import <cstring>;
+import <exception>;
+import <functional>;
+import <future>;
+import <map>;
+import <span>;
+import <stdexcept>;
+import <string>;
+import <string_view>;
+import <thread>;
+import <unordered_map>;
+import <utility>;
+import <vector>;
+#endif
+
+import net_io;
+import net_io_concepts;
+import net_io_adapters.executors;
+import net_io_adapters.framed_stream;
+
+// The following imports are required for MSVC due to incomplete umbrella import support.
+import net_io.timer_wheel;
+
+export namespace net_io_adapters
+{
+    /// Why an RPC call failed (see RpcError::code()).
+    enum class RpcErrc
+    {
+        RemoteError,      ///< The handler threw or the method is unknown; what() has the server's message.
+        DeadlineExceeded, ///< No reply arrived before the call's deadline.
+        ConnectionClosed  ///< The connection ended or failed before the reply arrived.
+    };
+
+    /**
+     * @brief Exception stored in the future of a failed RPC call.
+     */
+    class RpcError : public std::runtime_error
+    {
+    public:
+        RpcError(RpcErrc code, const std::string& what)
+            : std::runtime_error(what), code_(code)
+        {
+        }
+
+        RpcErrc code() const noexcept { return code_; }
+
+    private:
+        RpcErrc code_;
+    };
+
+    /**
+     * @brief Configuration of RpcClient and RpcServer.
+     *
+     * - framing: Frame prefix, size limit and receive buffer of the connection.
+     * - max_batch: Queued frames sent per gathered write.
+     * - timeout: Deadline of RpcClient::call() without an explicit timeout.
+     * - timer_tick: Resolution of client deadlines; a call expires up to one tick late.
+     */
+    struct RpcOptions
+    {
+        FramingOptions            framing;
+        std::size_t               max_batch = 64;
+        std::chrono::milliseconds timeout{ 5000 };
+        std::chrono::milliseconds timer_tick{ 10 };
+    };
+
+    namespace detail
+    {
+        // Every frame starts with a kind byte and the 64-bit call id (big endian). A
+        // request continues with a method name (length byte + name) and the arguments;
+        // a reply with the result; an error with the message.
+        enum class RpcKind : std::uint8_t
+        {
+            Request = 0,
+            Reply = 1,
+            Error = 2
+        };
+
+        inline constexpr std::size_t rpc_header_size = 9;
+
+        inline void put_rpc_header(char* out, RpcKind kind, std::uint64_t id) noexcept
+        {
+            out[0] = static_cast<char>(kind);
+            for (int i = 0; i < 8; ++i)
+                out[1 + i] = static_cast<char>(id >> (56 - 8 * i));
+        }
+
+        inline std::uint64_t get_rpc_id(const char* in) noexcept
+        {
+            std::uint64_t id = 0;
+            for (int i = 0; i < 8; ++i)
+                id = (id << 8) | static_cast<unsigned char>(in[1 + i]);
+            return id;
+        }
+
+        inline std::string encode_rpc_request(std::uint64_t id, std::string_view method, std::span<const char> args)
+        {
+            if (method.size() > 255)
+                throw std::invalid_argument("RpcClient: method name longer than 255 bytes");
+            std::string frame(rpc_header_size + 1 + method.size() + args.size(), '\0');
+            put_rpc_header(frame.data(), RpcKind::Request, id);
+            frame[rpc_header_size] = static_cast<char>(method.size());
+            std::memcpy(frame.data() + rpc_header_size + 1, method.data(), method.size());
+            if (!args.empty())
+                std::memcpy(frame.data() + rpc_header_size + 1 + method.size(), args.data(), args.size());
+            return frame;
+        }
+
+        inline std::string encode_rpc_reply(RpcKind kind, std::uint64_t id, std::string_view body)
+        {
+            std::string frame(rpc_header_size + body.size(), '\0');
+            put_rpc_header(frame.data(), kind, id);
+            if (!body.empty())
+                std::memcpy(frame.data() + rpc_header_size, body.data(), body.size());
+            return frame;
+        }
+
+        // Sends queued frames in batches of max_batch gathered writes, then flushes.
+        template<typename Stream>
+        void send_rpc_frames(FramedStream<Stream>& framed, const std::vector<std::string>& batch,
+                             std::vector<std::span<const char>>& frames, std::size_t max_batch)
+        {
+            for (std::size_t first = 0; first < batch.size(); first += max_batch)
+            {
+                frames.clear();
+                for (std::size_t i = first; i < batch.size() && i < first + max_batch; ++i)
+                    frames.emplace_back(batch[i]);
+                framed.write_frames(frames);
+            }
+            framed.flush();
+        }
+
+        // Wakes a thread blocked in read() on the stream, if the stream offers a way.
+        template<typename Stream>
+        void shutdown_rpc_stream(Stream& stream) noexcept
+        {
+            if constexpr (requires { stream.shutdown(); })
+            {
+                stream.shutdown();
+            }
+            else if constexpr (requires { stream.native_handle(); })
+            {
+#ifdef _WIN32
+                ::shutdown(stream.native_handle(), SD_BOTH);
+#else
+                ::shutdown(stream.native_handle(), SHUT_RDWR);
+#endif
+            }
+            else if constexpr (requires { stream.transport(); })
+            {
+                shutdown_rpc_stream(stream.transport());
+            }
+        }
+    }
+
+    /**
+     * @brief Pipelined RPC client over one connection.
+     *
+     * call() queues the request and returns a future at once, so any number of calls can
+     * be in flight on the connection. Replies carry the call id and may arrive in any
+     * order. A writer thread sends everything queued since its last write as one batch of
+     * gathered writes; a reader thread completes the futures. Deadlines live on a
+     * TimerWheel driven by the writer thread; an expired call fails with
+     * RpcErrc::DeadlineExceeded and its late reply is discarded.
+     *
+     * The stream is read and written from different threads, which sockets and
+     * MemoryPipeTransport allow. close() (and the destructor) wakes the reader through
+     * the stream's shutdown() or native_handle(); for streams without either it waits
+     * until the peer closes.
+     *
+     * Example:
+     * @code
+     * TcpClient client(TcpEndpoint{"127.0.0.1", 9070});
+     * client.open();
+     * RpcClient rpc(std::move(client));
+     * std::future<std::string> a = rpc.call("echo", std::span<const char>("one", 3));
+     * std::future<std::string> b = rpc.call("echo", std::span<const char>("two", 3), std::chrono::milliseconds(100));
+     * std::string reply = a.get(); // throws RpcError on failure
+     * @endcode
+     */
+    template<typename Stream>
+        requires net_io_concepts::Readable<Stream> && net_io_concepts::Writable<Stream>
+    class RpcClient
+    {
+    public:
+        explicit RpcClient(Stream stream, RpcOptions options = {})
+            : framed_(std::move(stream), options.framing), options_(options), wheel_(options.timer_tick)
+        {
+            if (options_.max_batch == 0)
+                options_.max_batch = 1;
+            writer_ = std::thread([this] { write_loop(); });
+            reader_ = std::thread([this] { read_loop(); });
+        }
+
+        // Not copyable or movable: the I/O threads refer to this object.
+        RpcClient(const RpcClient&) = delete;
+        RpcClient& operator=(const RpcClient&) = delete;
+
+        ~RpcClient()
+        {
+            close();
+        }
+
+        /**
+         * @brief Start a call.
+         * @param method Method name (at most 255 bytes).
+         * @param args Request payload, copied before call() returns.
+         * @param timeout Deadline relative to now.
+         * @return The reply payload; the future throws RpcError if the call fails.
+         * @throws std::invalid_argument if the method name is too long.
+         */
+        std::future<std::string> call(std::string_view method, std::span<const char> args, std::chrono::milliseconds timeout)
+        {
+            std::uint64_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
+            std::string frame = detail::encode_rpc_request(id, method, args);
+            std::promise<std::string> promise;
+            std::future<std::string> result = promise.get_future();
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (closed_)
+            {
+                lock.unlock();
+                promise.set_exception(std::make_exception_ptr(RpcError(RpcErrc::ConnectionClosed, "RpcClient: connection closed")));
+                return result;
+            }
+            Call& call = calls_.try_emplace(id).first->second;
+            call.promise = std::move(promise);
+            call.timer.set_callback([this, id] { expired_.push_back(id); });
+            wheel_.schedule(call.timer, timeout);
+            outbox_.push_back(std::move(frame));
+            bool wake = writer_idle_;
+            writer_idle_ = false;
+            lock.unlock();
+            if (wake)
+                cv_.notify_one();
+            return result;
+        }
+
+        /// Start a call with the default timeout from RpcOptions.
+        std::future<std::string> call(std::string_view method, std::span<const char> args)
+        {
+            return call(method, args, options_.timeout);
+        }
+
+        /**
+         * @brief Stop the I/O threads and fail all outstanding calls (idempotent).
+         */
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stopping_)
+                    return;
+                stopping_ = true;
+            }
+            cv_.notify_all();
+            detail::shutdown_rpc_stream(framed_.stream());
+            if (writer_.joinable())
+                writer_.join();
+            if (reader_.joinable())
+                reader_.join();
+            std::unique_lock<std::mutex> lock(mutex_);
+            fail_all(lock);
+        }
+
+        /// Returns the number of calls waiting for a reply.
+        std::size_t outstanding() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return calls_.size();
+        }
+
+    private:
+        struct Call
+        {
+            std::promise<std::string> promise;
+            net_io::TimerWheel::Timer timer;
+        };
+
+        using CallMap = std::unordered_map<std::uint64_t, Call>;
+
+        void write_loop()
+        {
+            std::vector<std::string> batch;
+            std::vector<std::span<const char>> frames;
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_)
+            {
+                expire(lock);
+                if (!outbox_.empty())
+                {
+                    batch.swap(outbox_);
+                    lock.unlock();
+                    bool ok = true;
+                    try
+                    {
+                        detail::send_rpc_frames(framed_, batch, frames, options_.max_batch);
+                    }
+                    catch (...)
+                    {
+                        ok = false;
+                    }
+                    batch.clear();
+                    lock.lock();
+                    if (!ok)
+                    {
+                        fail_all(lock);
+                        detail::shutdown_rpc_stream(framed_.stream());
+                    }
+                    continue;
+                }
+                writer_idle_ = true;
+                if (auto next = wheel_.next_expiry())
+                    cv_.wait_until(lock, *next);
+                else
+                    cv_.wait(lock);
+                writer_idle_ = false;
+            }
+        }
+
+        void read_loop()
+        {
+            try
+            {
+                while (auto frame = framed_.read_frame())
+                {
+                    if (frame->size() < detail::rpc_header_size)
+                        break; // malformed reply: drop the connection
+                    auto kind = static_cast<detail::RpcKind>((*frame)[0]);
+                    std::uint64_t id = detail::get_rpc_id(frame->data());
+                    std::string_view body(frame->data() + detail::rpc_header_size, frame->size() - detail::rpc_header_size);
+
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    auto it = calls_.find(id);
+                    if (it == calls_.end())
+                        continue; // expired before the reply arrived
+                    it->second.timer.cancel();
+                    auto node = calls_.extract(it);
+                    lock.unlock();
+                    if (kind == detail::RpcKind::Reply)
+                        node.mapped().promise.set_value(std::string(body));
+                    else
+                        node.mapped().promise.set_exception(std::make_exception_ptr(RpcError(RpcErrc::RemoteError, std::string(body))));
+                }
+            }
+            catch (...)
+            {
+                // Read error or framing violation: fail everything below.
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            fail_all(lock);
+        }
+
+        // Fails calls whose timers fired. Called with the lock held; releases it while
+        // completing the futures.
+        void expire(std::unique_lock<std::mutex>& lock)
+        {
+            wheel_.advance(net_io::TimerWheel::clock::now());
+            if (expired_.empty())
+                return;
+            std::vector<typename CallMap::node_type> nodes;
+            nodes.reserve(expired_.size());
+            for (std::uint64_t id : expired_)
+            {
+                auto it = calls_.find(id);
+                if (it != calls_.end())
+                    nodes.push_back(calls_.extract(it));
+            }
+            expired_.clear();
+            lock.unlock();
+            for (auto& node : nodes)
+                node.mapped().promise.set_exception(std::make_exception_ptr(RpcError(RpcErrc::DeadlineExceeded, "RpcClient: deadline exceeded")));
+            nodes.clear();
+            lock.lock();
+        }
+
+        // Marks the connection closed and fails all outstanding calls. Called with the
+        // lock held; releases it while completing the futures.
+        void fail_all(std::unique_lock<std::mutex>& lock)
+        {
+            closed_ = true;
+            outbox_.clear();
+            expired_.clear();
+            for (auto& [id, call] : calls_)
+                call.timer.cancel();
+            CallMap calls = std::move(calls_);
+            calls_.clear();
+            lock.unlock();
+            for (auto& [id, call] : calls)
+                call.promise.set_exception(std::make_exception_ptr(RpcError(RpcErrc::ConnectionClosed, "RpcClient: connection closed")));
+            calls.clear();
+            lock.lock();
+        }
+
+        FramedStream<Stream> framed_;
+        RpcOptions options_;
+        std::atomic<std::uint64_t> next_id_{ 1 };
+
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        CallMap calls_;
+        std::vector<std::string> outbox_;
+        std::vector<std::uint64_t> expired_;
+        net_io::TimerWheel wheel_;
+        bool writer_idle_ = false;
+        bool closed_ = false;
+        bool stopping_ = false;
+
+        std::thread writer_;
+        std::thread reader_;
+    };
+
+    /**
+     * @brief RPC server: decodes requests of a connection and runs them on an executor.
+     *
+     * Register handlers with on() before serving. serve() reads requests on the calling
+     * thread and posts each one to the executor, so the requests of one connection run
+     * concurrently and their replies go out in completion order. Replies finished while
+     * another one is being written are batched into the next gathered write. A handler
+     * that throws produces an error reply (RpcErrc::RemoteError on the client), and so
+     * does a request the executor refuses or drops (e.g. RejectionPolicy::Discard).
+     *
+     * Example:
+     * @code
+     * ThreadPoolExecutor pool(4);
+     * RpcServer rpc(pool);
+     * rpc.on("echo", [](std::span<const char> args) { return std::string(args.data(), args.size()); });
+     * run_tcp_server(acceptor, [&](auto stream) { rpc.serve(std::move(stream)); }, running, TcpEndpoint{"127.0.0.1", 9070});
+     * @endcode
+     */
+    template<Executor E>
+    class RpcServer
+    {
+    public:
+        using Handler = std::function<std::string(std::span<const char>)>;
+
+        explicit RpcServer(E& executor, RpcOptions options = {})
+            : executor_(executor), options_(options)
+        {
+            if (options_.max_batch == 0)
+                options_.max_batch = 1;
+        }
+
+        RpcServer(const RpcServer&) = delete;
+        RpcServer& operator=(const RpcServer&) = delete;
+
+        /// Register (or replace) the handler of a method. Not thread-safe with serve().
+        void on(std::string method, Handler handler)
+        {
+            handlers_.insert_or_assign(std::move(method), std::move(handler));
+        }
+
+        /**
+         * @brief Serve one connection until the peer closes it.
+         *
+         * Returns after the replies of all started requests have been sent (or failed).
+         */
+        template<typename Stream>
+            requires net_io_concepts::Readable<Stream> && net_io_concepts::Writable<Stream>
+        void serve(Stream stream)
+        {
+            Connection<Stream> conn(*this, std::move(stream));
+            try
+            {
+                while (auto frame = conn.framed.read_frame())
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(conn.mutex);
+                        if (conn.broken)
+                            break;
+                        ++conn.in_flight;
+                    }
+                    // From here on the job owns the slot: if execute() throws or drops the
+                    // task (RejectionPolicy::Discard), its destructor answers and releases it.
+                    execute_unique(executor_, Job<Stream>(conn, std::string(frame->data(), frame->size())));
+                }
+            }
+            catch (...)
+            {
+                // Read error, framing violation or executor failure: stop reading.
+            }
+            std::unique_lock<std::mutex> lock(conn.mutex);
+            conn.idle.wait(lock, [&] { return conn.in_flight == 0; });
+        }
+
+    private:
+        template<typename Stream>
+        struct Connection;
+
+        // One request on its way through the executor. Running it dispatches the
+        // request; destroying it unrun sends an error reply instead, so the connection's
+        // in_flight count drops either way.
+        template<typename Stream>
+        struct Job
+        {
+            Job(Connection<Stream>& c, std::string r)
+                : conn(&c), request(std::move(r))
+            {
+            }
+
+            Job(Job&& other) noexcept
+                : conn(std::exchange(other.conn, nullptr)), request(std::move(other.request))
+            {
+            }
+
+            Job& operator=(Job&&) = delete;
+
+            ~Job()
+            {
+                if (conn)
+                    conn->reject(request);
+            }
+
+            void operator()()
+            {
+                std::exchange(conn, nullptr)->dispatch(request);
+            }
+
+            Connection<Stream>* conn;
+            std::string request;
+        };
+
+        template<typename Stream>
+        struct Connection
+        {
+            Connection(RpcServer& s, Stream stream)
+                : server(s), framed(std::move(stream), s.options_.framing)
+            {
+            }
+
+            void dispatch(const std::string& request)
+            {
+                std::string reply;
+                if (request.size() > detail::rpc_header_size
+                    && static_cast<detail::RpcKind>(request[0]) == detail::RpcKind::Request)
+                {
+                    std::uint64_t id = detail::get_rpc_id(request.data());
+                    std::size_t method_size = static_cast<unsigned char>(request[detail::rpc_header_size]);
+                    std::size_t args_offset = detail::rpc_header_size + 1 + method_size;
+                    if (args_offset <= request.size())
+                    {
+                        std::string_view method(request.data() + detail::rpc_header_size + 1, method_size);
+                        std::span<const char> args(request.data() + args_offset, request.size() - args_offset);
+                        auto it = server.handlers_.find(method);
+                        if (it == server.handlers_.end())
+                        {
+                            reply = detail::encode_rpc_reply(detail::RpcKind::Error, id, "unknown method: " + std::string(method));
+                        }
+                        else
+                        {
+                            try
+                            {
+                                reply = detail::encode_rpc_reply(detail::RpcKind::Reply, id, it->second(args));
+                            }
+                            catch (const std::exception& e)
+                            {
+                                reply = detail::encode_rpc_reply(detail::RpcKind::Error, id, e.what());
+                            }
+                            catch (...)
+                            {
+                                reply = detail::encode_rpc_reply(detail::RpcKind::Error, id, "unknown exception");
+                            }
+                        }
+                    }
+                }
+                if (!reply.empty())
+                    respond(std::move(reply));
+                finish();
+            }
+
+            // Answers a request the executor did not run (shut down, queue full).
+            void reject(const std::string& request) noexcept
+            {
+                try
+                {
+                    if (request.size() > detail::rpc_header_size
+                        && static_cast<detail::RpcKind>(request[0]) == detail::RpcKind::Request)
+                    {
+                        respond(detail::encode_rpc_reply(detail::RpcKind::Error, detail::get_rpc_id(request.data()),
+                                                         "request rejected by the server's executor"));
+                    }
+                }
+                catch (...)
+                {
+                    // No memory for the reply: the client's deadline covers the call.
+                }
+                finish();
+            }
+
+            // Queues a reply. The first thread to find no write in progress sends the
+            // queue, including replies added by other threads meanwhile.
+            void respond(std::string reply)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (broken)
+                    return;
+                outbox.push_back(std::move(reply));
+                if (writing)
+                    return;
+                writing = true;
+                std::vector<std::string> batch;
+                std::vector<std::span<const char>> frames;
+                while (!outbox.empty() && !broken)
+                {
+                    batch.swap(outbox);
+                    lock.unlock();
+                    bool ok = true;
+                    try
+                    {
+                        detail::send_rpc_frames(framed, batch, frames, server.options_.max_batch);
+                    }
+                    catch (...)
+                    {
+                        ok = false;
+                    }
+                    batch.clear();
+                    lock.lock();
+                    if (!ok)
+                    {
+                        broken = true;
+                        outbox.clear();
+                        detail::shutdown_rpc_stream(framed.stream());
+                    }
+                }
+                writing = false;
+            }
+
+            void finish()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--in_flight == 0)
+                    idle.notify_all();
+            }
+
+            RpcServer& server;
+            FramedStream<Stream> framed;
+            std::mutex mutex;
+            std::condition_variable idle;
+            std::vector<std::string> outbox;
+            std::size_t in_flight = 0;
+            bool writing = false;
+            bool broken = false;
+        };
+
+        E& executor_;
+        RpcOptions options_;
+        std::map<std::string, Handler, std::less<>> handlers_;
+    };
+}
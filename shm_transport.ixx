@@ -0,0 +1,549 @@
+module;
+
+#include <errno.h>
+
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#if defined(__linux__)
+  #include <linux/futex.h>  // Process-shared futex wait/wake on the mapping.
+  #include <sys/syscall.h>
+  #include <time.h>
+#endif
+
+#ifndef _MSC_VER
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#endif
+
+// This module provides a shared-memory transport for processes on the same host.
+// Two single-producer/single-consumer byte rings live in one shared mapping, so the
+// fast path of read() and write() is a memcpy plus a few atomic operations.
+
+export module net_io.shm_transport;
+
+#ifdef _MSC_VER
+import <algorithm>;
+import <atomic>;
+import <chrono>;
+import <cstddef>;
+import <cstdint>;
+import <cstring>;
+import <new>;
+import <optional>;
+import <stdexcept>;
+import <string>;
+import <thread>;
+import <utility>;
+#endif
+
+// Module imports (sorted)
+import net_io_base;
+import net_io_concepts;
+export import net_io_base; // Export sock_t and invalid_socket
+
+namespace net_io::detail
+{
+  static_assert(std::atomic<std::uint32_t>::is_always_lock_free &&
+                std::atomic<std::uint64_t>::is_always_lock_free,
+                "ShmTransport needs lock-free atomics in shared memory");
+
+  /// Control block of one SPSC ring. Producer and consumer fields sit on separate cache lines.
+  struct ShmRing
+  {
+    alignas(64) std::atomic<std::uint64_t> head;  ///< Total bytes written (producer-owned).
+    std::atomic<std::uint32_t> space_seq;         ///< Futex word the producer sleeps on.
+    std::atomic<std::uint32_t> producer_waiting;
+
+    alignas(64) std::atomic<std::uint64_t> tail;  ///< Total bytes read (consumer-owned).
+    std::atomic<std::uint32_t> data_seq;          ///< Futex word the consumer sleeps on.
+    std::atomic<std::uint32_t> consumer_waiting;
+
+    alignas(64) std::atomic<std::uint32_t> closed; ///< Set by either side on close().
+  };
+
+  /// Layout at the start of the mapping, followed by the data areas of both rings.
+  struct ShmHeader
+  {
+    std::atomic<std::uint32_t> magic;    ///< Written last by the creator.
+    std::atomic<std::uint32_t> attached; ///< Set by the single peer that attaches.
+    std::uint64_t capacity;              ///< Bytes per ring (power of two).
+    ShmRing rings[2];                    ///< [0]: creator -> peer, [1]: peer -> creator.
+  };
+
+  inline constexpr std::uint32_t shm_magic = 0x4e494f31; // "NIO1"
+  inline constexpr std::size_t shm_header_size = (sizeof(ShmHeader) + 4095) & ~std::size_t(4095);
+
+  // Waits while *word == expected, at most timeout. Spurious wakeups are fine for callers.
+  inline void shm_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected, std::chrono::milliseconds timeout) noexcept
+  {
+#if defined(__linux__)
+    // Not FUTEX_PRIVATE: the word lives in a mapping shared with another process.
+    timespec ts{ static_cast<time_t>(timeout.count() / 1000), static_cast<long>((timeout.count() % 1000) * 1000000) };
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+    // std::atomic::wait is not guaranteed to work across processes; poll instead.
+    (void)timeout;
+    if (word.load(std::memory_order_acquire) == expected)
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+  }
+
+  inline void shm_wake(std::atomic<std::uint32_t>& word) noexcept
+  {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+  }
+}
+
+export namespace net_io
+{
+  /**
+   * @brief Side of a ShmTransport.
+   *
+   * - Create: Creates and initializes the shared region (the "server" side).
+   * - Attach: Maps a region created by the other process.
+   */
+  enum class ShmRole
+  {
+    Create,
+    Attach
+  };
+
+  /**
+   * @brief Shared-memory byte-stream transport between two local processes (POSIX only).
+   *
+   * The region holds two single-producer/single-consumer rings, one per direction.
+   * read() and write() copy directly into and out of the mapping; a system call is made
+   * only when one side has to sleep (empty or full ring) and the other has to wake it.
+   * Sleeping uses a process-shared futex on Linux and short sleeps elsewhere.
+   * With set_busy_poll() a side spins for a while before sleeping, trading CPU for
+   * latency on ping-pong style traffic. Spinning only pays off when both processes run
+   * on their own cores; on an oversubscribed host it delays the peer instead.
+   *
+   * The region is either a named POSIX shared memory object (shm_open) or, on Linux,
+   * an anonymous memfd whose descriptor is passed to the peer, e.g. with
+   * UnixClient::send_fd(). Exactly one peer may attach to a region.
+   *
+   * Satisfies net_io_concepts::Transportable, so it works with make_stream() and the
+   * DataOutputStream/DataInputStream adapters. read() blocks until at least one byte is
+   * available and returns 0 once the peer closed and the ring is drained. There is no
+   * liveness check: if the peer dies without close(), a blocked read() or write() waits
+   * indefinitely, so pair the transport with an out-of-band health check where that matters.
+   *
+   * Example usage:
+   * @code
+   * // Process A
+   * net_io::ShmTransport a("/myapp-shm", net_io::ShmRole::Create, 1 << 20);
+   * a.open();
+   * // Process B
+   * net_io::ShmTransport b("/myapp-shm", net_io::ShmRole::Attach);
+   * b.open();
+   * auto stream = net_io_adapters::make_stream(std::move(b));
+   *
+   * // Anonymous region handed over a Unix socket (Linux)
+   * auto shm = net_io::ShmTransport::anonymous(1 << 20);
+   * link.send_fd(shm.native_handle());
+   * net_io::ShmTransport peer(link_peer.recv_fd(), net_io::ShmRole::Attach); // other process
+   * peer.open();
+   * @endcode
+   */
+  class ShmTransport
+  {
+  public:
+    /**
+     * @brief Construct a transport for a named shared memory object (does not map yet).
+     * @param name POSIX shm name, e.g. "/myapp-shm".
+     * @param role Whether open() creates the region or attaches to it.
+     * @param capacity Bytes per direction (Create only); rounded up to a power of two.
+     */
+    ShmTransport(std::string name, ShmRole role, std::size_t capacity = 1 << 20)
+      : name_(std::move(name)), role_(role), capacity_(round_capacity(capacity))
+    {
+      if (name_.empty())
+        throw std::invalid_argument("ShmTransport: empty name");
+    }
+
+    /**
+     * @brief Construct a transport for an existing shared memory descriptor (takes ownership).
+     * @param fd Descriptor of the region, e.g. received with UnixClient::recv_fd().
+     * @param role Attach for a received region; Create to initialize a fresh one.
+     * @param capacity Bytes per direction (Create only).
+     */
+    explicit ShmTransport(int fd, ShmRole role = ShmRole::Attach, std::size_t capacity = 1 << 20)
+      : role_(role), capacity_(round_capacity(capacity)), fd_(fd)
+    {}
+
+    /**
+     * @brief Create an anonymous region (memfd on Linux) and map it.
+     * @param capacity Bytes per direction.
+     * @return An opened transport; pass native_handle() to the peer process.
+     * @throws SocketException if the region cannot be created.
+     */
+    static ShmTransport anonymous(std::size_t capacity = 1 << 20)
+    {
+#if defined(__linux__)
+      int fd = ::memfd_create("net_io-shm", MFD_CLOEXEC);
+      if (fd < 0)
+        throw SocketException("memfd_create() failed", errno);
+      ShmTransport transport(fd, ShmRole::Create, capacity);
+      transport.open();
+      return transport;
+#else
+      (void)capacity;
+      throw SocketException("ShmTransport::anonymous(): memfd is Linux-only", 0);
+#endif
+    }
+
+    // Not copyable: the mapping and descriptor have a single owner.
+    ShmTransport(const ShmTransport&) = delete;
+    ShmTransport& operator=(const ShmTransport&) = delete;
+
+    ShmTransport(ShmTransport&& other) noexcept
+      : name_(std::move(other.name_))
+      , role_(other.role_)
+      , capacity_(other.capacity_)
+      , fd_(std::exchange(other.fd_, -1))
+      , base_(std::exchange(other.base_, nullptr))
+      , map_size_(std::exchange(other.map_size_, 0))
+      , busy_poll_(other.busy_poll_)
+      , owns_name_(std::exchange(other.owns_name_, false))
+      , attached_(std::exchange(other.attached_, false))
+    {}
+
+    ShmTransport& operator=(ShmTransport&& other) noexcept
+    {
+      if (this != &other)
+      {
+        close();
+        name_ = std::move(other.name_);
+        role_ = other.role_;
+        capacity_ = other.capacity_;
+        fd_ = std::exchange(other.fd_, -1);
+        base_ = std::exchange(other.base_, nullptr);
+        map_size_ = std::exchange(other.map_size_, 0);
+        busy_poll_ = other.busy_poll_;
+        owns_name_ = std::exchange(other.owns_name_, false);
+        attached_ = std::exchange(other.attached_, false);
+      }
+      return *this;
+    }
+
+    ~ShmTransport()
+    {
+      close();
+    }
+
+    /**
+     * @brief Create or attach to the shared region and map it.
+     * @throws SocketException if the region cannot be opened, mapped or validated,
+     *         or if another peer is already attached.
+     */
+    void open()
+    {
+#if defined(_WIN32)
+      throw SocketException("ShmTransport is not supported on Windows", 0);
+#else
+      if (base_)
+        return;
+      if (fd_ < 0)
+      {
+        int flags = role_ == ShmRole::Create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR;
+        fd_ = ::shm_open(name_.c_str(), flags, 0600);
+        if (fd_ < 0)
+          throw SocketException("shm_open() failed", errno, name_);
+        owns_name_ = role_ == ShmRole::Create;
+      }
+
+      if (role_ == ShmRole::Create)
+      {
+        map_size_ = detail::shm_header_size + 2 * capacity_;
+        if (::ftruncate(fd_, static_cast<off_t>(map_size_)) < 0)
+          fail("ftruncate() failed", errno);
+        map(map_size_);
+        auto* hdr = new (base_) detail::ShmHeader{};
+        hdr->capacity = capacity_;
+        hdr->magic.store(detail::shm_magic, std::memory_order_release);
+        attached_ = true;
+      }
+      else
+      {
+        struct stat st{};
+        if (::fstat(fd_, &st) < 0)
+          fail("fstat() failed", errno);
+        if (static_cast<std::size_t>(st.st_size) < detail::shm_header_size)
+          fail("ShmTransport: region not initialized", 0);
+        map(static_cast<std::size_t>(st.st_size));
+        auto* hdr = header();
+        if (hdr->magic.load(std::memory_order_acquire) != detail::shm_magic ||
+            detail::shm_header_size + 2 * hdr->capacity != map_size_)
+          fail("ShmTransport: invalid region", 0);
+        if (hdr->attached.exchange(1, std::memory_order_acq_rel) != 0)
+          fail("ShmTransport: region already has a peer", EBUSY);
+        capacity_ = hdr->capacity;
+        attached_ = true;
+      }
+#endif
+    }
+
+    /**
+     * @brief Close this side (idempotent).
+     *
+     * The peer's read() returns 0 once it drained the remaining data, and its write()
+     * throws. The creator of a named region also removes the name. A side whose open()
+     * failed (e.g. a rejected second peer) never touches the shared header, so it
+     * cannot end the session of the two sides that own the region.
+     */
+    void close() noexcept
+    {
+#if !defined(_WIN32)
+      if (base_)
+      {
+        if (attached_)
+        {
+          for (auto& ring : header()->rings)
+          {
+            ring.closed.store(1, std::memory_order_seq_cst);
+            ring.data_seq.fetch_add(1, std::memory_order_release);
+            ring.space_seq.fetch_add(1, std::memory_order_release);
+            detail::shm_wake(ring.data_seq);
+            detail::shm_wake(ring.space_seq);
+          }
+          attached_ = false;
+        }
+        ::munmap(base_, map_size_);
+        base_ = nullptr;
+        map_size_ = 0;
+      }
+      if (fd_ >= 0)
+      {
+        ::close(fd_);
+        fd_ = -1;
+      }
+      if (owns_name_)
+      {
+        ::shm_unlink(name_.c_str());
+        owns_name_ = false;
+      }
+#endif
+    }
+
+    /**
+     * @brief Write all bytes, blocking while the outgoing ring is full.
+     * @throws SocketException if the transport is not open or the peer has closed.
+     */
+    void write(const char* data, std::size_t size)
+    {
+      if (!base_)
+        throw SocketException("ShmTransport::write(): not open", 0);
+      detail::ShmRing& ring = out_ring();
+      char* area = out_area();
+      const std::uint64_t mask = capacity_ - 1;
+
+      while (size > 0)
+      {
+        std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+        std::uint64_t free = capacity_ - (head - ring.tail.load(std::memory_order_acquire));
+        if (free == 0)
+        {
+          if (!wait_until([&] { return head - ring.tail.load(std::memory_order_seq_cst) < capacity_; },
+                          ring.space_seq, ring.producer_waiting, ring.closed))
+            throw SocketException("ShmTransport::write(): peer closed", EPIPE);
+          continue;
+        }
+        if (ring.closed.load(std::memory_order_relaxed))
+          throw SocketException("ShmTransport::write(): peer closed", EPIPE);
+
+        std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(free, size));
+        std::size_t offset = static_cast<std::size_t>(head & mask);
+        std::size_t first = std::min(n, static_cast<std::size_t>(capacity_) - offset);
+        std::memcpy(area + offset, data, first);
+        std::memcpy(area, data + first, n - first);
+        ring.head.store(head + n, std::memory_order_seq_cst);
+
+        if (ring.consumer_waiting.load(std::memory_order_seq_cst))
+        {
+          ring.data_seq.fetch_add(1, std::memory_order_release);
+          detail::shm_wake(ring.data_seq);
+        }
+        data += n;
+        size -= n;
+      }
+    }
+
+    /**
+     * @brief Read up to size bytes, blocking until at least one byte is available.
+     * @return Number of bytes read, or 0 if the peer closed (or the transport is not open).
+     */
+    std::size_t read(char* data, std::size_t size)
+    {
+      if (!base_ || size == 0)
+        return 0;
+      detail::ShmRing& ring = in_ring();
+      const char* area = in_area();
+      const std::uint64_t mask = capacity_ - 1;
+
+      std::uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+      std::uint64_t avail = ring.head.load(std::memory_order_acquire) - tail;
+      if (avail == 0)
+      {
+        if (!wait_until([&] { return ring.head.load(std::memory_order_seq_cst) != tail; },
+                        ring.data_seq, ring.consumer_waiting, ring.closed))
+          return 0;
+        avail = ring.head.load(std::memory_order_acquire) - tail;
+      }
+
+      std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(avail, size));
+      std::size_t offset = static_cast<std::size_t>(tail & mask);
+      std::size_t first = std::min(n, static_cast<std::size_t>(capacity_) - offset);
+      std::memcpy(data, area + offset, first);
+      std::memcpy(data + first, area, n - first);
+      ring.tail.store(tail + n, std::memory_order_seq_cst);
+
+      if (ring.producer_waiting.load(std::memory_order_seq_cst))
+      {
+        ring.space_seq.fetch_add(1, std::memory_order_release);
+        detail::shm_wake(ring.space_seq);
+      }
+      return n;
+    }
+
+    /**
+     * @brief Spin this many iterations on an empty/full ring before sleeping (0 = never spin).
+     */
+    void set_busy_poll(unsigned spins) noexcept
+    {
+      busy_poll_ = spins;
+    }
+
+    /// Returns whether the region is mapped.
+    bool is_open() const noexcept
+    {
+      return base_ != nullptr;
+    }
+
+    /// Returns the descriptor of the region (e.g. to pass a memfd to the peer).
+    int native_handle() const noexcept
+    {
+      return fd_;
+    }
+
+    /// Returns the ring capacity per direction in bytes.
+    std::size_t capacity() const noexcept
+    {
+      return static_cast<std::size_t>(capacity_);
+    }
+
+  private:
+    static std::uint64_t round_capacity(std::size_t capacity)
+    {
+      std::uint64_t c = 4096;
+      while (c < capacity)
+        c <<= 1;
+      return c;
+    }
+
+    detail::ShmHeader* header() const noexcept
+    {
+      return static_cast<detail::ShmHeader*>(base_);
+    }
+
+    // The creator writes ring 0 and reads ring 1; the attached peer does the opposite.
+    std::size_t out_index() const noexcept { return role_ == ShmRole::Create ? 0 : 1; }
+    detail::ShmRing& out_ring() const noexcept { return header()->rings[out_index()]; }
+    detail::ShmRing& in_ring() const noexcept { return header()->rings[1 - out_index()]; }
+    char* out_area() const noexcept
+    {
+      return static_cast<char*>(base_) + detail::shm_header_size + out_index() * capacity_;
+    }
+    const char* in_area() const noexcept
+    {
+      return static_cast<char*>(base_) + detail::shm_header_size + (1 - out_index()) * capacity_;
+    }
+
+    /**
+     * Spins (if enabled), then sleeps on the futex word until ready() holds.
+     * Returns false if the ring was closed first. The waiting flag is published
+     * before ready() is re-checked, so the other side either sees the flag or
+     * we see its update (both use seq_cst), and no wakeup is lost.
+     */
+    template<typename Ready>
+    bool wait_until(Ready ready, std::atomic<std::uint32_t>& seq,
+                    std::atomic<std::uint32_t>& waiting, std::atomic<std::uint32_t>& closed)
+    {
+      for (unsigned i = 0; i < busy_poll_; ++i)
+      {
+        if (ready())
+          return true;
+        if (closed.load(std::memory_order_relaxed))
+          break;
+      }
+      while (true)
+      {
+        std::uint32_t observed = seq.load(std::memory_order_acquire);
+        waiting.store(1, std::memory_order_seq_cst);
+        if (ready())
+        {
+          waiting.store(0, std::memory_order_relaxed);
+          return true;
+        }
+        if (closed.load(std::memory_order_seq_cst))
+        {
+          waiting.store(0, std::memory_order_relaxed);
+          return false;
+        }
+        // The sleep is bounded only so the flags are re-checked now and then; the loop
+        // itself waits without limit, also for a peer that died without close().
+        detail::shm_wait(seq, observed, std::chrono::milliseconds(100));
+        waiting.store(0, std::memory_order_relaxed);
+      }
+    }
+
+#if !defined(_WIN32)
+    void map(std::size_t size)
+    {
+      void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+      if (p == MAP_FAILED)
+        fail("mmap() failed", errno);
+      base_ = p;
+      map_size_ = size;
+    }
+
+    [[noreturn]] void fail(const char* msg, int err)
+    {
+      std::string name = name_;
+      close();
+      throw SocketException(msg, err, name.empty() ? std::nullopt : std::optional<std::string>(name));
+    }
+#endif
+
+    std::string   name_;
+    ShmRole       role_ = ShmRole::Create;
+    std::uint64_t capacity_ = 0;
+    int           fd_ = -1;
+    void*         base_ = nullptr;
+    std::size_t   map_size_ = 0;
+    unsigned      busy_poll_ = 0;
+    bool          owns_name_ = false;
+    bool          attached_ = false; ///< open() succeeded; close() then signals the peer.
+  };
+
+  static_assert(net_io_concepts::Transportable<ShmTransport>, "ShmTransport does not implement Transportable concept!");
+}
@@ -0,0 +1,287 @@
+module;
+
+#ifndef _MSC_VER
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#endif
+
+// This module provides task<T>, the lazily started coroutine type used by the
+// asynchronous net_io API. Awaiting a task transfers control symmetrically, and
+// coroutine frames are recycled through a per-thread freelist.
+
+export module net_io.task;
+
+#ifdef _MSC_VER
+import <array>;
+import <coroutine>;
+import <cstddef>;
+import <exception>;
+import <new>;
+import <optional>;
+import <type_traits>;
+import <utility>;
+#endif
+
+export namespace net_io
+{
+  template<typename T = void>
+  class task;
+
+  namespace detail
+  {
+    /**
+     * @brief Per-thread freelist for coroutine frames.
+     *
+     * Frame sizes are rounded up to 64 bytes; frames up to max_size are kept on a
+     * freelist per size class when released and handed out again on the next
+     * allocation of the same class. A connection handler that is spawned per accepted
+     * socket therefore allocates only while the number of live handlers grows.
+     * Frames released on another thread go to that thread's freelist.
+     */
+    class FramePool
+    {
+    public:
+      static constexpr std::size_t granularity = 64;
+      static constexpr std::size_t max_size = 4096;
+      static constexpr std::size_t max_cached = 1024; ///< Per size class.
+
+      static void* allocate(std::size_t size)
+      {
+        if (size > max_size)
+          return ::operator new(size);
+        Bucket& b = local().buckets_[index(size)];
+        if (b.head)
+        {
+          Node* n = b.head;
+          b.head = n->next;
+          --b.count;
+          return n;
+        }
+        return ::operator new(round(size));
+      }
+
+      static void deallocate(void* p, std::size_t size) noexcept
+      {
+        if (size > max_size)
+        {
+          ::operator delete(p);
+          return;
+        }
+        Bucket& b = local().buckets_[index(size)];
+        if (b.count >= max_cached)
+        {
+          ::operator delete(p);
+          return;
+        }
+        Node* n = static_cast<Node*>(p);
+        n->next = b.head;
+        b.head = n;
+        ++b.count;
+      }
+
+      ~FramePool()
+      {
+        for (Bucket& b : buckets_)
+        {
+          while (b.head)
+          {
+            Node* n = b.head;
+            b.head = n->next;
+            ::operator delete(n);
+          }
+        }
+      }
+
+    private:
+      struct Node { Node* next; };
+      struct Bucket
+      {
+        Node* head = nullptr;
+        std::size_t count = 0;
+      };
+
+      static constexpr std::size_t round(std::size_t size)
+      {
+        return (size + granularity - 1) / granularity * granularity;
+      }
+      static constexpr std::size_t index(std::size_t size)
+      {
+        return round(size) / granularity - 1;
+      }
+
+      static FramePool& local()
+      {
+        thread_local FramePool pool;
+        return pool;
+      }
+
+      std::array<Bucket, max_size / granularity> buckets_{};
+    };
+
+    /// Allocation and continuation handling shared by all promise types.
+    struct PromiseBase
+    {
+      struct FinalAwaiter
+      {
+        bool await_ready() const noexcept { return false; }
+
+        // Symmetric transfer: resume the awaiting coroutine without growing the stack.
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+        {
+          if (auto c = h.promise().continuation)
+            return c;
+          return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+      };
+
+      std::suspend_always initial_suspend() const noexcept { return {}; }
+      FinalAwaiter final_suspend() const noexcept { return {}; }
+      void unhandled_exception() noexcept { error = std::current_exception(); }
+
+      static void* operator new(std::size_t size) { return FramePool::allocate(size); }
+      static void operator delete(void* p, std::size_t size) noexcept { FramePool::deallocate(p, size); }
+
+      std::coroutine_handle<> continuation;
+      std::exception_ptr error;
+    };
+
+    template<typename T>
+    struct Promise : PromiseBase
+    {
+      task<T> get_return_object() noexcept;
+
+      template<typename U>
+        requires std::is_convertible_v<U&&, T>
+      void return_value(U&& value) noexcept(std::is_nothrow_constructible_v<T, U&&>)
+      {
+        result.emplace(std::forward<U>(value));
+      }
+
+      T take()
+      {
+        if (error)
+          std::rethrow_exception(error);
+        return std::move(*result);
+      }
+
+      std::optional<T> result;
+    };
+
+    template<>
+    struct Promise<void> : PromiseBase
+    {
+      task<void> get_return_object() noexcept;
+
+      void return_void() noexcept {}
+
+      void take()
+      {
+        if (error)
+          std::rethrow_exception(error);
+      }
+    };
+  }
+
+  /**
+   * @brief Lazily started coroutine returning a T.
+   *
+   * The body runs when the task is awaited (or handed to EventLoop::spawn()); the
+   * awaiting coroutine is resumed by symmetric transfer when the body finishes, so
+   * long await chains neither grow the stack nor go through a scheduler queue.
+   * Exceptions thrown in the body are rethrown at the co_await. A task is move-only
+   * and destroys its frame when it goes out of scope.
+   *
+   * Example usage:
+   * @code
+   * net_io::task<std::size_t> read_header(net_io::TcpClient& c, std::span<char> buf)
+   * {
+   *     co_return co_await c.async_read(buf);
+   * }
+   * @endcode
+   */
+  template<typename T>
+  class [[nodiscard]] task
+  {
+  public:
+    using promise_type = detail::Promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    task() noexcept = default;
+    explicit task(handle_type h) noexcept : h_(h) {}
+
+    task(task&& other) noexcept : h_(std::exchange(other.h_, {})) {}
+    task& operator=(task&& other) noexcept
+    {
+      if (this != &other)
+      {
+        if (h_)
+          h_.destroy();
+        h_ = std::exchange(other.h_, {});
+      }
+      return *this;
+    }
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    ~task()
+    {
+      if (h_)
+        h_.destroy();
+    }
+
+    /// Returns true if the task holds a coroutine.
+    bool valid() const noexcept { return static_cast<bool>(h_); }
+
+    /// Returns true if the coroutine has run to completion.
+    bool done() const noexcept { return !h_ || h_.done(); }
+
+    auto operator co_await() && noexcept
+    {
+      struct Awaiter
+      {
+        handle_type h;
+
+        bool await_ready() const noexcept { return !h || h.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+          h.promise().continuation = awaiting;
+          return h;
+        }
+
+        T await_resume() { return h.promise().take(); }
+      };
+      return Awaiter{ h_ };
+    }
+
+    /// Releases ownership of the coroutine frame.
+    handle_type release() noexcept { return std::exchange(h_, {}); }
+
+  private:
+    handle_type h_;
+  };
+
+  namespace detail
+  {
+    template<typename T>
+    task<T> Promise<T>::get_return_object() noexcept
+    {
+      return task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+    }
+
+    inline task<void> Promise<void>::get_return_object() noexcept
+    {
+      return task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+    }
+  }
+}
@@ -9,42 +9,97 @@ module;
   #pragma comment(lib, "ws2_32.lib")
 #else
   #include <netdb.h>
+  #include <netinet/in.h>
+  #include <poll.h>
   #include <sys/socket.h>
   #include <unistd.h>
 #endif
 
+#if defined(__linux__)
+  #include <linux/errqueue.h> // sock_extended_err for MSG_ZEROCOPY completions.
+#endif
+
 #ifndef _MSC_VER
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <exception>
+#include <future>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
-#include <iostream>
 #include <optional>
+#include <span>
 #endif
 
 export module net_io.tcp_client;
 
 #ifdef _MSC_VER
+import <algorithm>;
+import <chrono>;
 import <cstdint>;
 import <cstring>;
+import <exception>;
+import <future>;
+import <memory>;
 import <stdexcept>;
 import <string>;
 import <utility>;
 import <vector>;
-import <iostream>;
 import <optional>;
+import <span>;
 #endif
 
 // Module imports (sorted)
 import net_io_base;
 import net_io_concepts;
+import net_io.event_loop;
+import net_io.log;
 import net_io.tcp_endpoint;
 export import net_io_base; // Export sock_t and invalid_socket
 
 export namespace net_io
 {
+  /**
+   * @brief Counters describing the zero-copy send path of a TcpClient.
+   *
+   * - zerocopy_sends: send() calls issued with MSG_ZEROCOPY.
+   * - threshold_copies: payloads below the threshold that were sent with a normal copy.
+   * - kernel_copies: zero-copy sends the kernel completed by copying anyway
+   *   (e.g. loopback or devices without scatter-gather support).
+   * - completions: zero-copy sends whose buffers have been released by the kernel.
+   */
+  struct ZeroCopyStats
+  {
+    std::uint64_t zerocopy_sends   = 0;
+    std::uint64_t threshold_copies = 0;
+    std::uint64_t kernel_copies    = 0;
+    std::uint64_t completions      = 0;
+  };
+
+  /**
+   * @brief Record of one connection attempt made by TcpClient::open() or async_open().
+   *
+   * - address: The candidate address that was tried.
+   * - started: Offset of the attempt start from the beginning of the open call.
+   * - elapsed: Time from the attempt start until it connected, failed or was abandoned.
+   * - error: The socket error of a failed attempt (0 otherwise).
+   * - outcome: Connected (the winner), Failed, Cancelled (lost the race) or TimedOut.
+   */
+  struct ConnectAttempt
+  {
+    enum class Outcome { Connected, Failed, Cancelled, TimedOut };
+
+    sockaddr_storage          address{};
+    std::chrono::microseconds started{0};
+    std::chrono::microseconds elapsed{0};
+    int                       error = 0;
+    Outcome                   outcome = Outcome::Failed;
+  };
+
   /**
    * @brief TCP client for connecting to remote endpoints.
    *
@@ -71,7 +126,7 @@ export namespace net_io
      * @param fd The socket handle (must be a valid TCP socket).
      */
     explicit TcpClient(sock_t fd)
-      : fd_(fd), ep_(std::nullopt)
+      : fd_(fd), ep_(std::nullopt), nonblocking_(net_io::is_nonblocking(fd))
     {}
 
     /**
@@ -90,12 +145,19 @@ export namespace net_io
      * @brief Move constructor.
      *
      * Transfers ownership of the socket and endpoint from another TcpClient.
-     * The moved-from object is left in a valid but unspecified state.
+     * The moved-from object is left in a valid but unspecified state. A connect started
+     * by other.open_async() is waited for before anything is taken over.
      */
     TcpClient(TcpClient&& other) noexcept
-      : fd_(other.fd_), ep_(std::move(other.ep_))
+      : fd_((other.wait_pending_open(), other.fd_)), ep_(std::move(other.ep_))
+      , connect_timeout_ms_(other.connect_timeout_ms_)
+      , attempt_delay_ms_(other.attempt_delay_ms_)
+      , attempts_(std::move(other.attempts_))
+      , zc_(std::move(other.zc_))
+      , nonblocking_(other.nonblocking_)
     {
       other.fd_ = invalid_socket;
+      other.zc_ = ZeroCopyState{};
     }
 
     /**
@@ -108,10 +170,18 @@ export namespace net_io
     {
       if (this != &other)
       {
+        wait_pending_open();
+        other.wait_pending_open();
         close();
         fd_ = other.fd_;
         ep_ = std::move(other.ep_);
+        connect_timeout_ms_ = other.connect_timeout_ms_;
+        attempt_delay_ms_ = other.attempt_delay_ms_;
+        attempts_ = std::move(other.attempts_);
+        zc_ = std::move(other.zc_);
+        nonblocking_ = other.nonblocking_;
         other.fd_ = invalid_socket;
+        other.zc_ = ZeroCopyState{};
       }
       return *this;
     }
@@ -121,6 +191,7 @@ export namespace net_io
      */
     ~TcpClient()
     {
+      wait_pending_open();
       // Niemals Exception im Destruktor werfen!
       try {
         close();
@@ -131,12 +202,25 @@ export namespace net_io
 
     /**
      * @brief Open a connection to the stored TCP endpoint.
-     * @throws SocketException if the endpoint is not set or if the connection fails.
+     * @throws SocketException if the endpoint is not set, if every candidate address fails,
+     *         or if the connect timeout expires (error code ETIMEDOUT).
      *
-     * This method creates a socket and connects to the endpoint specified in the constructor.
-     * On failure, the socket is closed and an exception is thrown.
+     * All addresses the endpoint resolves to are raced Happy-Eyeballs style (RFC 8305):
+     * address families are interleaved, a new attempt starts every attempt delay or as soon
+     * as the previous one fails, the first established connection wins and the others are
+     * closed. The per-attempt timings are available from last_connect_attempts().
      */
     void open()
+    {
+      open(connect_timeout_ms_);
+    }
+
+    /**
+     * @brief Open a connection with an explicit timeout.
+     * @param timeout_ms Upper bound for the whole connect in milliseconds (-1 = no timeout).
+     * @throws SocketException as open().
+     */
+    void open(int timeout_ms)
     {
       if (!ep_)
         throw SocketException("open() failed: no endpoint set", 0);
@@ -144,56 +228,294 @@ export namespace net_io
 #if defined(_WIN32)
       detail::ensure_wsa();
 #endif
-      auto addr = ep_->to_sockaddr(false);
-      socklen_t len = sizeof(addr);
+      close();
+      fd_ = connect_happy_eyeballs(ep_->resolve(), timeout_ms);
+      log_message<LogLevel::Debug>("TcpClient", [&] { return "open() success, fd_=" + std::to_string(fd_); });
+    }
 
-      fd_ = ::socket(addr.ss_family, SOCK_STREAM, 0);
-      if (fd_ == invalid_socket)
+    /**
+     * @brief Open the connection on a background thread.
+     * @param timeout_ms Upper bound for the connect in milliseconds (-1 = connect timeout setting).
+     * @return Future that becomes ready when open() completed or failed.
+     *
+     * The client must not be used until the future is ready. Destroying, moving or
+     * assigning the client waits for the background connect to finish first.
+     *
+     * Example:
+     * @code
+     * auto pending = client.open_async(2000);
+     * // ... other work ...
+     * pending.get(); // rethrows connect errors
+     * @endcode
+     */
+    std::future<void> open_async(int timeout_ms = -1)
+    {
+      wait_pending_open();
+      int effective = timeout_ms >= 0 ? timeout_ms : connect_timeout_ms_;
+      // The caller's future is separate from pending_open_, so dropping it does not
+      // block and the client can still wait for the work that refers to it.
+      auto done = std::make_shared<std::promise<void>>();
+      std::future<void> result = done->get_future();
+      pending_open_ = std::async(std::launch::async, [this, effective, done]()
+      {
+        try
+        {
+          open(effective);
+          done->set_value();
+        }
+        catch (...)
+        {
+          done->set_exception(std::current_exception());
+        }
+      });
+      return result;
+    }
+
+    /**
+     * @brief Connect on the calling coroutine's EventLoop without blocking the loop.
+     * @param timeout_ms Upper bound for the whole connect in milliseconds (-1 = connect timeout setting).
+     * @throws SocketException (at the co_await) if the endpoint is not set, if every candidate
+     *         address fails, or if the timeout expires (error code ETIMEDOUT).
+     *
+     * The addresses the endpoint resolves to are tried one after another with nonblocking
+     * connects; the deadline is kept on the loop's timer wheel. Each attempt gets an equal
+     * share of the time left, so an unreachable first address does not use up the whole
+     * timeout and the next candidate is still tried. Name resolution goes through
+     * the Resolver cache and may block on a cache miss. Each candidate tried is recorded
+     * in last_connect_attempts(); an attempt whose share ran out is marked TimedOut.
+     *
+     * Example:
+     * @code
+     * net_io::TcpClient client(net_io::TcpEndpoint("example.com", 80));
+     * co_await client.async_open(2000);
+     * @endcode
+     */
+    task<void> async_open(int timeout_ms = -1)
+    {
+      if (!ep_)
+        throw SocketException("async_open() failed: no endpoint set", 0);
+#if defined(_WIN32)
+      detail::ensure_wsa();
+#endif
+      close();
+      attempts_.clear();
+      if (timeout_ms < 0)
+        timeout_ms = connect_timeout_ms_;
+      const auto begin = EventLoop::clock::now();
+      const auto deadline = begin + std::chrono::milliseconds(timeout_ms);
+      const auto since_begin = [&](EventLoop::clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t - begin);
+      };
+
+      const std::vector<sockaddr_storage> candidates = ep_->resolve();
+      int last_error = 0;
+      for (std::size_t i = 0; i < candidates.size(); ++i)
       {
-        std::cerr << "[TcpClient] socket() failed, fd_=" << fd_ << std::endl;
-        throw SocketException("socket() failed", errno);
+        const auto& addr = candidates[i];
+        const auto now = EventLoop::clock::now();
+        if (timeout_ms >= 0 && now >= deadline)
+        {
+          last_error = ETIMEDOUT;
+          break;
+        }
+        ConnectAttempt started_rec;
+        started_rec.address = addr;
+        started_rec.started = since_begin(now);
+        attempts_.push_back(started_rec);
+        const std::size_t index = attempts_.size() - 1;
+        const auto finish = [&](ConnectAttempt::Outcome outcome, int error) {
+          auto& rec = attempts_[index];
+          rec.elapsed = since_begin(EventLoop::clock::now()) - rec.started;
+          rec.outcome = outcome;
+          rec.error = error;
+        };
+
+        sock_t fd = ::socket(addr.ss_family, SOCK_STREAM, 0);
+        if (fd == invalid_socket)
+        {
+          last_error = last_socket_error();
+          finish(ConnectAttempt::Outcome::Failed, last_error);
+          continue;
+        }
+        set_socket_option(fd, SocketOption::NonBlocking, 1);
+        int err = 0;
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sockaddr_length(addr)) != 0)
+          err = last_socket_error();
+#if defined(_WIN32)
+        const bool pending = err == WSAEWOULDBLOCK;
+#else
+        const bool pending = err == EINPROGRESS;
+#endif
+        if (pending)
+        {
+          // Writable means the connect finished; getpeername() tells whether it succeeded.
+          IoAwaitable connected(fd, IoEvent::Write, [fd]() -> std::optional<int>
+          {
+            sockaddr_storage peer{};
+            socklen_t len = sizeof(peer);
+            if (::getpeername(fd, reinterpret_cast<sockaddr*>(&peer), &len) == 0)
+              return 0;
+            int so_error = 0;
+            socklen_t optlen = sizeof(so_error);
+            ::getsockopt(fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&so_error), &optlen);
+            if (so_error != 0)
+              return so_error;
+            return std::nullopt;
+          });
+          try
+          {
+            if (timeout_ms >= 0)
+            {
+              auto left = deadline - EventLoop::clock::now();
+              auto share = left / static_cast<int>(candidates.size() - i);
+              err = co_await std::move(connected).with_timeout(std::max(share, EventLoop::clock::duration::zero()));
+            }
+            else
+            {
+              err = co_await connected;
+            }
+          }
+          catch (const SocketException& ex)
+          {
+            close_socket(fd);
+            if (ex.error_code() != ETIMEDOUT)
+            {
+              finish(ConnectAttempt::Outcome::Failed, ex.error_code());
+              throw;
+            }
+            finish(ConnectAttempt::Outcome::TimedOut, 0);
+            last_error = ETIMEDOUT; // this attempt's share ran out: try the next candidate
+            continue;
+          }
+        }
+        if (err == 0)
+        {
+          finish(ConnectAttempt::Outcome::Connected, 0);
+          set_socket_option(fd, SocketOption::NonBlocking, 0);
+          fd_ = fd;
+          co_return;
+        }
+        finish(ConnectAttempt::Outcome::Failed, err);
+        last_error = err;
+        close_socket(fd);
       }
+      if (last_error == ETIMEDOUT)
+        throw SocketException("connect() timed out", ETIMEDOUT);
+      throw SocketException("connect() failed", last_error);
+    }
 
-      if (::connect(
-            fd_,
-            reinterpret_cast<sockaddr*>(&addr),
-            len
-          ) < 0)
+    /**
+     * @brief Set the timeout used by open() in milliseconds (-1 = no timeout).
+     */
+    void set_connect_timeout(int ms) noexcept
+    {
+      connect_timeout_ms_ = ms;
+    }
+
+    /**
+     * @brief Set the Happy Eyeballs connection attempt delay in milliseconds (RFC 8305 recommends 250).
+     */
+    void set_connect_attempt_delay(int ms) noexcept
+    {
+      attempt_delay_ms_ = ms;
+    }
+
+    /**
+     * @brief Returns the attempts made by the last open() or async_open() call, in start order.
+     */
+    const std::vector<ConnectAttempt>& last_connect_attempts() const noexcept
+    {
+      return attempts_;
+    }
+
+    /**
+     * @brief Read data from the socket without throwing.
+     * @param data Pointer to the destination buffer.
+     * @param size Number of bytes to read.
+     * @return Bytes read (Ok), Eof when the peer closed the connection, WouldBlock on a
+     *         nonblocking socket without data, Timeout when the read timeout expired,
+     *         or Error with the error code.
+     *
+     * Example:
+     * @code
+     * net_io::IoResult r = client.try_read(buf, sizeof(buf));
+     * if (r.eof())
+     *   client.close();
+     * @endcode
+     */
+    IoResult try_read(char* data, std::size_t size) noexcept
+    {
+      if (fd_ == invalid_socket)
+        return IoResult{ 0, IoStatus::Error, EBADF };
+      while (true)
       {
 #if defined(_WIN32)
-        int err = WSAGetLastError();
-        ::closesocket(fd_);
+        int ret = ::recv(fd_, data, static_cast<int>(size), 0);
+        if (ret < 0)
+          return io_failure(WSAGetLastError(), nonblocking_);
 #else
-        int err = errno;
-        ::close(fd_);
+        ssize_t ret = ::recv(fd_, data, size, 0);
+        if (ret < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return io_failure(errno, nonblocking_);
+        }
 #endif
-        fd_ = invalid_socket;
-        std::cerr << "[TcpClient] connect() failed, fd_=" << fd_ << std::endl;
-        throw SocketException("connect() failed", err);
+        if (ret == 0 && size > 0)
+          return IoResult{ 0, IoStatus::Eof, 0 };
+        return IoResult{ static_cast<std::size_t>(ret), IoStatus::Ok, 0 };
       }
-      std::cerr << "[TcpClient] open() success, fd_=" << fd_ << std::endl;
+    }
+
+    /**
+     * @brief Write as many bytes as the socket accepts in one call, without throwing.
+     * @param data Pointer to the source buffer.
+     * @param size Number of bytes to write.
+     * @return Bytes written (Ok, possibly fewer than size), WouldBlock on a full
+     *         nonblocking socket, Timeout when the write timeout expired, or Error.
+     *
+     * A closed peer is reported as Error with EPIPE rather than by SIGPIPE.
+     */
+    IoResult try_write(const char* data, std::size_t size) noexcept
+    {
+      if (fd_ == invalid_socket)
+        return IoResult{ 0, IoStatus::Error, EBADF };
+#if defined(_WIN32)
+      int ret = ::send(fd_, data, static_cast<int>(size), 0);
+      if (ret < 0)
+        return io_failure(WSAGetLastError(), nonblocking_);
+      return IoResult{ static_cast<std::size_t>(ret), IoStatus::Ok, 0 };
+#else
+#  if defined(MSG_NOSIGNAL)
+      const int flags = MSG_NOSIGNAL; // EPIPE instead of SIGPIPE
+#  else
+      const int flags = 0;
+#  endif
+      while (true)
+      {
+        ssize_t ret = ::send(fd_, data, size, flags);
+        if (ret >= 0)
+          return IoResult{ static_cast<std::size_t>(ret), IoStatus::Ok, 0 };
+        if (errno == EINTR)
+          continue;
+        return io_failure(errno, nonblocking_);
+      }
+#endif
     }
 
     /**
      * @brief Read data from the socket.
      * @param data Pointer to the destination buffer.
      * @param size Number of bytes to read.
-     * @return Number of bytes actually read, or 0 on error.
+     * @return Number of bytes actually read, or 0 on end of stream or error.
      *
      * This method reads up to 'size' bytes from the socket into 'data'.
-     * Returns the number of bytes read, or 0 if an error occurs.
+     * Use try_read() to tell end of stream, timeouts and errors apart.
      */
     std::size_t read(char* data, std::size_t size) noexcept
     {
-#if defined(_WIN32)
-      int ret = ::recv(fd_, data, static_cast<int>(size), 0);
-      if (ret < 0) return 0;
-      return static_cast<std::size_t>(ret);
-#else
-      ssize_t ret = ::read(fd_, data, size);
-      if (ret < 0) return 0;
-      return static_cast<std::size_t>(ret);
-#endif
+      return try_read(data, size).bytes;
     }
 
     /**
@@ -202,7 +524,7 @@ export namespace net_io
      * @param size Number of bytes to write.
      * @throws SocketException if the socket is not open or if the write fails.
      *
-     * Writes data to the socket.
+     * Writes all of data to the socket, continuing after partial writes.
      * Throws a SocketException if the socket is not open or if the write fails.
      * Example:
      * @code
@@ -212,19 +534,174 @@ export namespace net_io
     void write(const char* data, std::size_t size)
     {
       if (fd_ == invalid_socket)
-      {
-        std::cerr << "[TcpClient] write() failed: fd_ is invalid!" << std::endl;
         throw SocketException("write() failed: socket not open", 0);
+      std::size_t sent = 0;
+      while (sent < size)
+      {
+        IoResult r = try_write(data + sent, size - sent);
+        if (!r)
+          throw SocketException(r.timed_out() ? "write() timed out" : "write() failed", r.error);
+        sent += r.bytes;
       }
+    }
+
+    /**
+     * @brief Write several buffers in order, gathered into as few send calls as possible.
+     * @param parts The buffers, e.g. a frame header and its payload.
+     * @throws SocketException if the socket is not open or if the write fails.
+     *
+     * Like write() for the concatenated buffers, without copying them together first.
+     */
+    void write_vectored(std::span<const std::span<const char>> parts)
+    {
+      if (fd_ == invalid_socket)
+        throw SocketException("write_vectored() failed: socket not open", 0);
+#if defined(MSG_NOSIGNAL)
+      const int flags = MSG_NOSIGNAL; // EPIPE instead of SIGPIPE
+#else
+      const int flags = 0;
+#endif
+      IoResult r = send_gathered(fd_, parts, flags, nonblocking_);
+      if (!r)
+        throw SocketException(r.timed_out() ? "write_vectored() timed out" : "write_vectored() failed", r.error);
+    }
+
+    /**
+     * @brief Write as many bytes as the socket accepts without blocking.
+     * @param data Pointer to the source buffer.
+     * @param size Number of bytes to write.
+     * @return Number of bytes written; 0 if a nonblocking socket is not writable (EAGAIN).
+     * @throws SocketException if the socket is not open or on any other send error.
+     *
+     * Unlike write(), a partial write is not an error. Intended for nonblocking sockets,
+     * typically behind a WriteQueue that keeps the unwritten remainder.
+     *
+     * Example:
+     * @code
+     * client.set_nonblocking(true);
+     * std::size_t n = client.write_some(buf, len); // n <= len
+     * @endcode
+     */
+    std::size_t write_some(const char* data, std::size_t size)
+    {
+      if (fd_ == invalid_socket)
+        throw SocketException("write_some() failed: socket not open", 0);
+      IoResult r = try_write(data, size);
+      if (r.ok() || r.would_block())
+        return r.bytes;
+      throw SocketException("send() failed", r.error);
+    }
+
+    /**
+     * @brief Read asynchronously; the awaiting coroutine resumes once data is available.
+     * @param data Pointer to the destination buffer.
+     * @param size Capacity of the buffer.
+     * @return Awaitable yielding the number of bytes read (0 = connection closed).
+     * @throws SocketException (at the co_await) on receive errors.
+     *
+     * Must be awaited on an EventLoop thread. If data is already buffered in the kernel,
+     * the read completes without suspending.
+     *
+     * Example:
+     * @code
+     * char buf[4096];
+     * std::size_t n = co_await client.async_read(buf, sizeof(buf));
+     * @endcode
+     */
+    auto async_read(char* data, std::size_t size)
+    {
+      return IoAwaitable(fd_, IoEvent::Read, [fd = fd_, data, size]() -> std::optional<std::size_t>
+      {
+        while (true)
+        {
 #if defined(_WIN32)
-      int ret = ::send(fd_, data, static_cast<int>(size), 0);
-      if (ret < 0 || ret != static_cast<int>(size))
-        throw SocketException("send() failed", WSAGetLastError());
+          int ret = ::recv(fd, data, static_cast<int>(size), async_io_flags);
+          if (ret >= 0)
+            return static_cast<std::size_t>(ret);
+          int err = WSAGetLastError();
+          if (err == WSAEWOULDBLOCK)
+            return std::nullopt;
+          throw SocketException("recv() failed", err);
 #else
-      ssize_t ret = ::write(fd_, data, size);
-      if (ret < 0 || static_cast<std::size_t>(ret) != size)
-        throw SocketException("write() failed", errno);
+          ssize_t ret = ::recv(fd, data, size, async_io_flags);
+          if (ret >= 0)
+            return static_cast<std::size_t>(ret);
+          if (errno == EINTR)
+            continue;
+          if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return std::nullopt;
+          throw SocketException("recv() failed", errno);
 #endif
+        }
+      });
+    }
+    auto async_read(std::span<char> buf)
+    {
+      return async_read(buf.data(), buf.size());
+    }
+    auto async_read(std::span<std::byte> buf)
+    {
+      return async_read(reinterpret_cast<char*>(buf.data()), buf.size());
+    }
+
+    /**
+     * @brief Write asynchronously; the awaiting coroutine resumes once all data is sent.
+     * @param data Pointer to the source buffer (must stay valid until the write completes).
+     * @param size Number of bytes to write.
+     * @return Awaitable yielding the number of bytes written (always size).
+     * @throws SocketException (at the co_await) on send errors.
+     *
+     * Must be awaited on an EventLoop thread. Suspends only while the socket send buffer
+     * is full.
+     *
+     * Example:
+     * @code
+     * co_await client.async_write("hello", 5);
+     * @endcode
+     */
+    auto async_write(const char* data, std::size_t size)
+    {
+      return IoAwaitable(fd_, IoEvent::Write, [fd = fd_, data, size, sent = std::size_t{0}]() mutable -> std::optional<std::size_t>
+      {
+        while (sent < size)
+        {
+#if defined(_WIN32)
+          int ret = ::send(fd, data + sent, static_cast<int>(size - sent), async_io_flags);
+          if (ret < 0)
+          {
+            int err = WSAGetLastError();
+            if (err == WSAEWOULDBLOCK)
+              return std::nullopt;
+            throw SocketException("send() failed", err);
+          }
+#else
+#  if defined(MSG_NOSIGNAL)
+          const int flags = async_io_flags | MSG_NOSIGNAL;
+#  else
+          const int flags = async_io_flags;
+#  endif
+          ssize_t ret = ::send(fd, data + sent, size - sent, flags);
+          if (ret < 0)
+          {
+            if (errno == EINTR)
+              continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+              return std::nullopt;
+            throw SocketException("send() failed", errno);
+          }
+#endif
+          sent += static_cast<std::size_t>(ret);
+        }
+        return sent;
+      });
+    }
+    auto async_write(std::span<const char> buf)
+    {
+      return async_write(buf.data(), buf.size());
+    }
+    auto async_write(std::span<const std::byte> buf)
+    {
+      return async_write(reinterpret_cast<const char*>(buf.data()), buf.size());
     }
 
     /**
@@ -249,7 +726,164 @@ export namespace net_io
         ::close(fd_);
 #endif
         fd_ = invalid_socket;
+        zc_ = ZeroCopyState{};
+        nonblocking_ = false;
+      }
+    }
+
+    /**
+     * @brief Enable the MSG_ZEROCOPY send path used by write_zerocopy() (Linux only).
+     * @param threshold Payloads smaller than this many bytes are sent with a normal copy,
+     *                  because page pinning and completion handling cost more than the copy.
+     * @return true if the kernel accepted SO_ZEROCOPY, false if write_zerocopy() will copy.
+     *
+     * Must be called after open(). On other platforms this always returns false.
+     *
+     * Example:
+     * @code
+     * client.open();
+     * client.enable_zerocopy(64 * 1024);
+     * @endcode
+     */
+    bool enable_zerocopy(std::size_t threshold = 16 * 1024)
+    {
+      zc_.threshold = threshold;
+#if defined(__linux__) && defined(SO_ZEROCOPY)
+      int one = 1;
+      zc_.enabled = fd_ != invalid_socket &&
+                    ::setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+#else
+      zc_.enabled = false;
+#endif
+      return zc_.enabled;
+    }
+
+    /**
+     * @brief Returns whether zero-copy sends are active on this socket.
+     */
+    bool zerocopy_enabled() const noexcept
+    {
+      return zc_.enabled;
+    }
+
+    /**
+     * @brief Send a buffer without copying it into the kernel.
+     * @param data Pointer to the source buffer.
+     * @param size Number of bytes to send.
+     * @return The sequence id of the last send covering the buffer, or std::nullopt
+     *         if the payload was copied (below threshold or zero-copy unavailable).
+     * @throws SocketException if the socket is not open or if the send fails.
+     *
+     * When an id is returned, the kernel still references the caller's pages:
+     * the buffer must not be modified or released until zerocopy_complete(id)
+     * returns true (see poll_zerocopy() and wait_zerocopy()).
+     *
+     * Example:
+     * @code
+     * auto id = client.write_zerocopy(blob.data(), blob.size());
+     * if (id)
+     *   client.wait_zerocopy(*id);
+     * blob.clear(); // safe now
+     * @endcode
+     */
+    std::optional<std::uint32_t> write_zerocopy(const char* data, std::size_t size)
+    {
+      if (!zc_.enabled || size < zc_.threshold)
+      {
+        write(data, size);
+        ++zc_.stats.threshold_copies;
+        return std::nullopt;
+      }
+#if defined(__linux__) && defined(MSG_ZEROCOPY)
+      std::size_t sent = 0;
+      std::optional<std::uint32_t> last;
+      while (sent < size)
+      {
+        ssize_t ret = ::send(fd_, data + sent, size - sent, MSG_ZEROCOPY | MSG_NOSIGNAL);
+        if (ret < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          if (errno == ENOBUFS)
+          {
+            // optmem limit reached: the remainder goes out as an ordinary copy.
+            write(data + sent, size - sent);
+            ++zc_.stats.threshold_copies;
+            break;
+          }
+          throw SocketException("send(MSG_ZEROCOPY) failed", errno);
+        }
+        // Every successful MSG_ZEROCOPY call consumes one id of the per-socket counter.
+        last = zc_.next_id++;
+        ++zc_.stats.zerocopy_sends;
+        sent += static_cast<std::size_t>(ret);
       }
+      return last;
+#else
+      write(data, size);
+      ++zc_.stats.threshold_copies;
+      return std::nullopt;
+#endif
+    }
+
+    /**
+     * @brief Drain zero-copy completion notifications from the socket error queue.
+     * @param timeout_ms Time to wait for a notification if none is queued (0 = do not wait, -1 = forever).
+     * @return Number of sends completed by this call.
+     */
+    std::size_t poll_zerocopy(int timeout_ms = 0)
+    {
+#if defined(__linux__) && defined(MSG_ZEROCOPY)
+      if (!zc_.enabled || fd_ == invalid_socket)
+        return 0;
+      std::size_t completed = reap_zerocopy();
+      if (completed == 0 && timeout_ms != 0 && zc_.done_id != zc_.next_id)
+      {
+        // An empty event mask still reports POLLERR once the error queue is non-empty.
+        pollfd pfd{ fd_, 0, 0 };
+        if (::poll(&pfd, 1, timeout_ms) > 0)
+          completed = reap_zerocopy();
+      }
+      return completed;
+#else
+      (void)timeout_ms;
+      return 0;
+#endif
+    }
+
+    /**
+     * @brief Returns whether the kernel has released the buffer of a zero-copy send.
+     * @param id Sequence id returned by write_zerocopy().
+     *
+     * Only reflects notifications already drained by poll_zerocopy() or wait_zerocopy().
+     */
+    bool zerocopy_complete(std::uint32_t id) const noexcept
+    {
+      return static_cast<std::int32_t>(id - zc_.done_id) < 0;
+    }
+
+    /**
+     * @brief Block until the zero-copy send with the given id has completed.
+     * @param id Sequence id returned by write_zerocopy().
+     * @param timeout_ms Maximum time to wait per poll (-1 = forever).
+     * @return true if the send completed, false on timeout.
+     */
+    bool wait_zerocopy(std::uint32_t id, int timeout_ms = -1)
+    {
+      while (!zerocopy_complete(id))
+      {
+        if (fd_ == invalid_socket || poll_zerocopy(timeout_ms) == 0)
+          return zerocopy_complete(id);
+      }
+      return true;
+    }
+
+    /**
+     * @brief Returns the zero-copy counters of this client.
+     */
+    ZeroCopyStats zerocopy_stats() const noexcept
+    {
+      return zc_.stats;
     }
 
     /**
@@ -288,6 +922,16 @@ export namespace net_io
     void set_nonblocking(bool enable)
     {
       set_socket_option(fd_, SocketOption::NonBlocking, enable ? 1 : 0);
+      nonblocking_ = enable;
+    }
+
+    /**
+     * @brief Returns whether the socket is in nonblocking mode.
+     * @return The mode last set with set_nonblocking(), or found on the adopted handle.
+     */
+    bool is_nonblocking() const noexcept
+    {
+      return nonblocking_;
     }
 
     /**
@@ -338,8 +982,273 @@ export namespace net_io
     // sockaddr_storage remote_address() const;
 
   private:
+    // Races the candidate addresses and returns the connected socket (RFC 8305 section 5).
+    sock_t connect_happy_eyeballs(const std::vector<sockaddr_storage>& resolved, int timeout_ms)
+    {
+      using clock = std::chrono::steady_clock;
+      const auto begin = clock::now();
+      const auto since_begin = [&](clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t - begin);
+      };
+
+      // Interleave address families, starting with the family the resolver preferred.
+      std::vector<sockaddr_storage> order;
+      {
+        std::vector<sockaddr_storage> first, second;
+        for (const auto& a : resolved)
+          (a.ss_family == resolved.front().ss_family ? first : second).push_back(a);
+        for (std::size_t i = 0; i < std::max(first.size(), second.size()); ++i)
+        {
+          if (i < first.size())  order.push_back(first[i]);
+          if (i < second.size()) order.push_back(second[i]);
+        }
+      }
+
+      struct InFlight
+      {
+        sock_t fd;
+        std::size_t attempt;
+        clock::time_point started;
+      };
+      std::vector<InFlight> inflight;
+      attempts_.clear();
+      std::size_t next = 0;
+      int last_error = 0;
+      auto next_start = begin;
+
+      const auto finish = [&](const InFlight& f, ConnectAttempt::Outcome outcome, int err) {
+        auto& rec = attempts_[f.attempt];
+        rec.elapsed = since_begin(clock::now()) - rec.started;
+        rec.outcome = outcome;
+        rec.error = err;
+        if (outcome != ConnectAttempt::Outcome::Connected)
+          close_socket(f.fd);
+      };
+      const auto abandon_all = [&](ConnectAttempt::Outcome outcome) {
+        for (const auto& f : inflight)
+          finish(f, outcome, 0);
+        inflight.clear();
+      };
+
+      while (true)
+      {
+        auto now = clock::now();
+        if (timeout_ms >= 0 && now - begin >= std::chrono::milliseconds(timeout_ms))
+        {
+          abandon_all(ConnectAttempt::Outcome::TimedOut);
+          throw SocketException("connect() timed out", ETIMEDOUT);
+        }
+
+        // Start the next attempt when the delay elapsed or nothing is in flight.
+        if (next < order.size() && (inflight.empty() || now >= next_start))
+        {
+          const auto& addr = order[next];
+          ConnectAttempt rec;
+          rec.address = addr;
+          rec.started = since_begin(now);
+          attempts_.push_back(rec);
+          std::size_t index = attempts_.size() - 1;
+          ++next;
+          next_start = now + std::chrono::milliseconds(attempt_delay_ms_);
+
+          sock_t fd = ::socket(addr.ss_family, SOCK_STREAM, 0);
+          if (fd == invalid_socket)
+          {
+            last_error = last_socket_error();
+            attempts_[index].error = last_error;
+            continue;
+          }
+          set_socket_option(fd, SocketOption::NonBlocking, 1);
+          int rc = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sockaddr_length(addr));
+          if (rc == 0)
+          {
+            abandon_all(ConnectAttempt::Outcome::Cancelled);
+            finish(InFlight{ fd, index, now }, ConnectAttempt::Outcome::Connected, 0);
+            set_socket_option(fd, SocketOption::NonBlocking, 0);
+            return fd;
+          }
+          int err = last_socket_error();
+#if defined(_WIN32)
+          bool pending = err == WSAEWOULDBLOCK;
+#else
+          bool pending = err == EINPROGRESS;
+#endif
+          if (!pending)
+          {
+            last_error = err;
+            finish(InFlight{ fd, index, now }, ConnectAttempt::Outcome::Failed, err);
+            next_start = now;
+            continue;
+          }
+          inflight.push_back(InFlight{ fd, index, now });
+        }
+
+        if (inflight.empty())
+        {
+          if (next < order.size())
+            continue;
+          throw SocketException("connect() failed", last_error);
+        }
+
+        // Wait until an attempt completes, the next attempt is due, or the deadline passes.
+        auto wake = next < order.size() ? next_start : clock::time_point::max();
+        if (timeout_ms >= 0)
+          wake = std::min(wake, begin + std::chrono::milliseconds(timeout_ms));
+        int wait_ms = -1;
+        if (wake != clock::time_point::max())
+        {
+          auto wait = std::chrono::ceil<std::chrono::milliseconds>(wake - clock::now());
+          wait_ms = wait.count() < 0 ? 0 : static_cast<int>(wait.count());
+        }
+
+        std::vector<pollfd> pfds;
+        pfds.reserve(inflight.size());
+        for (const auto& f : inflight)
+          pfds.push_back(pollfd{ f.fd, POLLOUT, 0 });
+        int ready = poll_sockets(pfds, wait_ms);
+        if (ready < 0)
+        {
+          int err = last_socket_error();
+          if (err == EINTR)
+            continue;
+          abandon_all(ConnectAttempt::Outcome::Failed);
+          throw SocketException("poll failed", err);
+        }
+
+        for (const pollfd& p : pfds)
+        {
+          // Writable, error or hang-up: the attempt finished either way.
+          if (p.revents == 0)
+            continue;
+          auto it = std::find_if(inflight.begin(), inflight.end(), [&](const InFlight& f) { return f.fd == p.fd; });
+          const InFlight f = *it;
+          inflight.erase(it);
+          int so_error = 0;
+          socklen_t len = sizeof(so_error);
+          ::getsockopt(f.fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&so_error), &len);
+          if (so_error == 0)
+          {
+            abandon_all(ConnectAttempt::Outcome::Cancelled);
+            finish(f, ConnectAttempt::Outcome::Connected, 0);
+            set_socket_option(f.fd, SocketOption::NonBlocking, 0);
+            return f.fd;
+          }
+          last_error = so_error;
+          finish(f, ConnectAttempt::Outcome::Failed, so_error);
+          // A failed attempt lets the next candidate start right away.
+          next_start = clock::now();
+        }
+      }
+    }
+
+    // Blocks until the work started by open_async() no longer touches this object.
+    void wait_pending_open() noexcept
+    {
+      if (pending_open_.valid())
+        pending_open_.wait();
+    }
+
+    static int last_socket_error() noexcept
+    {
+#if defined(_WIN32)
+      return WSAGetLastError();
+#else
+      return errno;
+#endif
+    }
+
+    static void close_socket(sock_t fd) noexcept
+    {
+#if defined(_WIN32)
+      ::closesocket(fd);
+#else
+      ::close(fd);
+#endif
+    }
+
+    /// Bookkeeping for MSG_ZEROCOPY sends; ids follow the kernel's per-socket counter.
+    struct ZeroCopyState
+    {
+      bool          enabled   = false;
+      std::size_t   threshold = 0;
+      std::uint32_t next_id   = 0; ///< Id the kernel assigns to the next zero-copy send.
+      std::uint32_t done_id   = 0; ///< All ids below this one have completed.
+      std::vector<std::pair<std::uint32_t, std::uint32_t>> out_of_order; ///< Completed ranges above done_id.
+      ZeroCopyStats stats;
+    };
+
+#if defined(__linux__) && defined(MSG_ZEROCOPY)
+    // Reads all queued completion notifications without blocking.
+    std::size_t reap_zerocopy()
+    {
+      std::size_t completed = 0;
+      while (true)
+      {
+        char control[128];
+        msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (::recvmsg(fd_, &msg, MSG_ERRQUEUE) < 0)
+          break; // EAGAIN: error queue empty
+
+        for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm))
+        {
+          bool is_recverr = (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                            (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+          if (!is_recverr)
+            continue;
+          sock_extended_err serr;
+          std::memcpy(&serr, CMSG_DATA(cm), sizeof(serr));
+          if (serr.ee_errno != 0 || serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+            continue;
+
+          // Notification covers the inclusive id range [ee_info, ee_data].
+          std::uint32_t lo = serr.ee_info;
+          std::uint32_t hi = serr.ee_data;
+          std::uint32_t count = hi - lo + 1;
+          completed += count;
+          zc_.stats.completions += count;
+          if (serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+            zc_.stats.kernel_copies += count;
+          mark_zerocopy_done(lo, hi + 1);
+        }
+      }
+      return completed;
+    }
+
+    // Advances done_id over [lo, hi), keeping ranges that arrive early until the gap closes.
+    void mark_zerocopy_done(std::uint32_t lo, std::uint32_t hi)
+    {
+      if (lo != zc_.done_id)
+      {
+        zc_.out_of_order.emplace_back(lo, hi);
+        return;
+      }
+      zc_.done_id = hi;
+      bool merged = true;
+      while (merged)
+      {
+        merged = false;
+        auto it = std::find_if(zc_.out_of_order.begin(), zc_.out_of_order.end(),
+                               [&](const auto& r) { return r.first == zc_.done_id; });
+        if (it != zc_.out_of_order.end())
+        {
+          zc_.done_id = it->second;
+          zc_.out_of_order.erase(it);
+          merged = true;
+        }
+      }
+    }
+#endif
+
     sock_t fd_{ invalid_socket }; ///< The socket handle.
     std::optional<TcpEndpoint> ep_; ///< The endpoint to connect to (if any).
+    int connect_timeout_ms_ = -1; ///< Timeout for open() (-1 = no timeout).
+    int attempt_delay_ms_ = 250;  ///< Happy Eyeballs connection attempt delay.
+    std::vector<ConnectAttempt> attempts_; ///< Attempts made by the last open().
+    ZeroCopyState zc_; ///< Zero-copy send state (see enable_zerocopy()).
+    bool nonblocking_ = false; ///< Mode set by set_nonblocking(); io_failure() needs it.
+    std::future<void> pending_open_; ///< Background connect of open_async(), if any.
   };
 
   // Compile-time check: ensure TcpClient satisfies the Transportable concept.
@@ -5,6 +5,7 @@ module;
 #include <cstring>
 #include <utility>
 #include <cstdint>
+#include <vector>
 #endif
 
 #ifdef _WIN32
@@ -21,6 +22,7 @@ module;
 
 export module net_io.tcp_endpoint;
 import net_io_base;
+import net_io.resolver;
 export import net_io_base; // Make sock_t and invalid_socket visible to users of this module.
 
 #ifdef _MSC_VER
@@ -29,6 +31,7 @@ import <stdexcept>;
 import <cstring>;
 import <utility>;
 import <cstdint>;
+import <vector>;
 #endif
 
 export namespace net_io
@@ -70,8 +73,9 @@ export namespace net_io
     /**
      * @brief Converts the endpoint to a sockaddr_storage structure.
      *
-     * This function resolves the address and port using getaddrinfo and fills a sockaddr_storage
-     * structure suitable for use with socket APIs (e.g., connect, bind).
+     * This function resolves the address and port through the process-wide Resolver cache
+     * (numeric addresses skip getaddrinfo entirely) and returns the first result as a
+     * sockaddr_storage suitable for use with socket APIs (e.g., connect, bind).
      *
      * @param passive If true, the address is resolved for binding (AI_PASSIVE).
      *                If false, the address is resolved for connecting.
@@ -86,34 +90,28 @@ export namespace net_io
      */
     sockaddr_storage to_sockaddr(bool passive = false) const
     {
-      addrinfo hints{}, *res = nullptr;
-      hints.ai_family   = AF_UNSPEC;      // Allow IPv4 or IPv6.
-      hints.ai_socktype = SOCK_STREAM;    // TCP sockets.
-      hints.ai_flags    = passive ? AI_PASSIVE : 0;
-
-      std::string port_s = std::to_string(port);
-      int err = getaddrinfo(
-        passive ? nullptr : address.c_str(),
-        port_s.c_str(),
-        &hints,
-        &res
-      );
-      if (err != 0 || !res)
-      {
-        std::string msg = "getaddrinfo failed: ";
-#if defined(_WIN32)
-        msg += std::to_string(WSAGetLastError());
-#else
-        msg += gai_strerror(err);
-#endif
-        throw std::runtime_error(msg);
-      }
+      return Resolver::instance().resolve(address, port, SOCK_STREAM, passive).front();
+    }
 
-      sockaddr_storage storage;
-      std::memset(&storage, 0, sizeof(storage));
-      std::memcpy(&storage, res->ai_addr, res->ai_addrlen);
-      freeaddrinfo(res);
-      return storage;
+    /**
+     * @brief Resolves the endpoint to all candidate addresses.
+     *
+     * Unlike to_sockaddr(), which keeps only the first result, this returns every
+     * distinct address in resolver order (RFC 6724 preference), as needed for
+     * Happy Eyeballs connection racing.
+     *
+     * @return Non-empty list of resolved addresses.
+     * @throws std::runtime_error if address resolution fails.
+     *
+     * Example:
+     * @code
+     * net_io::TcpEndpoint ep("localhost", 1234);
+     * for (const auto& addr : ep.resolve()) { ... }
+     * @endcode
+     */
+    std::vector<sockaddr_storage> resolve() const
+    {
+      return Resolver::instance().resolve(address, port, SOCK_STREAM);
     }
   };
 }
@@ -0,0 +1,462 @@
+module;
+
+#include <errno.h>
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  #pragma comment(lib, "ws2_32.lib")
+#else
+  #include <fcntl.h>
+  #include <poll.h>
+  #include <signal.h>
+  #include <sys/socket.h>
+  #include <unistd.h>
+#endif
+
+#ifndef _MSC_VER
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides a bidirectional TCP forwarder (proxy/relay building block).
+// On Linux the payload is moved socket -> pipe -> socket with splice() and never
+// enters user space; other platforms fall back to a userland buffer per direction.
+
+export module net_io.tcp_forwarder;
+
+#ifdef _MSC_VER
+import <atomic>;
+import <concepts>;
+import <cstdint>;
+import <cstring>;
+import <memory>;
+import <optional>;
+import <stdexcept>;
+import <utility>;
+import <vector>;
+#endif
+
+// Module imports (sorted)
+import net_io_base;
+import net_io.tcp_client;
+import net_io.tcp_endpoint;
+export import net_io_base; // Export sock_t and invalid_socket
+
+namespace net_io::detail
+{
+#if defined(_WIN32)
+  using pollfd_t = WSAPOLLFD;
+  inline int poll_fds(pollfd_t* fds, unsigned long n, int timeout_ms)
+  {
+    return ::WSAPoll(fds, n, timeout_ms);
+  }
+  inline constexpr int shutdown_write = SD_SEND;
+#else
+  using pollfd_t = pollfd;
+  inline int poll_fds(pollfd_t* fds, nfds_t n, int timeout_ms)
+  {
+    return ::poll(fds, n, timeout_ms);
+  }
+  inline constexpr int shutdown_write = SHUT_WR;
+#endif
+
+  /**
+   * @brief Blocks SIGPIPE on the calling thread while forwarding.
+   *
+   * splice() into a socket has no MSG_NOSIGNAL equivalent, so a peer that
+   * resets the connection would otherwise kill the process. A pending SIGPIPE
+   * raised while blocked is consumed before the old mask is restored.
+   */
+  class SigpipeGuard
+  {
+  public:
+#if defined(_WIN32)
+    SigpipeGuard() = default;
+#else
+    SigpipeGuard()
+    {
+      sigset_t set;
+      sigemptyset(&set);
+      sigaddset(&set, SIGPIPE);
+      pthread_sigmask(SIG_BLOCK, &set, &old_);
+    }
+
+    ~SigpipeGuard()
+    {
+      sigset_t set;
+      sigemptyset(&set);
+      sigaddset(&set, SIGPIPE);
+      timespec zero{ 0, 0 };
+      while (sigtimedwait(&set, nullptr, &zero) > 0) {}
+      pthread_sigmask(SIG_SETMASK, &old_, nullptr);
+    }
+
+  private:
+    sigset_t old_;
+#endif
+    SigpipeGuard(const SigpipeGuard&) = delete;
+    SigpipeGuard& operator=(const SigpipeGuard&) = delete;
+  };
+
+  /**
+   * @brief One direction of a forwarding session (src -> dst).
+   *
+   * Bytes read from src but not yet written to dst are "pending": they sit in
+   * a kernel pipe (splice path) or in a userland buffer (fallback path).
+   */
+  class ForwardChannel
+  {
+  public:
+    static constexpr std::size_t chunk_size = 64 * 1024;
+
+    enum class Status { Progress, WouldBlock, Closed, Error };
+
+    ForwardChannel(sock_t src, sock_t dst)
+      : src_(src), dst_(dst)
+    {
+#if defined(__linux__)
+      if (::pipe2(pipe_, O_NONBLOCK | O_CLOEXEC) != 0)
+        throw SocketException("pipe2() failed", errno);
+#else
+      buffer_.resize(chunk_size);
+#endif
+    }
+
+    ~ForwardChannel()
+    {
+#if defined(__linux__)
+      ::close(pipe_[0]);
+      ::close(pipe_[1]);
+#endif
+    }
+
+    ForwardChannel(const ForwardChannel&) = delete;
+    ForwardChannel& operator=(const ForwardChannel&) = delete;
+
+    /// Moves bytes from src into the pipe/buffer.
+    Status fill()
+    {
+      if (pending_ >= chunk_size)
+        return Status::WouldBlock;
+#if defined(__linux__)
+      ssize_t n = ::splice(src_, nullptr, pipe_[1], nullptr, chunk_size - pending_,
+                           SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+#elif defined(_WIN32)
+      int n = ::recv(src_, buffer_.data() + pending_, static_cast<int>(chunk_size - pending_), 0);
+#else
+      ssize_t n = ::recv(src_, buffer_.data() + pending_, chunk_size - pending_, 0);
+#endif
+      if (n > 0)
+      {
+        pending_ += static_cast<std::size_t>(n);
+        return Status::Progress;
+      }
+      if (n == 0)
+        return Status::Closed;
+      return would_block() ? Status::WouldBlock : Status::Error;
+    }
+
+    /// Moves pending bytes from the pipe/buffer into dst; returns bytes written in 'moved'.
+    Status drain(std::size_t& moved)
+    {
+      moved = 0;
+      if (pending_ == 0)
+        return Status::WouldBlock;
+#if defined(__linux__)
+      ssize_t n = ::splice(pipe_[0], nullptr, dst_, nullptr, pending_,
+                           SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+#elif defined(_WIN32)
+      int n = ::send(dst_, buffer_.data() + offset_, static_cast<int>(pending_), 0);
+#else
+      ssize_t n = ::send(dst_, buffer_.data() + offset_, pending_, MSG_NOSIGNAL);
+#endif
+      if (n > 0)
+      {
+        moved = static_cast<std::size_t>(n);
+        pending_ -= moved;
+#if !defined(__linux__)
+        offset_ = pending_ == 0 ? 0 : offset_ + moved;
+        if (pending_ > 0 && offset_ + pending_ == chunk_size)
+        {
+          // Compact so fill() can use the tail again.
+          std::memmove(buffer_.data(), buffer_.data() + offset_, pending_);
+          offset_ = 0;
+        }
+#endif
+        return Status::Progress;
+      }
+      return would_block() ? Status::WouldBlock : Status::Error;
+    }
+
+    std::size_t pending() const noexcept { return pending_; }
+    sock_t src() const noexcept { return src_; }
+    sock_t dst() const noexcept { return dst_; }
+
+    bool src_closed = false; ///< EOF seen on src.
+    bool dst_shut   = false; ///< shutdown(SHUT_WR) issued on dst.
+
+  private:
+    static bool would_block() noexcept
+    {
+#if defined(_WIN32)
+      return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+    }
+
+    sock_t src_;
+    sock_t dst_;
+    std::size_t pending_ = 0;
+#if defined(__linux__)
+    int pipe_[2]{ -1, -1 };
+#else
+    std::vector<char> buffer_;
+    std::size_t offset_ = 0;
+#endif
+  };
+}
+
+export namespace net_io
+{
+  /**
+   * @brief Snapshot of TcpForwarder counters.
+   *
+   * Byte counters are cumulative over all sessions run by a forwarder and its copies.
+   */
+  struct ForwarderStats
+  {
+    std::uint64_t bytes_downstream_to_upstream = 0;
+    std::uint64_t bytes_upstream_to_downstream = 0;
+    std::uint64_t sessions                     = 0;
+    std::uint64_t idle_timeouts                = 0;
+    std::uint64_t errors                       = 0;
+  };
+
+  /**
+   * @brief Pumps bytes between two TCP connections in both directions.
+   *
+   * On Linux each direction uses its own pipe and splice(), so the payload never
+   * enters user space. When one side reaches EOF, the pending bytes are flushed and
+   * the write side of the other connection is shut down (half-close); the session
+   * ends once both directions are closed, on a socket error, or when no byte moved
+   * for the idle timeout.
+   *
+   * Copies share their counters, so a TcpForwarder can be handed to run_tcp_server
+   * as the client handler: each accepted connection is relayed to the upstream
+   * endpoint given at construction.
+   *
+   * Example usage:
+   * @code
+   * net_io::TcpForwarder relay(net_io::TcpEndpoint{"10.0.0.5", 8080}, 30000);
+   * run_tcp_server(exec, relay, running, net_io::TcpEndpoint{"0.0.0.0", 9000});
+   * @endcode
+   */
+  class TcpForwarder
+  {
+  public:
+    /**
+     * @brief Construct a forwarder without upstream endpoint (use forward()).
+     * @param idle_timeout_ms Idle timeout in milliseconds (-1 = no timeout).
+     */
+    explicit TcpForwarder(int idle_timeout_ms = -1)
+      : idle_timeout_ms_(idle_timeout_ms)
+      , counters_(std::make_shared<Counters>())
+    {}
+
+    /**
+     * @brief Construct a forwarder that relays handler connections to an upstream endpoint.
+     * @param upstream The endpoint every accepted connection is relayed to.
+     * @param idle_timeout_ms Idle timeout in milliseconds (-1 = no timeout).
+     */
+    explicit TcpForwarder(const TcpEndpoint& upstream, int idle_timeout_ms = -1)
+      : idle_timeout_ms_(idle_timeout_ms)
+      , upstream_(upstream)
+      , counters_(std::make_shared<Counters>())
+    {}
+
+    /**
+     * @brief Set the idle timeout in milliseconds (-1 = no timeout).
+     */
+    void set_idle_timeout(int ms) noexcept
+    {
+      idle_timeout_ms_ = ms;
+    }
+
+    /**
+     * @brief Handler entry point: connect upstream and relay the accepted stream.
+     * @param downstream Any connection exposing native_handle() (TcpClient, SharedStream, ...).
+     * @throws SocketException if no upstream endpoint is set or the upstream connect fails.
+     */
+    template<typename Stream>
+      requires requires(Stream& s) { { s.native_handle() } -> std::convertible_to<sock_t>; }
+    void operator()(Stream& downstream)
+    {
+      if (!upstream_)
+        throw SocketException("TcpForwarder: no upstream endpoint set", 0);
+      TcpClient upstream(*upstream_);
+      upstream.open();
+      forward(static_cast<sock_t>(downstream.native_handle()), upstream.native_handle());
+    }
+
+    /**
+     * @brief Relay between two open clients until the session ends.
+     */
+    void forward(TcpClient& downstream, TcpClient& upstream)
+    {
+      forward(downstream.native_handle(), upstream.native_handle());
+    }
+
+    /**
+     * @brief Relay between two connected sockets until the session ends.
+     * @param downstream Socket of the accepted (client-facing) connection.
+     * @param upstream Socket of the connection to the backend.
+     *
+     * Both sockets are switched to nonblocking mode for the session and back
+     * to blocking mode afterwards. Ownership stays with the caller.
+     */
+    void forward(sock_t downstream, sock_t upstream)
+    {
+      if (downstream == invalid_socket || upstream == invalid_socket)
+        throw SocketException("TcpForwarder: socket not open", 0);
+
+      detail::SigpipeGuard sigpipe_guard;
+      detail::ForwardChannel down_up(downstream, upstream);
+      detail::ForwardChannel up_down(upstream, downstream);
+      set_socket_option(downstream, SocketOption::NonBlocking, 1);
+      set_socket_option(upstream, SocketOption::NonBlocking, 1);
+      counters_->sessions.fetch_add(1, std::memory_order_relaxed);
+
+      bool failed = false;
+      bool hung_up[2]{ false, false };
+      detail::ForwardChannel* from[2]{ &down_up, &up_down };
+      detail::ForwardChannel* into[2]{ &up_down, &down_up };
+      while (!failed && !(down_up.dst_shut && up_down.dst_shut))
+      {
+        detail::pollfd_t fds[2]{};
+        for (int i = 0; i < 2; ++i)
+        {
+          // A hung-up socket is dropped from the set; poll() ignores invalid handles.
+          fds[i].fd = hung_up[i] ? invalid_socket : from[i]->src();
+          fds[i].events = interest(*from[i], *into[i]);
+        }
+
+        int ready = detail::poll_fds(fds, 2, idle_timeout_ms_);
+        if (ready == 0)
+        {
+          counters_->idle_timeouts.fetch_add(1, std::memory_order_relaxed);
+          break;
+        }
+        if (ready < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          failed = true;
+          break;
+        }
+
+        failed = !pump(down_up, counters_->down_up) || !pump(up_down, counters_->up_down);
+
+        for (int i = 0; i < 2 && !failed; ++i)
+        {
+          if (fds[i].revents & (POLLERR | POLLNVAL))
+            failed = true;
+          else if (fds[i].revents & POLLHUP)
+          {
+            // Peer closed both directions: nothing more can be delivered to it.
+            hung_up[i] = true;
+            into[i]->src_closed = true;
+            into[i]->dst_shut = true;
+          }
+        }
+      }
+      if (failed)
+        counters_->errors.fetch_add(1, std::memory_order_relaxed);
+
+      set_socket_option(downstream, SocketOption::NonBlocking, 0);
+      set_socket_option(upstream, SocketOption::NonBlocking, 0);
+    }
+
+    /**
+     * @brief Returns a snapshot of the forwarding counters.
+     */
+    ForwarderStats stats() const noexcept
+    {
+      ForwarderStats s;
+      s.bytes_downstream_to_upstream = counters_->down_up.load(std::memory_order_relaxed);
+      s.bytes_upstream_to_downstream = counters_->up_down.load(std::memory_order_relaxed);
+      s.sessions      = counters_->sessions.load(std::memory_order_relaxed);
+      s.idle_timeouts = counters_->idle_timeouts.load(std::memory_order_relaxed);
+      s.errors        = counters_->errors.load(std::memory_order_relaxed);
+      return s;
+    }
+
+  private:
+    struct Counters
+    {
+      std::atomic<std::uint64_t> down_up{0};
+      std::atomic<std::uint64_t> up_down{0};
+      std::atomic<std::uint64_t> sessions{0};
+      std::atomic<std::uint64_t> idle_timeouts{0};
+      std::atomic<std::uint64_t> errors{0};
+    };
+
+    // Poll interest for a socket that is 'reading.src()' and 'writing.dst()'.
+    static short interest(const detail::ForwardChannel& reading, const detail::ForwardChannel& writing)
+    {
+      short ev = 0;
+      if (!reading.src_closed && reading.pending() < detail::ForwardChannel::chunk_size)
+        ev |= POLLIN;
+      if (writing.pending() > 0)
+        ev |= POLLOUT;
+      return ev;
+    }
+
+    // Moves as much as possible through one direction; false on a socket error.
+    static bool pump(detail::ForwardChannel& ch, std::atomic<std::uint64_t>& counter)
+    {
+      using Status = detail::ForwardChannel::Status;
+      while (true)
+      {
+        Status in = Status::WouldBlock;
+        if (!ch.src_closed)
+        {
+          in = ch.fill();
+          if (in == Status::Closed)
+            ch.src_closed = true;
+          else if (in == Status::Error)
+            return false;
+        }
+
+        std::size_t moved = 0;
+        Status out = ch.drain(moved);
+        if (out == Status::Error)
+          return false;
+        counter.fetch_add(moved, std::memory_order_relaxed);
+
+        if (in != Status::Progress && out != Status::Progress)
+          break;
+      }
+
+      if (ch.src_closed && ch.pending() == 0 && !ch.dst_shut)
+      {
+        ::shutdown(ch.dst(), detail::shutdown_write);
+        ch.dst_shut = true;
+      }
+      return true;
+    }
+
+    int idle_timeout_ms_;
+    std::optional<TcpEndpoint> upstream_;
+    std::shared_ptr<Counters> counters_;
+  };
+}
@@ -22,6 +22,7 @@ module;
 #endif
 
 #ifndef _MSC_VER
+#include <coroutine>
 #include <vector>
 #include <string>
 #include <stdexcept>
@@ -31,6 +32,8 @@ module;
 export module net_io.tcp_server;
 
 #ifdef _MSC_VER
+import <coroutine>;
+import <exception>;
 import <vector>;
 import <string>;
 import <stdexcept>;
@@ -39,12 +42,28 @@ import <stdexcept>;
 // Module imports (sorted)
 import net_io_base;
 import net_io_concepts; // <--- hinzugefügt
+import net_io.event_loop;
 import net_io.tcp_client;
 import net_io.tcp_endpoint;
 export import net_io_base; // Export sock_t and invalid_socket
 
 export namespace net_io
 {
+  /**
+   * @brief Result of TcpServer::try_accept(): the accepted connection, or why there is none.
+   */
+  struct AcceptResult
+  {
+    TcpClient client;
+    IoStatus status = IoStatus::Ok;
+    int error = 0; ///< errno or WSAGetLastError() value for Error.
+
+    bool ok() const noexcept { return status == IoStatus::Ok; }
+    bool would_block() const noexcept { return status == IoStatus::WouldBlock; }
+    bool timed_out() const noexcept { return status == IoStatus::Timeout; }
+    explicit operator bool() const noexcept { return ok(); }
+  };
+
   /**
    * @brief TCP server for accepting incoming connections.
    *
@@ -145,6 +164,7 @@ export namespace net_io
     {
       for (auto fd : listen_fds_)
         set_socket_option(fd, SocketOption::NonBlocking, enable ? 1 : 0);
+      listeners_nonblocking_ = enable;
     }
 
     /// Set accept timeout (only for select)
@@ -161,12 +181,23 @@ export namespace net_io
     }
 
     /**
-     * @brief Accept an incoming connection.
-     * @return TcpClient for the accepted connection
-     * @throws SocketException on error or timeout
+     * @brief Accept an incoming connection without throwing.
+     * @return The connection (Ok); Timeout when the accept timeout expired (WouldBlock
+     *         for a timeout of 0); Error with the error code, e.g. EMFILE.
+     *
+     * Waits like accept(), honouring set_accept_timeout().
+     *
+     * Example:
+     * @code
+     * server.set_accept_timeout(0);
+     * while (auto r = server.try_accept())
+     *   handle(std::move(r.client));
+     * @endcode
      */
-    TcpClient accept()
+    AcceptResult try_accept() noexcept
     {
+      if (listen_fds_.empty())
+        return AcceptResult{ TcpClient(invalid_socket), IoStatus::Error, EBADF };
       while (true)
       {
         fd_set rfds;
@@ -194,10 +225,19 @@ export namespace net_io
           tvptr
         );
         if (ready < 0)
-          throw SocketException("select failed", errno);
+        {
+#if defined(_WIN32)
+          return AcceptResult{ TcpClient(invalid_socket), IoStatus::Error, WSAGetLastError() };
+#else
+          if (errno == EINTR)
+            continue;
+          return AcceptResult{ TcpClient(invalid_socket), IoStatus::Error, errno };
+#endif
+        }
 
         if (ready == 0 && accept_timeout_ms_ >= 0)
-          throw SocketException("accept timeout", 0);
+          return AcceptResult{ TcpClient(invalid_socket),
+                               accept_timeout_ms_ == 0 ? IoStatus::WouldBlock : IoStatus::Timeout, 0 };
 
         for (auto fd : listen_fds_)
         {
@@ -210,14 +250,53 @@ export namespace net_io
               reinterpret_cast<sockaddr*>(&peer),
               &addrlen
             );
-            if (client_fd == invalid_socket)
-              continue;
-            return TcpClient(client_fd);
+            if (client_fd != invalid_socket)
+              return AcceptResult{ TcpClient(client_fd), IoStatus::Ok, 0 };
+            // The connection went away or another thread took it: wait again.
+            IoResult r = io_failure(last_error(), listeners_nonblocking_);
+            if (r.status == IoStatus::Error && !transient_accept_error(r.error))
+              return AcceptResult{ TcpClient(invalid_socket), IoStatus::Error, r.error };
           }
         }
       }
     }
 
+    /**
+     * @brief Accept an incoming connection.
+     * @return TcpClient for the accepted connection
+     * @throws SocketException on error or timeout
+     */
+    TcpClient accept()
+    {
+      AcceptResult r = try_accept();
+      if (r.timed_out() || r.would_block())
+        throw SocketException("accept timeout", 0);
+      if (!r)
+        throw SocketException("accept failed", r.error);
+      return std::move(r.client);
+    }
+
+    /**
+     * @brief Accept a connection asynchronously.
+     * @return Awaitable yielding the TcpClient of the accepted connection.
+     * @throws SocketException (at the co_await) if accepting fails.
+     *
+     * Must be awaited on an EventLoop thread. The listening sockets are switched to
+     * nonblocking mode on first use (accept() keeps working); the accepted sockets are
+     * blocking, and their async_ functions do not depend on that mode.
+     *
+     * Example:
+     * @code
+     * net_io::TcpClient client = co_await server.async_accept();
+     * @endcode
+     */
+    auto async_accept()
+    {
+      if (!listeners_nonblocking_)
+        set_nonblocking(true);
+      return AcceptAwaitable(listen_fds_);
+    }
+
     /// Explicit destructor for resource cleanup
     ~TcpServer() { stop(); }
 
@@ -236,7 +315,136 @@ export namespace net_io
     }
 
   private:
+    // Waits on all listening sockets at once; the first connection wins.
+    class AcceptAwaitable final : private IoWaiter
+    {
+    public:
+      explicit AcceptAwaitable(const std::vector<sock_t>& fds)
+        : fds_(fds)
+      {}
+
+      AcceptAwaitable(const AcceptAwaitable&) = delete;
+      AcceptAwaitable& operator=(const AcceptAwaitable&) = delete;
+
+      bool await_ready()
+      {
+        return try_accept();
+      }
+
+      void await_suspend(std::coroutine_handle<> h)
+      {
+        h_ = h;
+        loop_ = &EventLoop::this_thread();
+        try
+        {
+          for (sock_t fd : fds_)
+            loop_->watch(fd, IoEvent::Read, this);
+        }
+        catch (...)
+        {
+          for (sock_t fd : fds_)
+            loop_->unwatch(fd, IoEvent::Read);
+          throw;
+        }
+      }
+
+      TcpClient await_resume()
+      {
+        if (error_)
+          std::rethrow_exception(error_);
+        return TcpClient(client_fd_);
+      }
+
+    private:
+      bool try_accept()
+      {
+        if (fds_.empty())
+          throw SocketException("async_accept() failed: server not started", 0);
+        for (sock_t fd : fds_)
+        {
+          while (true)
+          {
+#if defined(__linux__)
+            sock_t client_fd = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+#else
+            sock_t client_fd = ::accept(fd, nullptr, nullptr);
+#endif
+            if (client_fd != invalid_socket)
+            {
+#if !defined(__linux__)
+              // Elsewhere the accepted socket inherits the listener's nonblocking mode.
+              set_socket_option(client_fd, SocketOption::NonBlocking, 0);
+#endif
+              client_fd_ = client_fd;
+              return true;
+            }
+#if defined(_WIN32)
+            int err = WSAGetLastError();
+            if (err == WSAEWOULDBLOCK || err == WSAECONNRESET)
+              break;
+#else
+            int err = errno;
+            if (err == EINTR)
+              continue;
+            // A connection reset before accept() is not an error of the server.
+            if (err == EAGAIN || err == EWOULDBLOCK || err == ECONNABORTED)
+              break;
+#endif
+            throw SocketException("accept failed", err);
+          }
+        }
+        return false;
+      }
+
+      void io_ready() noexcept override
+      {
+        try
+        {
+          if (!try_accept())
+          {
+            for (sock_t fd : fds_)
+              loop_->watch(fd, IoEvent::Read, this);
+            return;
+          }
+        }
+        catch (...)
+        {
+          error_ = std::current_exception();
+        }
+        for (sock_t fd : fds_)
+          loop_->unwatch(fd, IoEvent::Read);
+        h_.resume();
+      }
+
+      const std::vector<sock_t>& fds_; ///< The server's listeners; the server outlives the await.
+      sock_t client_fd_ = invalid_socket;
+      std::exception_ptr error_;
+      std::coroutine_handle<> h_;
+      EventLoop* loop_ = nullptr;
+    };
+
+    static int last_error() noexcept
+    {
+#if defined(_WIN32)
+      return WSAGetLastError();
+#else
+      return errno;
+#endif
+    }
+
+    // Errors after which the listener is still usable: the connection was reset before
+    // accept() or the call was interrupted.
+    static bool transient_accept_error(int err) noexcept
+    {
+#if defined(_WIN32)
+      return err == WSAECONNRESET;
+#else
+      return err == EINTR || err == ECONNABORTED || err == EPROTO;
+#endif
+    }
+
     std::vector<sock_t> listen_fds_;
+    bool listeners_nonblocking_ = false;
     int accept_timeout_ms_ = -1; // -1 = no timeout
     TcpEndpoint endpoint_; ///< The endpoint to bind to
   };
@@ -0,0 +1,80 @@
+import net_io;
+import net_io_adapters;
+
+// This can be removed when msvc better supports umbrella imports
+import net_io.memory_pipe;
+import net_io_adapters.executors;
+import net_io_adapters.rpc;
+
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace net_io;
+using namespace net_io_adapters;
+
+// A pool that discards tasks when its one-slot queue is full must not leave the
+// dropped requests unanswered: each gets an error reply, and serve() still returns
+// once the client goes away.
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+int main()
+{
+    ThreadPoolExecutor pool(ThreadPoolOptions{ .min_threads = 1, .max_threads = 1, .queue_capacity = 1,
+                                               .rejection = RejectionPolicy::Discard });
+    RpcServer server(pool);
+    server.on("slow", [](std::span<const char>) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return std::string("done");
+    });
+
+    auto [client_end, server_end] = MemoryPipeTransport::pair();
+    std::thread serving([&server, end = std::move(server_end)]() mutable { server.serve(std::move(end)); });
+
+    const int calls = 200;
+    int replies = 0;
+    int rejected = 0;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        RpcClient rpc(std::move(client_end));
+        std::vector<std::future<std::string>> results;
+        for (int i = 0; i < calls; ++i)
+            results.push_back(rpc.call("slow", {}, std::chrono::seconds(30)));
+        for (auto& result : results)
+        {
+            try
+            {
+                replies += result.get() == "done";
+            }
+            catch (const RpcError& e)
+            {
+                rejected += e.code() == RpcErrc::RemoteError;
+            }
+        }
+    }
+    serving.join(); // hangs if a dropped request kept its in_flight slot
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    check(replies + rejected == calls, "every call gets a reply or an error reply");
+    check(rejected > 0 && pool.metrics().rejected > 0, "the flood overflows the pool");
+    check(elapsed < std::chrono::seconds(10), "dropped calls fail at once, not at their deadline");
+    pool.shutdown();
+
+    if (failures == 0)
+        std::cout << "rpc_test: all checks passed (" << replies << " replies, " << rejected << " rejected)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
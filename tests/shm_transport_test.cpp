@@ -0,0 +1,86 @@
+import net_io;
+
+// This can be removed when msvc better supports umbrella imports
+import net_io.shm_transport;
+
+#include <cerrno>
+#include <iostream>
+#include <string>
+
+#include <unistd.h>
+
+using namespace net_io;
+
+// A second peer is rejected with EBUSY, and the rejection must not close the
+// session of the two sides that already share the region.
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+static std::string read_exactly(ShmTransport& t, std::size_t size)
+{
+    std::string out(size, '\0');
+    std::size_t have = 0;
+    while (have < size)
+    {
+        std::size_t n = t.read(out.data() + have, size - have);
+        if (n == 0)
+            break;
+        have += n;
+    }
+    out.resize(have);
+    return out;
+}
+
+int main()
+{
+    const std::string name = "/net_io-shm-test-" + std::to_string(::getpid());
+
+    ShmTransport creator(name, ShmRole::Create, 4096);
+    creator.open();
+    ShmTransport peer(name, ShmRole::Attach);
+    peer.open();
+
+    {
+        ShmTransport intruder(name, ShmRole::Attach);
+        int err = 0;
+        try
+        {
+            intruder.open();
+        }
+        catch (const SocketException& e)
+        {
+            err = e.error_code();
+        }
+        check(err == EBUSY, "second attach is rejected with EBUSY");
+        check(!intruder.is_open(), "rejected transport is not open");
+    } // the rejected transport is destroyed here as well
+
+    try
+    {
+        creator.write("ping", 4);
+        check(read_exactly(peer, 4) == "ping", "peer receives after the rejected attach");
+        peer.write("pong", 4);
+        check(read_exactly(creator, 4) == "pong", "creator receives after the rejected attach");
+    }
+    catch (const SocketException& e)
+    {
+        check(false, e.what());
+    }
+
+    creator.close();
+    char byte = 0;
+    check(peer.read(&byte, 1) == 0, "peer sees EOF after the creator closes");
+
+    if (failures == 0)
+        std::cout << "shm_transport_test: all checks passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,327 @@
+module;
+
+#ifndef _MSC_VER
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#endif
+
+// This module provides a hierarchical hashed timer wheel for large numbers of
+// coarse timeouts (idle connections, connect and read deadlines): O(1) schedule
+// and cancel, expiry in batches per tick.
+
+export module net_io.timer_wheel;
+
+#ifdef _MSC_VER
+import <algorithm>;
+import <array>;
+import <chrono>;
+import <cstddef>;
+import <cstdint>;
+import <functional>;
+import <optional>;
+import <utility>;
+#endif
+
+export namespace net_io
+{
+  /**
+   * @brief Hierarchical hashed timer wheel.
+   *
+   * Time is divided into ticks (10 ms by default). Four levels of 64 slots cover
+   * 64, 64^2, 64^3 and 64^4 ticks; a timer goes into the level matching its distance and
+   * moves down a level each time the level below wraps around. Timers further away
+   * than the top level are parked in its last slot and re-inserted until they are due.
+   *
+   * Timers are intrusive list nodes owned by the caller, so scheduling, rescheduling
+   * and cancelling are O(1) and allocate nothing (beyond the callback, which is set
+   * once). Expiry is coarse: deadlines are rounded up to the next tick boundary, so a
+   * timer fires up to one tick late, never early.
+   *
+   * Not thread-safe; an EventLoop owns one and advances it on its thread.
+   *
+   * Example usage:
+   * @code
+   * net_io::TimerWheel wheel(std::chrono::milliseconds(10));
+   * net_io::TimerWheel::Timer idle([&] { connection.close(); });
+   * wheel.schedule(idle, std::chrono::seconds(30));
+   * // on activity:
+   * wheel.schedule(idle, std::chrono::seconds(30)); // O(1) re-arm
+   * // in the loop:
+   * wheel.advance(std::chrono::steady_clock::now());
+   * @endcode
+   */
+  class TimerWheel
+  {
+    struct Node
+    {
+      Node* prev = this;
+      Node* next = this;
+
+      bool empty() const noexcept { return next == this; }
+
+      void unlink() noexcept
+      {
+        prev->next = next;
+        next->prev = prev;
+        prev = next = this;
+      }
+
+      void push_back(Node& n) noexcept
+      {
+        n.prev = prev;
+        n.next = this;
+        prev->next = &n;
+        prev = &n;
+      }
+
+      // Moves all nodes of this list to the empty list dst.
+      void splice_to(Node& dst) noexcept
+      {
+        if (empty())
+          return;
+        dst.next = next;
+        dst.prev = prev;
+        next->prev = &dst;
+        prev->next = &dst;
+        prev = next = this;
+      }
+    };
+
+  public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief A timer that can be scheduled on one TimerWheel at a time.
+     *
+     * Not copyable or movable (the wheel links to it). Cancels itself on destruction.
+     */
+    class Timer : private Node
+    {
+    public:
+      Timer() noexcept = default;
+      explicit Timer(std::function<void()> callback)
+        : callback_(std::move(callback))
+      {}
+
+      Timer(const Timer&) = delete;
+      Timer& operator=(const Timer&) = delete;
+
+      ~Timer() { cancel(); }
+
+      /// Set the function called when the timer expires (on the thread calling advance()).
+      void set_callback(std::function<void()> callback)
+      {
+        callback_ = std::move(callback);
+      }
+
+      /// Returns true while the timer is scheduled.
+      bool armed() const noexcept { return wheel_ != nullptr; }
+
+      /**
+       * @brief Unschedule the timer.
+       * @return true if it was scheduled.
+       */
+      bool cancel() noexcept
+      {
+        if (!wheel_)
+          return false;
+        unlink();
+        --wheel_->size_;
+        wheel_ = nullptr;
+        return true;
+      }
+
+    private:
+      friend class TimerWheel;
+
+      TimerWheel* wheel_ = nullptr;
+      std::uint64_t expiry_ = 0; ///< Absolute tick.
+      std::function<void()> callback_;
+    };
+
+    /**
+     * @brief Create a wheel.
+     * @param tick Resolution; deadlines are rounded up to whole ticks.
+     * @param start Time of tick 0.
+     */
+    explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(10),
+                        clock::time_point start = clock::now())
+      : tick_(std::max<clock::duration>(tick, std::chrono::milliseconds(1))), start_(start)
+    {}
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    ~TimerWheel()
+    {
+      for (auto& level : levels_)
+      {
+        for (Node& slot : level)
+        {
+          while (!slot.empty())
+            static_cast<Timer*>(slot.next)->cancel();
+        }
+      }
+    }
+
+    /**
+     * @brief Schedule (or reschedule) a timer to expire after delay.
+     */
+    void schedule(Timer& timer, clock::duration delay)
+    {
+      schedule_at(timer, clock::now() + delay);
+    }
+
+    /**
+     * @brief Schedule (or reschedule) a timer to expire at the given time.
+     *
+     * A timer that is armed on another wheel is moved to this one.
+     */
+    void schedule_at(Timer& timer, clock::time_point when)
+    {
+      timer.cancel();
+      std::uint64_t expiry = 0;
+      if (when > start_)
+        expiry = static_cast<std::uint64_t>((when - start_ + tick_ - clock::duration(1)) / tick_);
+      timer.expiry_ = std::max(expiry, current_);
+      timer.wheel_ = this;
+      ++size_;
+      insert(timer);
+    }
+
+    /**
+     * @brief Expire all timers due at now, calling their callbacks.
+     * @return Number of timers that expired.
+     *
+     * Callbacks may schedule or cancel any timer, including the one running. A timer
+     * scheduled from a callback with a zero delay fires on the next tick.
+     */
+    std::size_t advance(clock::time_point now)
+    {
+      if (now < start_)
+        return 0;
+      const std::uint64_t target = static_cast<std::uint64_t>((now - start_) / tick_);
+      std::size_t expired = 0;
+      while (current_ <= target)
+      {
+        if (size_ == 0)
+        {
+          current_ = target + 1; // nothing to cascade or expire
+          break;
+        }
+        expired += process_tick();
+      }
+      return expired;
+    }
+
+    /**
+     * @brief Returns when advance() has work next, or std::nullopt if no timer is armed.
+     *
+     * Either the tick of the earliest timer in the lowest level, or the next level wrap
+     * at which timers move down; looks at no more than 64 slots.
+     */
+    std::optional<clock::time_point> next_expiry() const noexcept
+    {
+      if (size_ == 0)
+        return std::nullopt;
+      for (std::uint64_t i = 0; i < slots; ++i)
+      {
+        std::uint64_t t = current_ + i;
+        if ((t & mask) == 0 || !levels_[0][t & mask].empty())
+          return tick_time(t);
+      }
+      return tick_time(current_ + slots);
+    }
+
+    /// Returns the number of armed timers.
+    std::size_t size() const noexcept { return size_; }
+
+    /// Returns the tick length.
+    clock::duration tick() const noexcept { return tick_; }
+
+  private:
+    static constexpr unsigned bits = 6;
+    static constexpr std::uint64_t slots = 1u << bits;
+    static constexpr std::uint64_t mask = slots - 1;
+    static constexpr unsigned level_count = 4;
+
+    clock::time_point tick_time(std::uint64_t t) const noexcept
+    {
+      return start_ + tick_ * static_cast<clock::rep>(t);
+    }
+
+    void insert(Timer& timer) noexcept
+    {
+      std::uint64_t expiry = std::max(timer.expiry_, current_);
+      std::uint64_t delta = expiry - current_;
+      unsigned level = 0;
+      while (level + 1 < level_count && delta >= (std::uint64_t{ 1 } << (bits * (level + 1))))
+        ++level;
+      if (delta >= (std::uint64_t{ 1 } << (bits * level_count)))
+        expiry = current_ + (std::uint64_t{ 1 } << (bits * level_count)) - 1; // re-inserted later
+      levels_[level][(expiry >> (bits * level)) & mask].push_back(timer);
+    }
+
+    // Moves the timers of one upper-level slot down to the levels matching their distance.
+    void cascade(unsigned level, std::uint64_t index) noexcept
+    {
+      Node pending;
+      levels_[level][index].splice_to(pending);
+      while (!pending.empty())
+      {
+        Timer* t = static_cast<Timer*>(pending.next);
+        t->unlink();
+        insert(*t);
+      }
+    }
+
+    std::size_t process_tick()
+    {
+      const std::uint64_t t = current_;
+      if ((t & mask) == 0 && t != 0)
+      {
+        for (unsigned level = 1; level < level_count; ++level)
+        {
+          std::uint64_t index = (t >> (bits * level)) & mask;
+          cascade(level, index);
+          if (index != 0)
+            break;
+        }
+      }
+
+      Node due;
+      levels_[0][t & mask].splice_to(due);
+      current_ = t + 1;
+
+      std::size_t expired = 0;
+      while (!due.empty())
+      {
+        Timer* timer = static_cast<Timer*>(due.next);
+        timer->unlink();
+        if (timer->expiry_ > t)
+        {
+          insert(*timer); // parked in the top level; not due yet
+          continue;
+        }
+        timer->wheel_ = nullptr;
+        --size_;
+        ++expired;
+        if (timer->callback_)
+          timer->callback_();
+      }
+      return expired;
+    }
+
+    clock::duration tick_;
+    clock::time_point start_;
+    std::uint64_t current_ = 0; ///< Next tick to process.
+    std::size_t size_ = 0;
+    std::array<std::array<Node, slots>, level_count> levels_;
+  };
+}
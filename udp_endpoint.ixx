@@ -18,6 +18,7 @@ module;
 
 export module net_io.udp_endpoint;
 import net_io_base;
+import net_io.resolver;
 export import net_io_base; // sock_t und invalid_socket sichtbar machen
 
 #ifdef _MSC_VER
@@ -47,33 +48,9 @@ export namespace net_io
         throw std::invalid_argument("UdpEndpoint: remote address empty");
     }
 
+    // Resolves through the process-wide Resolver cache (numeric addresses skip getaddrinfo).
     sockaddr_storage to_sockaddr(bool passive = false) const {
-      addrinfo hints{}, *res = nullptr;
-      hints.ai_family   = AF_UNSPEC;
-      hints.ai_socktype = SOCK_DGRAM;
-      hints.ai_flags    = passive ? AI_PASSIVE : 0;
-
-      std::string port_s = std::to_string(passive ? local_port : port);
-      int err = getaddrinfo(
-        passive ? nullptr : address.c_str(),
-        port_s.c_str(),
-        &hints,
-        &res
-      );
-      if (err != 0 || !res) {
-        std::string msg = "getaddrinfo failed: ";
-#if defined(_WIN32)
-        msg += std::to_string(WSAGetLastError());
-#else
-        msg += gai_strerror(err);
-#endif
-        throw std::runtime_error(msg);
-      }
-      sockaddr_storage storage;
-      std::memset(&storage, 0, sizeof(storage));
-      std::memcpy(&storage, res->ai_addr, res->ai_addrlen);
-      freeaddrinfo(res);
-      return storage;
+      return Resolver::instance().resolve(address, passive ? local_port : port, SOCK_DGRAM, passive).front();
     }
   };
 }
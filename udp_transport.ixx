@@ -4,7 +4,6 @@ module;
 #include <cstdint>
 #include <cstring>
 #include <errno.h>
-#include <iostream>
 #include <fcntl.h>
 #include <stdexcept>
 #include <string>
@@ -30,7 +29,6 @@ export module net_io.udp_transport;
 #ifdef _MSC_VER
 import <cstdint>;
 import <cstring>;
-import <iostream>;
 import <fcntl.h>;
 import <stdexcept>;
 import <string>;
@@ -41,6 +39,7 @@ import <vector>;
 // Module imports (sorted)
 import net_io_base;
 import net_io_concepts; // Import network transport concepts for constraints.
+import net_io.log;
 import net_io.udp_endpoint;
 export import net_io_base; // Export sock_t and invalid_socket
 
@@ -77,7 +76,7 @@ public:
      * @param fd The socket handle (must be a valid UDP socket).
      */
     explicit UdpTransport(sock_t fd) noexcept
-      : fd_(fd)
+      : fd_(fd), nonblocking_(is_nonblocking(fd))
     {}
 
     // Not copyable: copying a UDP transport is not allowed.
@@ -91,7 +90,7 @@ public:
      * The moved-from object is left in a valid but unspecified state.
      */
     UdpTransport(UdpTransport&& other) noexcept
-      : fd_(other.fd_)
+      : fd_(other.fd_), nonblocking_(other.nonblocking_)
     {
       other.fd_ = invalid_socket;
     }
@@ -108,6 +107,7 @@ public:
       {
         close();
         fd_ = other.fd_;
+        nonblocking_ = other.nonblocking_;
         other.fd_ = invalid_socket;
       }
       return *this;
@@ -139,6 +139,7 @@ public:
         socklen_t len   = sizeof(addr_local);
 
         fd_ = ::socket(addr_local.ss_family, SOCK_DGRAM, 0);
+        nonblocking_ = false;
         if (fd_ == invalid_socket)
         {
 #if defined(_WIN32)
@@ -192,6 +193,7 @@ public:
         socklen_t len    = sizeof(addr_remote);
 
         fd_ = ::socket(addr_remote.ss_family, SOCK_DGRAM, 0);
+        nonblocking_ = false;
         if (fd_ == invalid_socket)
         {
 #if defined(_WIN32)
@@ -306,6 +308,7 @@ public:
     void set_nonblocking(bool enable)
     {
       set_socket_option(fd_, SocketOption::NonBlocking, enable ? 1 : 0);
+      nonblocking_ = enable;
     }
 
     /**
@@ -374,20 +377,27 @@ public:
     }
 
     /**
-     * @brief Read a datagram from the socket.
+     * @brief Read a datagram from the socket without throwing.
      * @param data Pointer to the destination buffer.
      * @param size Number of bytes to read.
      * @param from_addr Optional: pointer to sockaddr_storage to receive the sender address.
      * @param from_len Optional: pointer to socklen_t to receive the address length.
-     * @return Number of bytes read.
-     * @throws SocketException on error.
+     * @return Datagram size (Ok; 0 for an empty datagram), WouldBlock on a nonblocking
+     *         socket without data, Timeout when the read timeout expired, or Error.
      *
-     * If from_addr and from_len are provided, they will be filled with the sender's address.
-     * If not provided, the sender address is ignored.
+     * Example:
+     * @code
+     * udp.set_nonblocking(true);
+     * net_io::IoResult r;
+     * while ((r = udp.try_read(buf, sizeof(buf))))
+     *     handle(buf, r.bytes);
+     * @endcode
      */
-    std::size_t read(char* data, std::size_t size,
-                     sockaddr_storage* from_addr = nullptr, socklen_t* from_len = nullptr)
+    IoResult try_read(char* data, std::size_t size,
+                      sockaddr_storage* from_addr = nullptr, socklen_t* from_len = nullptr) noexcept
     {
+        if (fd_ == invalid_socket)
+            return IoResult{ 0, IoStatus::Error, EBADF };
 #if defined(_WIN32)
         sockaddr_storage from{};
         int fromlen = sizeof(from);
@@ -396,34 +406,55 @@ public:
             reinterpret_cast<sockaddr*>(&from), &fromlen
         );
         if (ret == SOCKET_ERROR)
-        {
-            int err = WSAGetLastError();
-            throw SocketException("UDP recvfrom failed", err);
-        }
-        if (from_addr) *from_addr = from;
-        if (from_len)  *from_len  = fromlen;
-        return static_cast<std::size_t>(ret);
+            return io_failure(WSAGetLastError(), nonblocking_);
 #else
-        if (fd_ == invalid_socket) {
-            std::cerr << "[UdpTransport] read() called with invalid fd_! (socket already closed or never opened)" << std::endl;
-            throw SocketException("UDP recvfrom failed: socket not open", EBADF);
-        }
         sockaddr_storage from{};
         socklen_t    fromlen = sizeof(from);
-        ssize_t ret = ::recvfrom(
-            fd_, data, size, 0,
-            reinterpret_cast<sockaddr*>(&from), &fromlen
-        );
-        if (ret < 0)
+        ssize_t ret;
+        do
         {
-            int err = errno;
-            std::cerr << "[UdpTransport] recvfrom failed: errno=" << err << " (" << std::strerror(err) << "), fd_=" << fd_ << std::endl;
-            throw SocketException("UDP recvfrom failed", err);
-        }
+            ret = ::recvfrom(
+                fd_, data, size, 0,
+                reinterpret_cast<sockaddr*>(&from), &fromlen
+            );
+        } while (ret < 0 && errno == EINTR);
+        if (ret < 0)
+            return io_failure(errno, nonblocking_);
+#endif
         if (from_addr) *from_addr = from;
         if (from_len)  *from_len  = fromlen;
-        return static_cast<std::size_t>(ret);
-#endif
+        return IoResult{ static_cast<std::size_t>(ret), IoStatus::Ok, 0 };
+    }
+
+    /**
+     * @brief Read a datagram from the socket.
+     * @param data Pointer to the destination buffer.
+     * @param size Number of bytes to read.
+     * @param from_addr Optional: pointer to sockaddr_storage to receive the sender address.
+     * @param from_len Optional: pointer to socklen_t to receive the address length.
+     * @return Number of bytes read.
+     * @throws SocketException on error, timeout, or when a nonblocking socket has no data.
+     *
+     * If from_addr and from_len are provided, they will be filled with the sender's address.
+     * If not provided, the sender address is ignored. Use try_read() where timeouts or
+     * an empty nonblocking socket are expected.
+     */
+    std::size_t read(char* data, std::size_t size,
+                     sockaddr_storage* from_addr = nullptr, socklen_t* from_len = nullptr)
+    {
+        if (fd_ == invalid_socket)
+            throw SocketException("UDP recvfrom failed: socket not open", EBADF);
+        IoResult r = try_read(data, size, from_addr, from_len);
+        if (r)
+            return r.bytes;
+        if (r.timed_out())
+            throw SocketException("UDP recvfrom timed out", r.error);
+        static LogRateLimit limit;
+        log_message<LogLevel::Warn>(limit, "UdpTransport", [&] {
+            return "recvfrom failed: errno=" + std::to_string(r.error) + " (" + std::strerror(r.error) +
+                   "), fd_=" + std::to_string(fd_);
+        });
+        throw SocketException("UDP recvfrom failed", r.error);
     }
 
     /**
@@ -524,6 +555,7 @@ public:
 
 private:
     sock_t fd_{ invalid_socket }; ///< The socket handle.
+    bool nonblocking_{ false };    ///< Mode set by set_nonblocking(); io_failure() needs it.
     bool isBoundLocal{ false };    ///< Whether the socket is bound to a local address.
 };
 
@@ -0,0 +1,500 @@
+module;
+
+#include <errno.h>
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  #include <afunix.h>
+  #pragma comment(lib, "ws2_32.lib")
+#else
+  #include <sys/socket.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#endif
+
+#ifndef _MSC_VER
+#include <cstring>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#endif
+
+export module net_io.unix_client;
+
+#ifdef _MSC_VER
+import <cstring>;
+import <optional>;
+import <span>;
+import <stdexcept>;
+import <string>;
+import <utility>;
+import <vector>;
+#endif
+
+// Module imports (sorted)
+import net_io_base;
+import net_io_concepts;
+import net_io.unix_endpoint;
+export import net_io_base; // Export sock_t and invalid_socket
+
+export namespace net_io
+{
+  /**
+   * @brief Unix domain socket client for local inter-process connections.
+   *
+   * Works like TcpClient but avoids the loopback TCP stack. With
+   * UnixSocketType::SeqPacket every write() is delivered as one record and every
+   * read() returns at most one record (excess bytes of a record are discarded).
+   *
+   * On POSIX systems, open file descriptors can be passed to the peer with
+   * send_fd()/write_with_fds() (SCM_RIGHTS). A proxy can use this to hand an
+   * accepted TCP connection to a worker process without copying any payload.
+   *
+   * The class is not copyable, but is movable. The socket is closed in the destructor.
+   *
+   * Example usage:
+   * @code
+   * net_io::UnixClient client(net_io::UnixEndpoint{"/tmp/app.sock"});
+   * client.open();
+   * client.write("hello", 5);
+   * char buf[128];
+   * std::size_t n = client.read(buf, sizeof(buf));
+   * @endcode
+   */
+  class UnixClient
+  {
+  public:
+    /**
+     * @brief Construct a UnixClient from an existing (e.g. accepted) socket handle.
+     * @param fd The socket handle (must be a valid AF_UNIX socket).
+     * @param type The socket type of fd.
+     */
+    explicit UnixClient(sock_t fd, UnixSocketType type = UnixSocketType::Stream)
+      : fd_(fd), type_(type), nonblocking_(is_nonblocking(fd))
+    {}
+
+    /**
+     * @brief Construct a UnixClient with an endpoint (does not connect yet).
+     * @param ep The Unix endpoint to connect to.
+     */
+    explicit UnixClient(const UnixEndpoint& ep)
+      : type_(ep.type), ep_(ep)
+    {}
+
+    // Not copyable: copying a socket client is not allowed.
+    UnixClient(const UnixClient&) = delete;
+    UnixClient& operator=(const UnixClient&) = delete;
+
+    /**
+     * @brief Move constructor. Transfers ownership of the socket.
+     */
+    UnixClient(UnixClient&& other) noexcept
+      : fd_(std::exchange(other.fd_, invalid_socket))
+      , type_(other.type_)
+      , ep_(std::move(other.ep_))
+      , nonblocking_(other.nonblocking_)
+    {}
+
+    /**
+     * @brief Move assignment. Closes the current socket and takes over the other one.
+     */
+    UnixClient& operator=(UnixClient&& other) noexcept
+    {
+      if (this != &other)
+      {
+        close();
+        fd_ = std::exchange(other.fd_, invalid_socket);
+        type_ = other.type_;
+        ep_ = std::move(other.ep_);
+        nonblocking_ = other.nonblocking_;
+      }
+      return *this;
+    }
+
+    /// Destructor closes the socket.
+    ~UnixClient()
+    {
+      close();
+    }
+
+    /**
+     * @brief Connect to the stored endpoint.
+     * @throws std::runtime_error if no endpoint was set.
+     * @throws SocketException if socket() or connect() fails.
+     */
+    void open()
+    {
+      if (!ep_)
+        throw std::runtime_error("UnixClient::open(): no endpoint set");
+      close();
+#if defined(_WIN32)
+      detail::ensure_wsa();
+#endif
+      socklen_t len = 0;
+      sockaddr_un addr = ep_->to_sockaddr(len);
+
+      sock_t fd = ::socket(AF_UNIX, ep_->socktype(), 0);
+      if (fd == invalid_socket)
+        throw SocketException("socket() failed", last_socket_error(), ep_->path);
+
+      if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), len) < 0)
+      {
+        int err = last_socket_error();
+        close_socket(fd);
+        throw SocketException("connect() failed", err, ep_->path);
+      }
+      fd_ = fd;
+    }
+
+    /**
+     * @brief Read data from the socket.
+     * @param data Pointer to the destination buffer.
+     * @param size Number of bytes to read.
+     * @return Number of bytes actually read, or 0 on EOF or error.
+     */
+    std::size_t read(char* data, std::size_t size) noexcept
+    {
+#if defined(_WIN32)
+      int ret = ::recv(fd_, data, static_cast<int>(size), 0);
+      if (ret < 0) return 0;
+      return static_cast<std::size_t>(ret);
+#else
+      ssize_t ret;
+      do
+      {
+        ret = ::recv(fd_, data, size, 0);
+      } while (ret < 0 && errno == EINTR);
+      if (ret < 0) return 0;
+      return static_cast<std::size_t>(ret);
+#endif
+    }
+
+    /**
+     * @brief Write data to the socket.
+     * @param data Pointer to the source buffer.
+     * @param size Number of bytes to write.
+     * @throws SocketException if the socket is not open or if the write fails.
+     *
+     * Stream sockets loop until all bytes are written. SeqPacket sockets send
+     * the buffer as exactly one record.
+     */
+    void write(const char* data, std::size_t size)
+    {
+      if (fd_ == invalid_socket)
+        throw SocketException("write() failed: socket not open", 0);
+      std::size_t sent = 0;
+      while (true)
+      {
+#if defined(_WIN32)
+        int ret = ::send(fd_, data + sent, static_cast<int>(size - sent), 0);
+        if (ret < 0)
+          throw SocketException("send() failed", WSAGetLastError());
+#else
+        ssize_t ret = ::send(fd_, data + sent, size - sent, send_flags);
+        if (ret < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          throw SocketException("send() failed", errno);
+        }
+#endif
+        sent += static_cast<std::size_t>(ret);
+        if (sent >= size || type_ != UnixSocketType::Stream)
+          break;
+      }
+    }
+
+    /**
+     * @brief Write several buffers in order, gathered into as few send calls as possible.
+     * @param parts The buffers, e.g. a frame header and its payload.
+     * @throws SocketException if the socket is not open or if the write fails.
+     *
+     * On SeqPacket sockets the buffers (at most 64) form exactly one record.
+     */
+    void write_vectored(std::span<const std::span<const char>> parts)
+    {
+      if (fd_ == invalid_socket)
+        throw SocketException("write_vectored() failed: socket not open", 0);
+      IoResult r = send_gathered(fd_, parts, send_flags, nonblocking_);
+      if (!r)
+        throw SocketException("write_vectored() failed", r.error);
+    }
+
+    /**
+     * @brief Write as many bytes as the socket accepts without blocking.
+     * @return Number of bytes written; 0 if a nonblocking socket is not writable (EAGAIN).
+     * @throws SocketException if the socket is not open or on any other send error.
+     *
+     * On SeqPacket sockets a record is either sent completely or not at all.
+     */
+    std::size_t write_some(const char* data, std::size_t size)
+    {
+      if (fd_ == invalid_socket)
+        throw SocketException("write_some() failed: socket not open", 0);
+#if defined(_WIN32)
+      int ret = ::send(fd_, data, static_cast<int>(size), 0);
+      if (ret < 0)
+      {
+        int err = WSAGetLastError();
+        if (err == WSAEWOULDBLOCK)
+          return 0;
+        throw SocketException("send() failed", err);
+      }
+      return static_cast<std::size_t>(ret);
+#else
+      while (true)
+      {
+        ssize_t ret = ::send(fd_, data, size, send_flags);
+        if (ret >= 0)
+          return static_cast<std::size_t>(ret);
+        if (errno == EINTR)
+          continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+          return 0;
+        throw SocketException("send() failed", errno);
+      }
+#endif
+    }
+
+    /**
+     * @brief Write data together with open file descriptors (SCM_RIGHTS, POSIX only).
+     * @param data Payload sent alongside the descriptors; must not be empty.
+     * @param size Payload size in bytes.
+     * @param fds Descriptors to duplicate into the receiving process.
+     * @throws SocketException if sendmsg() fails or fd passing is unsupported.
+     *
+     * The descriptors stay open in this process; close them after sending to hand
+     * ownership over. On stream sockets the descriptors are attached to the first
+     * byte of the payload, so the receiver must read it with read_with_fds().
+     */
+    void write_with_fds(const char* data, std::size_t size, std::span<const int> fds)
+    {
+#if defined(_WIN32)
+      (void)data; (void)size; (void)fds;
+      throw SocketException("write_with_fds(): fd passing is not supported on Windows", 0);
+#else
+      if (size == 0)
+        throw std::invalid_argument("UnixClient::write_with_fds(): payload must not be empty");
+      if (fds.size() > max_fds_per_message)
+        throw std::invalid_argument("UnixClient::write_with_fds(): too many descriptors");
+
+      iovec iov{ const_cast<char*>(data), size };
+      std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()));
+      msghdr msg{};
+      msg.msg_iov = &iov;
+      msg.msg_iovlen = 1;
+      if (!fds.empty())
+      {
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+      }
+
+      ssize_t ret;
+      do
+      {
+        ret = ::sendmsg(fd_, &msg, send_flags);
+      } while (ret < 0 && errno == EINTR);
+      if (ret < 0)
+        throw SocketException("sendmsg() failed", errno);
+
+      // Descriptors went out with the first chunk; send any remaining payload normally.
+      if (static_cast<std::size_t>(ret) < size)
+        write(data + ret, size - static_cast<std::size_t>(ret));
+#endif
+    }
+
+    /**
+     * @brief Read data and any file descriptors passed with it (SCM_RIGHTS, POSIX only).
+     * @param data Pointer to the destination buffer.
+     * @param size Number of bytes to read.
+     * @param[out] fds Received descriptors are appended; the caller owns them.
+     * @return Number of bytes read, or 0 on EOF.
+     * @throws SocketException if recvmsg() fails, descriptors were truncated,
+     *         or fd passing is unsupported.
+     */
+    std::size_t read_with_fds(char* data, std::size_t size, std::vector<int>& fds)
+    {
+#if defined(_WIN32)
+      (void)data; (void)size; (void)fds;
+      throw SocketException("read_with_fds(): fd passing is not supported on Windows", 0);
+#else
+      iovec iov{ data, size };
+      alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * max_fds_per_message)];
+      msghdr msg{};
+      msg.msg_iov = &iov;
+      msg.msg_iovlen = 1;
+      msg.msg_control = control;
+      msg.msg_controllen = sizeof(control);
+
+      int flags = 0;
+#if defined(MSG_CMSG_CLOEXEC)
+      flags |= MSG_CMSG_CLOEXEC; // Do not leak received descriptors into exec'd children.
+#endif
+      ssize_t ret;
+      do
+      {
+        ret = ::recvmsg(fd_, &msg, flags);
+      } while (ret < 0 && errno == EINTR);
+      if (ret < 0)
+        throw SocketException("recvmsg() failed", errno);
+
+      std::size_t first = fds.size();
+      for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+      {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+          continue;
+        std::size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          int fd;
+          std::memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+          fds.push_back(fd);
+        }
+      }
+      if (msg.msg_flags & MSG_CTRUNC)
+      {
+        for (std::size_t i = first; i < fds.size(); ++i)
+          ::close(fds[i]);
+        fds.resize(first);
+        throw SocketException("recvmsg(): descriptors truncated", EMSGSIZE);
+      }
+      return static_cast<std::size_t>(ret);
+#endif
+    }
+
+    /**
+     * @brief Pass a single file descriptor to the peer (POSIX only).
+     * @param fd Descriptor to send; it remains open in this process.
+     *
+     * Example (hand an accepted TCP connection to a worker):
+     * @code
+     * net_io::TcpClient conn = server.accept();
+     * worker.send_fd(conn.native_handle());
+     * conn.close();
+     * @endcode
+     */
+    void send_fd(int fd)
+    {
+      const int fds[1] = { fd };
+      write_with_fds("F", 1, fds);
+    }
+
+    /**
+     * @brief Receive a single file descriptor sent with send_fd() (POSIX only).
+     * @return The received descriptor; the caller owns it.
+     * @throws SocketException on EOF, error, or if the message carried no descriptor.
+     *
+     * Example:
+     * @code
+     * net_io::TcpClient conn(worker_link.recv_fd());
+     * @endcode
+     */
+    int recv_fd()
+    {
+      char marker;
+      std::vector<int> fds;
+      std::size_t n = read_with_fds(&marker, 1, fds);
+      if (n == 0 || fds.empty())
+      {
+        for (int fd : fds)
+          close_socket(fd);
+        throw SocketException("recv_fd(): no descriptor received", 0);
+      }
+      for (std::size_t i = 1; i < fds.size(); ++i)
+        close_socket(fds[i]);
+      return fds.front();
+    }
+
+    /**
+     * @brief Close the connection (idempotent).
+     */
+    void close() noexcept
+    {
+      if (fd_ != invalid_socket)
+      {
+        close_socket(fd_);
+        fd_ = invalid_socket;
+        nonblocking_ = false;
+      }
+    }
+
+    /**
+     * @brief Returns whether the socket is open.
+     */
+    bool is_open() const noexcept
+    {
+      return fd_ != invalid_socket;
+    }
+
+    /**
+     * @brief Returns the native socket handle.
+     */
+    sock_t native_handle() const noexcept
+    {
+      return fd_;
+    }
+
+    /**
+     * @brief Returns the socket type of this connection.
+     */
+    UnixSocketType type() const noexcept
+    {
+      return type_;
+    }
+
+    /**
+     * @brief Set the socket to nonblocking mode.
+     * @param enable True to enable nonblocking mode, false to disable.
+     */
+    void set_nonblocking(bool enable)
+    {
+      set_socket_option(fd_, SocketOption::NonBlocking, enable ? 1 : 0);
+      nonblocking_ = enable;
+    }
+
+  private:
+    /// Upper bound of descriptors per message accepted by write_with_fds()/read_with_fds().
+    static constexpr std::size_t max_fds_per_message = 64;
+
+#if defined(MSG_NOSIGNAL)
+    static constexpr int send_flags = MSG_NOSIGNAL; // EPIPE instead of SIGPIPE
+#else
+    static constexpr int send_flags = 0;
+#endif
+
+    static int last_socket_error() noexcept
+    {
+#if defined(_WIN32)
+      return WSAGetLastError();
+#else
+      return errno;
+#endif
+    }
+
+    static void close_socket(sock_t fd) noexcept
+    {
+#if defined(_WIN32)
+      ::closesocket(fd);
+#else
+      ::close(fd);
+#endif
+    }
+
+    sock_t fd_ = invalid_socket;
+    UnixSocketType type_ = UnixSocketType::Stream;
+    std::optional<UnixEndpoint> ep_;
+    bool nonblocking_ = false; ///< Mode set by set_nonblocking(); io_failure() needs it.
+  };
+
+  static_assert(net_io_concepts::Transportable<UnixClient>, "UnixClient does not implement Transportable concept!");
+}
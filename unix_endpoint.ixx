@@ -0,0 +1,134 @@
+module;
+#ifndef _MSC_VER
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#endif
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  #include <afunix.h>     // AF_UNIX stream sockets (Windows 10 1803+)
+  #pragma comment(lib, "ws2_32.lib") // Only needed for static linking on Windows.
+#else
+  #include <sys/socket.h>
+  #include <sys/un.h>
+#endif
+
+// This module provides a Unix domain socket endpoint abstraction.
+// A Unix endpoint names a filesystem path (or, on Linux, an abstract-namespace name)
+// and selects the socket type used for connections between co-located processes.
+
+export module net_io.unix_endpoint;
+import net_io_base;
+export import net_io_base; // Make sock_t and invalid_socket visible to users of this module.
+
+#ifdef _MSC_VER
+import <cstddef>;
+import <cstring>;
+import <stdexcept>;
+import <string>;
+import <utility>;
+#endif
+
+export namespace net_io
+{
+  /**
+   * @brief Socket type of a Unix domain connection.
+   *
+   * - Stream: Byte stream like TCP (SOCK_STREAM).
+   * - SeqPacket: Reliable, ordered records with preserved message boundaries
+   *   (SOCK_SEQPACKET, not available on Windows).
+   */
+  enum class UnixSocketType
+  {
+    Stream,
+    SeqPacket
+  };
+
+  /**
+   * @brief Represents a Unix domain socket endpoint (path and socket type).
+   *
+   * A path starting with '@' denotes a name in the Linux abstract namespace: no file
+   * is created, and the name disappears when the last socket bound to it is closed.
+   *
+   * Example usage:
+   * @code
+   * net_io::UnixEndpoint file_ep("/run/myapp/control.sock");
+   * net_io::UnixEndpoint abstract_ep("@myapp-control", net_io::UnixSocketType::SeqPacket);
+   * @endcode
+   */
+  struct UnixEndpoint
+  {
+    std::string    path;                          ///< Filesystem path, or '@' + abstract name.
+    UnixSocketType type = UnixSocketType::Stream; ///< Socket type used to connect or listen.
+
+    /**
+     * @brief Constructs a Unix endpoint from a path and socket type.
+     * @param p Filesystem path or '@'-prefixed abstract name.
+     * @param t Socket type.
+     * @throws std::invalid_argument if the path is empty or too long for sockaddr_un.
+     */
+    UnixEndpoint(std::string p, UnixSocketType t = UnixSocketType::Stream)
+      : path(std::move(p))
+      , type(t)
+    {
+      if (path.empty() || path == "@")
+      {
+        throw std::invalid_argument("UnixEndpoint: empty path");
+      }
+      if (path.size() >= sizeof(sockaddr_un{}.sun_path))
+      {
+        throw std::invalid_argument("UnixEndpoint: path too long: " + path);
+      }
+    }
+
+    /**
+     * @brief Returns true if the endpoint names the abstract namespace.
+     */
+    bool is_abstract() const noexcept
+    {
+      return path.front() == '@';
+    }
+
+    /**
+     * @brief Returns the SOCK_* constant for the endpoint's socket type.
+     */
+    int socktype() const noexcept
+    {
+      return type == UnixSocketType::SeqPacket ? SOCK_SEQPACKET : SOCK_STREAM;
+    }
+
+    /**
+     * @brief Converts the endpoint to a sockaddr_un structure.
+     * @param[out] len The address length to pass to bind() or connect().
+     *             Abstract names are not NUL-terminated, so the length is significant.
+     * @return sockaddr_un structure representing the endpoint.
+     * @throws std::invalid_argument if an abstract name is used outside Linux.
+     */
+    sockaddr_un to_sockaddr(socklen_t& len) const
+    {
+      sockaddr_un addr{};
+      addr.sun_family = AF_UNIX;
+      if (is_abstract())
+      {
+#if defined(__linux__)
+        // Leading NUL selects the abstract namespace; the name is the rest of the path.
+        std::memcpy(addr.sun_path + 1, path.data() + 1, path.size() - 1);
+        len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+#else
+        throw std::invalid_argument("UnixEndpoint: abstract namespace is Linux-only: " + path);
+#endif
+      }
+      else
+      {
+        std::memcpy(addr.sun_path, path.data(), path.size());
+        len = static_cast<socklen_t>(sizeof(sockaddr_un));
+      }
+      return addr;
+    }
+  };
+}
@@ -0,0 +1,236 @@
+module;
+
+// System headers (sorted)
+#include <errno.h>
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  #include <afunix.h>
+  #pragma comment(lib, "ws2_32.lib")
+#else
+  #include <poll.h>
+  #include <sys/socket.h>
+  #include <sys/stat.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#endif
+
+#ifndef _MSC_VER
+#include <cstdio>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#endif
+
+export module net_io.unix_server;
+
+#ifdef _MSC_VER
+import <cstdio>;
+import <span>;
+import <stdexcept>;
+import <string>;
+import <utility>;
+#endif
+
+// Module imports (sorted)
+import net_io_base;
+import net_io_concepts;
+import net_io.unix_client;
+import net_io.unix_endpoint;
+export import net_io_base; // Export sock_t and invalid_socket
+
+export namespace net_io
+{
+  /**
+   * @brief Unix domain socket server for accepting local connections.
+   *
+   * Listens on a filesystem path or, on Linux, an abstract-namespace name. A stale
+   * socket file left behind by a crashed process is removed on start(), and the
+   * file is removed again on stop(). A socket file a running server still listens on
+   * is left alone; start() then fails with EADDRINUSE. Not copyable.
+   *
+   * Example usage:
+   * @code
+   * net_io::UnixServer server(net_io::UnixEndpoint{"@myapp"});
+   * server.start();
+   * net_io::UnixClient conn = server.accept();
+   * @endcode
+   */
+  class UnixServer
+  {
+  public:
+    /// Construct and store the endpoint, but do not start
+    explicit UnixServer(const UnixEndpoint& ep)
+      : endpoint_(ep)
+    {}
+
+    UnixServer(const UnixServer&) = delete;
+    UnixServer& operator=(const UnixServer&) = delete;
+
+    /**
+     * @brief Bind and listen on the stored endpoint.
+     * @throws SocketException if socket(), bind() or listen() fails.
+     */
+    void start()
+    {
+#if defined(_WIN32)
+      detail::ensure_wsa();
+#endif
+      stop();
+      socklen_t len = 0;
+      sockaddr_un addr = endpoint_.to_sockaddr(len);
+
+      if (!endpoint_.is_abstract())
+        remove_stale_socket(addr, len);
+
+      sock_t fd = ::socket(AF_UNIX, endpoint_.socktype(), 0);
+      if (fd == invalid_socket)
+        throw SocketException("socket() failed", last_socket_error(), endpoint_.path);
+
+      if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), len) < 0 ||
+          ::listen(fd, SOMAXCONN) < 0)
+      {
+        int err = last_socket_error();
+        close_socket(fd);
+        throw SocketException("bind()/listen() failed", err, endpoint_.path);
+      }
+      listen_fd_ = fd;
+      owns_path_ = !endpoint_.is_abstract();
+    }
+
+    /// Set accept timeout (only for poll)
+    void set_accept_timeout(int ms)
+    {
+      accept_timeout_ms_ = ms;
+    }
+
+    /// Set the listener to nonblocking mode
+    void set_nonblocking(bool enable)
+    {
+      set_socket_option(listen_fd_, SocketOption::NonBlocking, enable ? 1 : 0);
+      listener_nonblocking_ = enable;
+    }
+
+    /**
+     * @brief Accept an incoming connection.
+     * @return UnixClient for the accepted connection (same socket type as the endpoint)
+     * @throws SocketException on error or timeout
+     */
+    UnixClient accept()
+    {
+      while (true)
+      {
+        pollfd pfd{ listen_fd_, POLLIN, 0 };
+        int ready = poll_sockets(std::span<pollfd>(&pfd, 1), accept_timeout_ms_);
+        if (ready < 0)
+        {
+          if (last_socket_error() == EINTR)
+            continue;
+          throw SocketException("poll failed", last_socket_error());
+        }
+
+        if (ready == 0 && accept_timeout_ms_ >= 0)
+          throw SocketException("accept timeout", 0);
+
+        sock_t client_fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (client_fd != invalid_socket)
+          return UnixClient(client_fd, endpoint_.type);
+        // The connection went away or another thread took it: wait again. Anything
+        // else (EMFILE, ENFILE, ...) would fail again at once, so it is reported.
+        IoResult r = io_failure(last_socket_error(), listener_nonblocking_);
+        if (r.status == IoStatus::Error && !transient_accept_error(r.error))
+          throw SocketException("accept failed", r.error, endpoint_.path);
+      }
+    }
+
+    /// Explicit destructor for resource cleanup
+    ~UnixServer() { stop(); }
+
+    /// Stop the server, close the listener and remove the socket file
+    void stop() noexcept
+    {
+      if (listen_fd_ != invalid_socket)
+      {
+        close_socket(listen_fd_);
+        listen_fd_ = invalid_socket;
+        listener_nonblocking_ = false;
+      }
+      if (owns_path_)
+      {
+        std::remove(endpoint_.path.c_str());
+        owns_path_ = false;
+      }
+    }
+
+    /// Returns the native listening socket handle
+    sock_t native_handle() const noexcept
+    {
+      return listen_fd_;
+    }
+
+  private:
+    // Only unlink a socket that refuses connections, never a running server's socket
+    // or a regular file that happens to sit at the path.
+    void remove_stale_socket(const sockaddr_un& addr, socklen_t len) const noexcept
+    {
+#if !defined(_WIN32)
+      struct stat st{};
+      if (::lstat(endpoint_.path.c_str(), &st) != 0 || !S_ISSOCK(st.st_mode))
+        return;
+      sock_t probe = ::socket(AF_UNIX, endpoint_.socktype(), 0);
+      if (probe == invalid_socket)
+        return;
+      // Nonblocking, so a live server with a full backlog answers EAGAIN instead of
+      // blocking start().
+      set_socket_option(probe, SocketOption::NonBlocking, 1);
+      bool stale = ::connect(probe, reinterpret_cast<const sockaddr*>(&addr), len) != 0 && errno == ECONNREFUSED;
+      close_socket(probe);
+      if (stale)
+        ::unlink(endpoint_.path.c_str());
+#else
+      (void)addr;
+      (void)len;
+#endif
+    }
+
+    // Errors after which the listener is still usable (see TcpServer).
+    static bool transient_accept_error(int err) noexcept
+    {
+#if defined(_WIN32)
+      return err == WSAECONNRESET;
+#else
+      return err == EINTR || err == ECONNABORTED || err == EPROTO;
+#endif
+    }
+
+    static int last_socket_error() noexcept
+    {
+#if defined(_WIN32)
+      return WSAGetLastError();
+#else
+      return errno;
+#endif
+    }
+
+    static void close_socket(sock_t fd) noexcept
+    {
+#if defined(_WIN32)
+      ::closesocket(fd);
+#else
+      ::close(fd);
+#endif
+    }
+
+    sock_t listen_fd_ = invalid_socket;
+    int accept_timeout_ms_ = -1; // -1 = no timeout
+    bool listener_nonblocking_ = false;
+    bool owns_path_ = false;     ///< True if stop() must remove the socket file
+    UnixEndpoint endpoint_;      ///< The endpoint to bind to
+  };
+
+  //static assert for acceptable concept
+  static_assert(net_io_concepts::Acceptable<UnixServer>, "UnixServer does not implement Acceptable concept!");
+}
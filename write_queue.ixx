@@ -0,0 +1,339 @@
+module;
+
+#include <errno.h>
+#include <mutex>
+
+#ifdef _WIN32
+  #define NOMINMAX
+  #include <winsock2.h>
+#else
+  #include <poll.h>
+#endif
+
+#ifndef _MSC_VER
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#endif
+
+// This module provides a per-connection outbound queue for nonblocking streams.
+// Producers enqueue without blocking; the queue drains when the socket becomes
+// writable and reports backpressure through high/low watermark callbacks.
+
+export module net_io.write_queue;
+
+#ifdef _MSC_VER
+import <algorithm>;
+import <chrono>;
+import <concepts>;
+import <cstddef>;
+import <cstdint>;
+import <deque>;
+import <functional>;
+import <memory>;
+import <span>;
+import <stdexcept>;
+import <utility>;
+import <vector>;
+#endif
+
+// Module imports (sorted)
+import net_io_base;
+import net_io_concepts;
+export import net_io_base; // Export sock_t and invalid_socket
+
+export namespace net_io
+{
+  /**
+   * @brief Counters of a WriteQueue.
+   *
+   * - queued_bytes: Bytes currently waiting to be written.
+   * - peak_queued_bytes: Highest value queued_bytes has reached.
+   * - enqueued_bytes: Bytes that could not be written immediately and were queued.
+   * - written_bytes: Bytes handed to the stream (directly or from the queue).
+   * - high_watermark_events: How often the queue crossed the high watermark.
+   */
+  struct WriteQueueStats
+  {
+    std::size_t   queued_bytes = 0;
+    std::size_t   peak_queued_bytes = 0;
+    std::uint64_t enqueued_bytes = 0;
+    std::uint64_t written_bytes = 0;
+    std::uint64_t high_watermark_events = 0;
+  };
+
+  /**
+   * @brief Outbound byte queue with watermark backpressure for a nonblocking stream.
+   *
+   * write() never blocks: it writes what the stream accepts right away (only if nothing
+   * is queued, to keep ordering) and queues the rest. The owner calls on_writable() when
+   * the socket reports writability (or drain() to wait for it), which writes queued data
+   * with write_some().
+   *
+   * When the queued bytes reach the high watermark, the high callback fires once and
+   * paused() becomes true; producers should stop writing. When the queue drains down to
+   * the low watermark, the low callback fires and paused() becomes false again.
+   * Callbacks run on the thread that caused the transition, without the queue locked.
+   *
+   * All member functions are thread-safe, so producers may write from other threads
+   * than the one that drains.
+   *
+   * Example usage:
+   * @code
+   * auto client = std::make_shared<net_io::TcpClient>(ep);
+   * client->open();
+   * client->set_nonblocking(true);
+   * net_io::WriteQueue<net_io::TcpClient> queue(client, 1 << 20, 256 << 10);
+   * queue.on_high_watermark([&](std::size_t) { producer.pause(); });
+   * queue.on_low_watermark([&](std::size_t) { producer.resume(); });
+   * queue.write(data, size);      // never blocks
+   * queue.drain(1000);            // or on_writable() from an event loop
+   * @endcode
+   */
+  template<typename Stream>
+    requires net_io_concepts::PartialWritable<Stream>
+  class WriteQueue
+  {
+  public:
+    using Callback = std::function<void(std::size_t queued_bytes)>;
+
+    /**
+     * @brief Construct a queue in front of a stream.
+     * @param stream The stream to write to (usually set to nonblocking mode).
+     * @param high_watermark Queued bytes at which backpressure starts.
+     * @param low_watermark Queued bytes at which backpressure ends (must be <= high).
+     */
+    explicit WriteQueue(std::shared_ptr<Stream> stream,
+                        std::size_t high_watermark = 1024 * 1024,
+                        std::size_t low_watermark = 256 * 1024)
+      : stream_(std::move(stream))
+    {
+      set_watermarks(high_watermark, low_watermark);
+    }
+
+    WriteQueue(const WriteQueue&) = delete;
+    WriteQueue& operator=(const WriteQueue&) = delete;
+
+    /**
+     * @brief Change the watermarks.
+     * @throws std::invalid_argument if low > high.
+     */
+    void set_watermarks(std::size_t high_watermark, std::size_t low_watermark)
+    {
+      if (low_watermark > high_watermark)
+        throw std::invalid_argument("WriteQueue: low watermark above high watermark");
+      std::lock_guard<std::mutex> lock(mtx_);
+      high_ = high_watermark;
+      low_ = low_watermark;
+    }
+
+    /// Set the callback invoked when the queue reaches the high watermark.
+    void on_high_watermark(Callback cb)
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      on_high_ = std::move(cb);
+    }
+
+    /// Set the callback invoked when the queue drains down to the low watermark.
+    void on_low_watermark(Callback cb)
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      on_low_ = std::move(cb);
+    }
+
+    /**
+     * @brief Write or queue data without blocking.
+     * @throws SocketException if the stream reports an error other than EAGAIN.
+     *
+     * The data is always accepted, also above the high watermark; honoring paused()
+     * is up to the producer.
+     */
+    void write(const char* data, std::size_t size)
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      std::size_t written = 0;
+      if (queued_ == 0 && size > 0)
+      {
+        written = stream_->write_some(data, size);
+        stats_.written_bytes += written;
+      }
+      if (written < size)
+        append(data + written, size - written);
+      notify(lock);
+    }
+    void write(std::span<const char> data)
+    {
+      write(data.data(), data.size());
+    }
+    void write(std::span<const std::byte> data)
+    {
+      write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    /**
+     * @brief Write queued data until the queue is empty or the stream would block.
+     * @return true if the queue is empty afterwards.
+     * @throws SocketException if the stream reports an error other than EAGAIN.
+     */
+    bool on_writable()
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      while (!chunks_.empty())
+      {
+        std::vector<char>& front = chunks_.front();
+        std::size_t n = stream_->write_some(front.data() + offset_, front.size() - offset_);
+        if (n == 0)
+          break;
+        stats_.written_bytes += n;
+        queued_ -= n;
+        offset_ += n;
+        if (offset_ == front.size())
+        {
+          chunks_.pop_front();
+          offset_ = 0;
+        }
+      }
+      bool empty = queued_ == 0;
+      notify(lock);
+      return empty;
+    }
+
+    /**
+     * @brief Block until the queue is empty, waiting for writability with poll().
+     * @param timeout_ms Maximum time to wait in milliseconds (-1 = no limit).
+     * @return true if the queue was drained, false on timeout.
+     * @throws SocketException on stream or poll() errors.
+     */
+    bool drain(int timeout_ms = -1)
+      requires requires(Stream& s) { { s.native_handle() } -> std::convertible_to<sock_t>; }
+    {
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+      while (!on_writable())
+      {
+        int wait_ms = -1;
+        if (timeout_ms >= 0)
+        {
+          auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+          if (left.count() <= 0)
+            return false;
+          wait_ms = static_cast<int>(left.count());
+        }
+        pollfd pfd{ stream_->native_handle(), POLLOUT, 0 };
+        if (poll_sockets(std::span<pollfd>(&pfd, 1), wait_ms) < 0)
+        {
+#if defined(_WIN32)
+          throw SocketException("poll failed", WSAGetLastError());
+#else
+          if (errno != EINTR)
+            throw SocketException("poll failed", errno);
+#endif
+        }
+      }
+      return true;
+    }
+
+    /// Returns true while there is queued data (register for writability).
+    bool wants_write() const
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      return queued_ > 0;
+    }
+
+    /// Returns true between crossing the high watermark and draining to the low one.
+    bool paused() const
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      return paused_;
+    }
+
+    /// Returns the number of bytes waiting to be written.
+    std::size_t queued_bytes() const
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      return queued_;
+    }
+
+    /// Returns a snapshot of the queue counters.
+    WriteQueueStats stats() const
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      WriteQueueStats s = stats_;
+      s.queued_bytes = queued_;
+      return s;
+    }
+
+    /// Drop all queued data (e.g. after the connection failed). Does not fire callbacks.
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      chunks_.clear();
+      offset_ = 0;
+      queued_ = 0;
+      paused_ = false;
+    }
+
+  private:
+    /// Small writes are coalesced into chunks of this size to bound per-chunk overhead.
+    static constexpr std::size_t chunk_size = 16 * 1024;
+
+    void append(const char* data, std::size_t size)
+    {
+      if (!chunks_.empty() && chunks_.back().size() + size <= chunk_size)
+      {
+        chunks_.back().insert(chunks_.back().end(), data, data + size);
+      }
+      else
+      {
+        std::vector<char> chunk;
+        chunk.reserve(std::max(size, chunk_size));
+        chunk.assign(data, data + size);
+        chunks_.push_back(std::move(chunk));
+      }
+      queued_ += size;
+      stats_.enqueued_bytes += size;
+      stats_.peak_queued_bytes = std::max(stats_.peak_queued_bytes, queued_);
+    }
+
+    // Evaluates watermark transitions and runs the callback with the lock released.
+    void notify(std::unique_lock<std::mutex>& lock)
+    {
+      Callback cb;
+      if (!paused_ && queued_ >= high_ && high_ > 0)
+      {
+        paused_ = true;
+        ++stats_.high_watermark_events;
+        cb = on_high_;
+      }
+      else if (paused_ && queued_ <= low_)
+      {
+        paused_ = false;
+        cb = on_low_;
+      }
+      std::size_t queued = queued_;
+      lock.unlock();
+      if (cb)
+        cb(queued);
+    }
+
+    std::shared_ptr<Stream> stream_;
+    mutable std::mutex mtx_;
+    std::deque<std::vector<char>> chunks_;
+    std::size_t offset_ = 0;  ///< Bytes of chunks_.front() already written.
+    std::size_t queued_ = 0;
+    std::size_t high_ = 0;
+    std::size_t low_ = 0;
+    bool paused_ = false;
+    Callback on_high_;
+    Callback on_low_;
+    WriteQueueStats stats_;
+  };
+}